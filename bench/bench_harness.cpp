@@ -0,0 +1,402 @@
+/**
+ * @file bench_harness.cpp
+ * @brief Implementation of the minimal benchmark harness
+ */
+
+#include "bench_harness.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+namespace benchmark {
+
+namespace {
+
+// Command-line settings, named after the Google Benchmark flags they mirror
+struct Settings {
+    std::string filter = ".";
+    double minTime = 0.5;
+    std::string format = "console";
+    std::string outFile;
+    std::string outFormat = "json";
+    bool listTests = false;
+    std::string executable;
+};
+
+Settings& settings() {
+    static Settings instance;
+    return instance;
+}
+
+std::vector<std::unique_ptr<internal::Benchmark>>& registry() {
+    static std::vector<std::unique_ptr<internal::Benchmark>> benchmarks;
+    return benchmarks;
+}
+
+double realNow() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+double cpuNow() {
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+// One reported run: a benchmark at one argument set
+struct Result {
+    std::string name;
+    std::string runName;
+    int64_t iterations{0};
+    double realTime{0.0};   // Per iteration, in unit
+    double cpuTime{0.0};
+    TimeUnit unit{kNanosecond};
+    double bytesPerSecond{0.0};
+    double itemsPerSecond{0.0};
+    std::string label;
+};
+
+const char* unitName(TimeUnit unit) {
+    switch (unit) {
+        case kSecond: return "s";
+        case kMillisecond: return "ms";
+        case kMicrosecond: return "us";
+        default: return "ns";
+    }
+}
+
+double unitScale(TimeUnit unit) {
+    switch (unit) {
+        case kSecond: return 1.0;
+        case kMillisecond: return 1e3;
+        case kMicrosecond: return 1e6;
+        default: return 1e9;
+    }
+}
+
+std::string runName(const internal::Benchmark& bench, const std::vector<int64_t>& args) {
+    std::string name = bench.name;
+    for (size_t i = 0; i < args.size(); ++i) {
+        name += "/";
+        if (i < bench.argNames.size() && !bench.argNames[i].empty()) {
+            name += bench.argNames[i] + ":";
+        }
+        name += std::to_string(args[i]);
+    }
+    return name;
+}
+
+// Grow the iteration count until a run lasts at least the minimum time
+Result runOne(const internal::Benchmark& bench, const std::vector<int64_t>& args) {
+    const double minTime = settings().minTime;
+    int64_t iterations = 1;
+    while (true) {
+        State state(args, iterations);
+        bench.function(state);
+
+        bool done = state.realSeconds >= minTime || iterations >= 1000000000;
+        if (done) {
+            Result result;
+            result.name = runName(bench, args);
+            result.runName = result.name;
+            result.iterations = iterations;
+            result.unit = bench.timeUnit;
+            double scale = unitScale(bench.timeUnit) / static_cast<double>(iterations);
+            result.realTime = state.realSeconds * scale;
+            result.cpuTime = state.cpuSeconds * scale;
+            if (state.realSeconds > 0) {
+                result.bytesPerSecond = static_cast<double>(state.bytesProcessed) / state.realSeconds;
+                result.itemsPerSecond = static_cast<double>(state.itemsProcessed) / state.realSeconds;
+            }
+            result.label = state.label;
+            return result;
+        }
+
+        double multiplier = state.realSeconds / minTime > 0.1
+                                ? minTime * 1.4 / std::max(state.realSeconds, 1e-9)
+                                : 10.0;
+        int64_t next = static_cast<int64_t>(static_cast<double>(iterations) * multiplier);
+        iterations = std::min<int64_t>(std::max(next, iterations + 1), 1000000000);
+    }
+}
+
+std::string humanRate(double perSecond, const char* suffix) {
+    static const char* prefixes[] = {"", "k", "M", "G", "T"};
+    size_t p = 0;
+    while (perSecond >= 1000.0 && p + 1 < sizeof(prefixes) / sizeof(prefixes[0])) {
+        perSecond /= 1000.0;
+        ++p;
+    }
+    std::ostringstream text;
+    text << std::setprecision(4) << perSecond << prefixes[p] << suffix;
+    return text.str();
+}
+
+size_t nameWidth(const std::vector<std::string>& names) {
+    size_t width = 10;
+    for (const auto& name : names) {
+        width = std::max(width, name.size());
+    }
+    return width;
+}
+
+void writeConsoleHeader(std::ostream& out, size_t width) {
+    out << std::left << std::setw(static_cast<int>(width)) << "Benchmark" << std::right
+        << std::setw(16) << "Time" << std::setw(16) << "CPU" << std::setw(12) << "Iterations"
+        << " UserCounters...\n"
+        << std::string(width + 60, '-') << "\n";
+}
+
+void writeConsoleRow(std::ostream& out, size_t width, const Result& r) {
+    out << std::left << std::setw(static_cast<int>(width)) << r.name << std::right << std::fixed
+        << std::setprecision(0) << std::setw(13) << r.realTime << " " << std::setw(2)
+        << unitName(r.unit) << std::setw(13) << r.cpuTime << " " << std::setw(2)
+        << unitName(r.unit) << std::setw(12) << r.iterations;
+    out.unsetf(std::ios::fixed);
+    if (r.bytesPerSecond > 0) {
+        out << " bytes_per_second=" << humanRate(r.bytesPerSecond, "B/s");
+    }
+    if (r.itemsPerSecond > 0) {
+        out << " items_per_second=" << humanRate(r.itemsPerSecond, "/s");
+    }
+    if (!r.label.empty()) {
+        out << " " << r.label;
+    }
+    out << std::endl;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+
+    out << "{\n  \"context\": {\n"
+        << "    \"date\": \"" << date << "\",\n"
+        << "    \"host_name\": \"" << jsonEscape(host) << "\",\n"
+        << "    \"executable\": \"" << jsonEscape(settings().executable) << "\",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+        << "    \"library_build_type\": \"release\"\n"
+#else
+        << "    \"library_build_type\": \"debug\"\n"
+#endif
+        << "  },\n  \"benchmarks\": [\n";
+    out << std::setprecision(10);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    {\n"
+            << "      \"name\": \"" << jsonEscape(r.name) << "\",\n"
+            << "      \"run_name\": \"" << jsonEscape(r.runName) << "\",\n"
+            << "      \"run_type\": \"iteration\",\n"
+            << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"real_time\": " << r.realTime << ",\n"
+            << "      \"cpu_time\": " << r.cpuTime << ",\n"
+            << "      \"time_unit\": \"" << unitName(r.unit) << "\"";
+        if (r.bytesPerSecond > 0) {
+            out << ",\n      \"bytes_per_second\": " << r.bytesPerSecond;
+        }
+        if (r.itemsPerSecond > 0) {
+            out << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+        }
+        if (!r.label.empty()) {
+            out << ",\n      \"label\": \"" << jsonEscape(r.label) << "\"";
+        }
+        out << "\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void writeResults(std::ostream& out, const std::string& format, const std::vector<Result>& results) {
+    if (format == "json") {
+        writeJson(out, results);
+        return;
+    }
+    std::vector<std::string> names;
+    for (const auto& r : results) {
+        names.push_back(r.name);
+    }
+    size_t width = nameWidth(names);
+    writeConsoleHeader(out, width);
+    for (const auto& r : results) {
+        writeConsoleRow(out, width, r);
+    }
+}
+
+} // namespace
+
+void State::startTimer() {
+    realStart = realNow();
+    cpuStart = cpuNow();
+}
+
+void State::stopTimer() {
+    realSeconds += realNow() - realStart;
+    cpuSeconds += cpuNow() - cpuStart;
+}
+
+namespace internal {
+
+Benchmark* Benchmark::Arg(int64_t value) {
+    argSets.push_back({value});
+    return this;
+}
+
+Benchmark* Benchmark::Args(const std::vector<int64_t>& values) {
+    argSets.push_back(values);
+    return this;
+}
+
+Benchmark* Benchmark::ArgsProduct(const std::vector<std::vector<int64_t>>& ranges) {
+    std::vector<std::vector<int64_t>> product = {{}};
+    for (const auto& range : ranges) {
+        std::vector<std::vector<int64_t>> next;
+        for (const auto& prefix : product) {
+            for (int64_t value : range) {
+                next.push_back(prefix);
+                next.back().push_back(value);
+            }
+        }
+        product = std::move(next);
+    }
+    argSets.insert(argSets.end(), product.begin(), product.end());
+    return this;
+}
+
+Benchmark* Benchmark::ArgNames(const std::vector<std::string>& names) {
+    argNames = names;
+    return this;
+}
+
+Benchmark* Benchmark::Unit(TimeUnit unit) {
+    timeUnit = unit;
+    return this;
+}
+
+Benchmark* Benchmark::UseRealTime() {
+    // Rates here always come from wall time
+    return this;
+}
+
+Benchmark* registerBenchmark(const char* name, Benchmark::Function function) {
+    registry().push_back(std::make_unique<Benchmark>(name, function));
+    return registry().back().get();
+}
+
+} // namespace internal
+
+void Initialize(int* argc, char** argv) {
+    Settings& s = settings();
+    s.executable = *argc > 0 ? argv[0] : "";
+
+    int kept = 1;
+    for (int i = 1; i < *argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg](const std::string& flag, std::string& out) {
+            if (arg.rfind(flag + "=", 0) != 0) {
+                return false;
+            }
+            out = arg.substr(flag.size() + 1);
+            return true;
+        };
+
+        std::string text;
+        if (value("--benchmark_filter", s.filter) || value("--benchmark_format", s.format) ||
+            value("--benchmark_out", s.outFile) || value("--benchmark_out_format", s.outFormat)) {
+            continue;
+        } else if (value("--benchmark_min_time", text)) {
+            if (!text.empty() && text.back() == 's') {
+                text.pop_back();
+            }
+            s.minTime = std::stod(text);
+        } else if (arg == "--benchmark_list_tests" || arg == "--benchmark_list_tests=true") {
+            s.listTests = true;
+        } else if (arg.rfind("--benchmark_", 0) == 0) {
+            std::cerr << "error: unrecognized command-line flag: " << arg << std::endl;
+            std::exit(1);
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    *argc = kept;
+}
+
+size_t RunSpecifiedBenchmarks() {
+    const Settings& s = settings();
+    std::regex filter(s.filter == "all" ? "." : s.filter);
+
+    // Expand every registration into the runs selected by the filter
+    std::vector<std::pair<const internal::Benchmark*, std::vector<int64_t>>> runs;
+    std::vector<std::string> names;
+    for (const auto& bench : registry()) {
+        std::vector<std::vector<int64_t>> argSets = bench->argSets;
+        if (argSets.empty()) {
+            argSets.push_back({});
+        }
+        for (const auto& args : argSets) {
+            std::string name = runName(*bench, args);
+            if (std::regex_search(name, filter)) {
+                runs.emplace_back(bench.get(), args);
+                names.push_back(name);
+            }
+        }
+    }
+
+    if (s.listTests) {
+        for (const auto& name : names) {
+            std::cout << name << "\n";
+        }
+        return 0;
+    }
+
+    size_t width = nameWidth(names);
+    bool console = s.format != "json";
+    if (console) {
+        writeConsoleHeader(std::cout, width);
+    }
+
+    std::vector<Result> results;
+    for (const auto& [bench, args] : runs) {
+        results.push_back(runOne(*bench, args));
+        if (console) {
+            writeConsoleRow(std::cout, width, results.back());
+        }
+    }
+
+    if (!console) {
+        writeJson(std::cout, results);
+    }
+    if (!s.outFile.empty()) {
+        std::ofstream out(s.outFile);
+        if (!out) {
+            std::cerr << "error: failed to open " << s.outFile << std::endl;
+        }
+        writeResults(out, s.outFormat, results);
+    }
+    return results.size();
+}
+
+} // namespace benchmark
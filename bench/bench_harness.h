@@ -0,0 +1,166 @@
+/**
+ * @file bench_harness.h
+ * @brief Minimal stand-in for the Google Benchmark API used by timing_bench
+ *
+ * Only the subset timing_bench needs is provided: State with range-for
+ * iteration, argument ranges, paused timing, byte / item throughput and labels, the
+ * BENCHMARK registration macro with Arg / Args / ArgsProduct / ArgNames /
+ * Unit / UseRealTime, and BENCHMARK_MAIN. JSON output follows Google Benchmark's schema so
+ * results from either build can be compared with the same tools.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace benchmark {
+
+enum TimeUnit { kNanosecond, kMicrosecond, kMillisecond, kSecond };
+
+/**
+ * @class State
+ * @brief Per-run state handed to a benchmark function
+ */
+class State {
+public:
+    // Marked unused so "for (auto _ : state)" does not warn
+    struct __attribute__((unused)) Value {};
+
+    /**
+     * @class Iterator
+     * @brief Counts down the iterations of one run and stops the timer at the end
+     */
+    class Iterator {
+    public:
+        explicit Iterator(State* state) : state(state), remaining(state ? state->maxIterations : 0) {}
+        Value operator*() const { return {}; }
+        Iterator& operator++() {
+            --remaining;
+            return *this;
+        }
+        bool operator!=(const Iterator&) {
+            if (remaining != 0) {
+                return true;
+            }
+            state->stopTimer();
+            return false;
+        }
+
+    private:
+        State* state;
+        int64_t remaining;
+    };
+
+    State(std::vector<int64_t> args, int64_t iterations)
+        : args(std::move(args)), maxIterations(iterations) {}
+
+    Iterator begin() {
+        startTimer();
+        return Iterator(this);
+    }
+    Iterator end() { return Iterator(nullptr); }
+
+    int64_t range(size_t i = 0) const { return args.at(i); }
+    int64_t iterations() const { return maxIterations; }
+
+    void PauseTiming() { stopTimer(); }
+    void ResumeTiming() { startTimer(); }
+
+    void SetBytesProcessed(int64_t bytes) { bytesProcessed = bytes; }
+    void SetItemsProcessed(int64_t items) { itemsProcessed = items; }
+    void SetLabel(const std::string& text) { label = text; }
+
+    int64_t bytesProcessed{0};
+    int64_t itemsProcessed{0};
+    std::string label;
+    double realSeconds{0.0};
+    double cpuSeconds{0.0};
+
+private:
+    void startTimer();
+    void stopTimer();
+
+    std::vector<int64_t> args;
+    int64_t maxIterations;
+    double realStart{0.0};
+    double cpuStart{0.0};
+};
+
+/**
+ * @brief Keep the compiler from discarding a value computed in a benchmark
+ * @param value Value to keep alive
+ */
+template <class T>
+inline void DoNotOptimize(T&& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+namespace internal {
+
+/**
+ * @class Benchmark
+ * @brief A registered benchmark function and the argument sets it runs with
+ */
+class Benchmark {
+public:
+    using Function = void (*)(State&);
+
+    Benchmark(std::string name, Function function) : name(std::move(name)), function(function) {}
+
+    Benchmark* Arg(int64_t value);
+    Benchmark* Args(const std::vector<int64_t>& values);
+    Benchmark* ArgsProduct(const std::vector<std::vector<int64_t>>& ranges);
+    Benchmark* ArgNames(const std::vector<std::string>& names);
+    Benchmark* Unit(TimeUnit unit);
+    Benchmark* UseRealTime();
+
+    std::string name;
+    Function function;
+    std::vector<std::vector<int64_t>> argSets;
+    std::vector<std::string> argNames;
+    TimeUnit timeUnit{kNanosecond};
+};
+
+/**
+ * @brief Register a benchmark; used by the BENCHMARK macro
+ * @param name Function name
+ * @param function Benchmark body
+ * @return The registration, for chaining argument setters
+ */
+Benchmark* registerBenchmark(const char* name, Benchmark::Function function);
+
+} // namespace internal
+
+/**
+ * @brief Parse --benchmark_* flags out of the command line
+ * @param argc Argument count
+ * @param argv Arguments
+ */
+void Initialize(int* argc, char** argv);
+
+/**
+ * @brief Run every registered benchmark matching the filter and report the results
+ * @return Number of runs reported
+ */
+size_t RunSpecifiedBenchmarks();
+
+} // namespace benchmark
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_INNER(a, b)
+
+#define BENCHMARK(fn)                                                      \
+    static ::benchmark::internal::Benchmark* BENCHMARK_CONCAT(             \
+        benchmarkRegistration, __LINE__) [[maybe_unused]] =                \
+        ::benchmark::internal::registerBenchmark(#fn, fn)
+
+#define BENCHMARK_MAIN()                          \
+    int main(int argc, char** argv) {             \
+        ::benchmark::Initialize(&argc, argv);     \
+        ::benchmark::RunSpecifiedBenchmarks();    \
+        return 0;                                 \
+    }                                             \
+    int main(int, char**)
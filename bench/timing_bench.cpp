@@ -0,0 +1,530 @@
+/**
+ * @file timing_bench.cpp
+ * @brief Benchmarks for the parser, analyzer and output hot paths
+ *
+ * Builds against Google Benchmark when it is available and against the
+ * minimal harness in bench_harness.h otherwise. Both accept
+ * --benchmark_format=json and --benchmark_out=FILE, so runs can be compared
+ * across commits.
+ */
+
+#ifdef HAVE_GOOGLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#else
+#include "bench_harness.h"
+#endif
+
+#include "analyzer.h"
+#include "batch_reader.h"
+#include "parser.h"
+#include "radix_rank.h"
+#include "report_generator.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdio>
+#ifdef HAVE_PARALLEL_STL
+#include <execution>
+#endif
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @struct TimingParserBenchAccess
+ * @brief Exposes the private per-line parsers of TimingParser to the benchmarks
+ */
+struct TimingParserBenchAccess {
+    static auto parseHeader(TimingParser& parser, const std::string& line) {
+        return parser.parsePathHeader(line);
+    }
+
+    static auto parseStage(TimingParser& parser, const std::string& line) {
+        return parser.parsePathStage(line);
+    }
+};
+
+namespace {
+
+/**
+ * @class ReportFiles
+ * @brief Generated report files keyed by path count, removed at exit
+ */
+class ReportFiles {
+public:
+    ~ReportFiles() {
+        for (const auto& [count, file] : files) {
+            std::remove(file.path.c_str());
+        }
+    }
+
+    struct File {
+        std::string path;
+        size_t bytes;
+    };
+
+    const File& get(size_t pathCount) {
+        auto it = files.find(pathCount);
+        if (it == files.end()) {
+            // 4-12 stages per path over a shared pool of names, so nodes recur
+            GeneratorOptions options;
+            options.pathCount = pathCount;
+            options.minStages = 4;
+            options.maxStages = 12;
+            options.nodeCount = 10000;
+            options.seed = 42;
+
+            File file{"timing_bench_" + std::to_string(pathCount) + ".rpt", 0};
+            file.bytes = ReportGenerator(options).writeFile(file.path).bytes;
+            it = files.emplace(pathCount, file).first;
+        }
+        return it->second;
+    }
+
+private:
+    std::map<size_t, File> files;
+};
+
+ReportFiles& reportFiles() {
+    static ReportFiles instance;
+    return instance;
+}
+
+/**
+ * @class ReadSets
+ * @brief Directories' worth of plain files for the batch reader, removed at exit
+ */
+class ReadSets {
+public:
+    ~ReadSets() {
+        for (const auto& [layout, files] : sets) {
+            for (const auto& file : files) {
+                std::remove(file.c_str());
+            }
+        }
+    }
+
+    // Layout 0: 1000 files of 16 KiB; layout 1: 8 files of 16 MiB
+    const std::vector<std::string>& get(int64_t layout) {
+        auto it = sets.find(layout);
+        if (it == sets.end()) {
+            size_t count = layout == 0 ? 1000 : 8;
+            size_t bytes = layout == 0 ? 16 << 10 : 16 << 20;
+            std::string text(bytes, 'x');
+            std::vector<std::string> files;
+            for (size_t i = 0; i < count; ++i) {
+                files.push_back("timing_bench_read_" + std::to_string(layout) + "_" +
+                                std::to_string(i) + ".rpt");
+                std::ofstream(files.back(), std::ios::binary) << text;
+            }
+            it = sets.emplace(layout, std::move(files)).first;
+        }
+        return it->second;
+    }
+
+private:
+    std::map<int64_t, std::vector<std::string>> sets;
+};
+
+ReadSets& readSets() {
+    static ReadSets instance;
+    return instance;
+}
+
+// Drop files from the page cache so reads go to the device
+void evictFromCache(const std::vector<std::string>& files) {
+    for (const auto& file : files) {
+        int fd = ::open(file.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            ::fdatasync(fd);
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+    }
+}
+
+// Parsed paths for a generated report, cached across benchmarks
+const std::vector<TimingPath>& parsedPaths(size_t pathCount) {
+    static std::map<size_t, std::vector<TimingPath>> cache;
+    auto it = cache.find(pathCount);
+    if (it == cache.end()) {
+        TimingParser parser;
+        it = cache.emplace(pathCount, parser.parseFile(reportFiles().get(pathCount).path)).first;
+    }
+    return it->second;
+}
+
+// Header or stage lines of a generated report
+std::vector<std::string> reportLines(size_t pathCount, bool headers) {
+    std::vector<std::string> lines;
+    std::ifstream file(reportFiles().get(pathCount).path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && (line.rfind("Path ", 0) == 0) == headers) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+/**
+ * @class SilenceStdout
+ * @brief Discards std::cout output for its lifetime
+ */
+class SilenceStdout {
+public:
+    SilenceStdout() : saved(std::cout.rdbuf(&sink)) {}
+    ~SilenceStdout() { std::cout.rdbuf(saved); }
+
+private:
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    NullBuffer sink;
+    std::streambuf* saved;
+};
+
+void BM_ParsePathHeader(benchmark::State& state) {
+    auto lines = reportLines(1000, true);
+    TimingParser parser;
+    size_t i = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        const auto& line = lines[i];
+        benchmark::DoNotOptimize(TimingParserBenchAccess::parseHeader(parser, line));
+        bytes += static_cast<int64_t>(line.size());
+        i = i + 1 == lines.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_ParsePathHeader);
+
+void BM_ParsePathStage(benchmark::State& state) {
+    auto lines = reportLines(1000, false);
+    TimingParser parser;
+    size_t i = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        const auto& line = lines[i];
+        benchmark::DoNotOptimize(TimingParserBenchAccess::parseStage(parser, line));
+        bytes += static_cast<int64_t>(line.size());
+        i = i + 1 == lines.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_ParsePathStage);
+
+// Items are paths, so items_per_second reads as paths/s
+void BM_ParseFile(benchmark::State& state) {
+    const auto& file = reportFiles().get(static_cast<size_t>(state.range(0)));
+    int64_t pathCount = 0;
+    for (auto _ : state) {
+        TimingParser parser;
+        auto paths = parser.parseFile(file.path);
+        pathCount += static_cast<int64_t>(paths.size());
+        benchmark::DoNotOptimize(paths.data());
+    }
+    state.SetItemsProcessed(pathCount);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(file.bytes));
+}
+BENCHMARK(BM_ParseFile)->ArgNames({"paths"})->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Full parse through the read / tokenize / build pipeline
+void BM_ParseFilePipelined(benchmark::State& state) {
+    const auto& file = reportFiles().get(10000);
+    int64_t pathCount = 0;
+    for (auto _ : state) {
+        TimingParser parser;
+        parser.setParseThreads(static_cast<size_t>(state.range(0)));
+        auto paths = parser.parseFile(file.path);
+        pathCount += static_cast<int64_t>(paths.size());
+        benchmark::DoNotOptimize(paths.data());
+    }
+    state.SetItemsProcessed(pathCount);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(file.bytes));
+}
+BENCHMARK(BM_ParseFilePipelined)
+    ->ArgNames({"tokenizers"})
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Aggregate MB/s reading a directory of reports; pread = 0, io_uring = 1
+void BM_BatchRead(benchmark::State& state) {
+    auto backend = state.range(0) == 0 ? BatchReader::Backend::Pread
+                                       : BatchReader::Backend::IoUring;
+    if (backend == BatchReader::Backend::IoUring && !BatchReader::ioUringAvailable()) {
+        state.SetLabel("io_uring unavailable; pread");
+        backend = BatchReader::Backend::Pread;
+    }
+    const auto& files = readSets().get(state.range(1));
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        evictFromCache(files);
+        state.ResumeTiming();
+
+        BatchReader::Options options;
+        options.backend = backend;
+        BatchReader reader(files, options);
+        BatchReader::File file;
+        while (reader.next(file)) {
+            bytes += static_cast<int64_t>(file.size);
+            benchmark::DoNotOptimize(file.data.get());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(files.size()));
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_BatchRead)
+    ->ArgNames({"uring", "large"})
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Lazy parse of a plain top-k run: header scan, then stages of the top 100 only
+void BM_ScanAndLoadTopK(benchmark::State& state) {
+    const auto& file = reportFiles().get(static_cast<size_t>(state.range(0)));
+    TimingAnalyzer analyzer;
+    int64_t pathCount = 0;
+    for (auto _ : state) {
+        TimingParser parser;
+        std::vector<PathExtent> extents;
+        auto paths = parser.scanFile(file.path, extents);
+        std::vector<uint32_t> positions(paths.size());
+        std::iota(positions.begin(), positions.end(), 0u);
+        auto top = analyzer.rankPaths(paths, std::move(positions), 100);
+        parser.loadStages(paths, extents, top);
+        pathCount += static_cast<int64_t>(paths.size());
+        benchmark::DoNotOptimize(paths.data());
+    }
+    state.SetItemsProcessed(pathCount);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(file.bytes));
+}
+BENCHMARK(BM_ScanAndLoadTopK)->ArgNames({"paths"})->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+void BM_FindCriticalPaths(benchmark::State& state) {
+    const auto& paths = parsedPaths(static_cast<size_t>(state.range(0)));
+    int topK = static_cast<int>(state.range(1));
+    TimingAnalyzer analyzer;
+    for (auto _ : state) {
+        auto critical = analyzer.findCriticalPaths(paths, topK);
+        benchmark::DoNotOptimize(critical.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_FindCriticalPaths)
+    ->ArgNames({"n", "k"})
+    ->ArgsProduct({{1000, 10000}, {10, 100, 1000}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Ranks 10000 paths by one key, either through the rankPaths() instantiation
+// for that key or through a comparator that calls a key chosen at run time
+void BM_RankByKey(benchmark::State& state) {
+    const auto& paths = parsedPaths(10000);
+    auto key = static_cast<RankKey>(state.range(0));
+    bool specialized = state.range(1) != 0;
+    std::vector<double> clockPeriods(paths.size(), 10.0);
+    auto columns = PathColumns::build(paths, clockPeriods);
+    std::vector<uint32_t> rows(paths.size());
+    std::iota(rows.begin(), rows.end(), 0u);
+    
+    std::function<double(const PathColumns&, uint32_t)> score;
+    switch (key) {
+        case RankKey::Delay: score = RankKeys::Delay::score; break;
+        case RankKey::Slack: score = RankKeys::Slack::score; break;
+        case RankKey::WorstStage: score = RankKeys::WorstStage::score; break;
+        case RankKey::Stages: score = RankKeys::Stages::score; break;
+        case RankKey::NetDelayShare: score = RankKeys::NetDelayShare::score; break;
+    }
+    
+    TimingAnalyzer analyzer;
+    const int topK = 100;
+    for (auto _ : state) {
+        if (specialized) {
+            auto ranked = analyzer.rankPaths(columns, rows, topK, key);
+            benchmark::DoNotOptimize(ranked.data());
+        } else {
+            std::vector<uint32_t> ranked = rows;
+            std::partial_sort(ranked.begin(), ranked.begin() + topK, ranked.end(),
+                              [&](uint32_t a, uint32_t b) {
+                                  double scoreA = score(columns, a);
+                                  double scoreB = score(columns, b);
+                                  if (scoreA != scoreB) {
+                                      return scoreA > scoreB;
+                                  }
+                                  return a < b;
+                              });
+            ranked.resize(topK);
+            benchmark::DoNotOptimize(ranked.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_RankByKey)
+    ->ArgNames({"key", "specialized"})
+    ->ArgsProduct({{0, 1, 2, 3, 4}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Ranks paths by delay, worst stage and stage count, in one pass with a heap
+// per key or in one specialized ranking per key
+void BM_RankBySeveralKeys(benchmark::State& state) {
+    const auto& paths = parsedPaths(static_cast<size_t>(state.range(0)));
+    bool onePass = state.range(1) != 0;
+    auto columns = PathColumns::build(paths);
+    std::vector<uint32_t> rows(paths.size());
+    std::iota(rows.begin(), rows.end(), 0u);
+    std::vector<RankKey> keys = {RankKey::Delay, RankKey::WorstStage, RankKey::Stages};
+    
+    TimingAnalyzer analyzer;
+    const int topK = 100;
+    for (auto _ : state) {
+        if (onePass) {
+            auto ranked = analyzer.rankPaths(columns, rows, topK, keys);
+            benchmark::DoNotOptimize(ranked.data());
+        } else {
+            for (RankKey key : keys) {
+                auto ranked = analyzer.rankPaths(columns, rows, topK, key);
+                benchmark::DoNotOptimize(ranked.data());
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_RankBySeveralKeys)
+    ->ArgNames({"n", "one_pass"})
+    ->ArgsProduct({{10000, 100000}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Ranks every one of n delays (-k all): the parallel radix sort over packed
+// (key, row) pairs against std::sort and, with TBB, std::sort(par) comparing
+// the delays themselves. Ties go to the lower row in every variant
+void BM_FullRank(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    int method = static_cast<int>(state.range(1));
+    std::mt19937 random(3);
+    std::uniform_int_distribution<int> picoseconds(0, 20000);
+    std::vector<double> delays(n);
+    for (auto& delay : delays) {
+        delay = picoseconds(random) / 1000.0;
+    }
+    auto moreCriticalRow = [&delays](uint32_t a, uint32_t b) {
+        return delays[a] != delays[b] ? delays[a] > delays[b] : a < b;
+    };
+    
+    ThreadPool pool;
+    for (auto _ : state) {
+        std::vector<uint32_t> ranked;
+        if (method == 0) {
+            std::vector<RadixRank::KeyedRow> keyed(n);
+            for (uint32_t row = 0; row < n; ++row) {
+                keyed[row] = {RadixRank::descendingKey(delays[row]), row};
+            }
+            RadixRank::sort(keyed, pool);
+            ranked.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                ranked[i] = keyed[i].row;
+            }
+        } else {
+            ranked.resize(n);
+            std::iota(ranked.begin(), ranked.end(), 0u);
+            if (method == 1) {
+                std::sort(ranked.begin(), ranked.end(), moreCriticalRow);
+            } else {
+#ifdef HAVE_PARALLEL_STL
+                std::sort(std::execution::par, ranked.begin(), ranked.end(), moreCriticalRow);
+#endif
+            }
+        }
+        benchmark::DoNotOptimize(ranked.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_FullRank)
+    ->ArgNames({"n", "method"})
+#ifdef HAVE_PARALLEL_STL
+    ->ArgsProduct({{100000, 1000000, 10000000}, {0, 1, 2}})
+#else
+    ->ArgsProduct({{100000, 1000000, 10000000}, {0, 1}})
+#endif
+    ->Unit(benchmark::kMillisecond);
+
+// Finds the 100 paths ranked around the median of n delays (--rank-range):
+// radix-narrowed selection against a full radix sort and a full std::sort
+void BM_RankRange(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    int method = static_cast<int>(state.range(1));
+    std::mt19937 random(3);
+    std::uniform_int_distribution<int> picoseconds(0, 20000);
+    std::vector<RadixRank::KeyedRow> keyed(n);
+    for (uint32_t row = 0; row < n; ++row) {
+        keyed[row] = {RadixRank::descendingKey(picoseconds(random) / 1000.0), row};
+    }
+    size_t first = n / 2 - 50;
+    size_t last = n / 2 + 50;
+    
+    ThreadPool pool;
+    for (auto _ : state) {
+        std::vector<uint32_t> ranked;
+        if (method == 0) {
+            ranked = RadixRank::selectRange(keyed, first, last, pool);
+        } else {
+            auto sorted = keyed;
+            if (method == 1) {
+                RadixRank::sort(sorted, pool);
+            } else {
+                std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+                    return a.key != b.key ? a.key < b.key : a.row < b.row;
+                });
+            }
+            for (size_t i = first; i < last; ++i) {
+                ranked.push_back(sorted[i].row);
+            }
+        }
+        benchmark::DoNotOptimize(ranked.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_RankRange)
+    ->ArgNames({"n", "method"})
+    ->ArgsProduct({{100000, 1000000, 10000000}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_AnalyzePath(benchmark::State& state) {
+    const auto& paths = parsedPaths(1000);
+    TimingAnalyzer analyzer;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(analyzer.analyzePath(paths[i]));
+        i = i + 1 == paths.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AnalyzePath);
+
+void BM_PrintResults(benchmark::State& state) {
+    TimingAnalyzer analyzer;
+    auto critical = analyzer.findCriticalPaths(parsedPaths(10000), static_cast<int>(state.range(0)));
+    SilenceStdout silence;
+    for (auto _ : state) {
+        Utils::printResults(critical);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(critical.size()));
+}
+BENCHMARK(BM_PrintResults)->ArgNames({"k"})->Arg(10)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
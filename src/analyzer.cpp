@@ -4,35 +4,199 @@
  */
 
 #include "analyzer.h"
+#include "profiler.h"
+#include "radix_rank.h"
+#include "thread_pool.h"
+#include "trace.h"
 #include <algorithm>
+#include <numeric>
 #include <sstream>
 #include <memory>
 
+namespace {
+
+// Whether a ranking keeps every candidate and is large enough to radix sort.
+// Candidates in ascending order make the sort's candidate-order ties the same
+// as the comparison sorts' row-order ties
+bool ranksAll(const std::vector<uint32_t>& candidates, int topK) {
+    return candidates.size() >= RadixRank::kMinRows &&
+           static_cast<size_t>(std::max(topK, 0)) >= candidates.size() &&
+           std::is_sorted(candidates.begin(), candidates.end());
+}
+
+} // namespace
+
 std::vector<TimingPathAnalysis> TimingAnalyzer::findCriticalPaths(
     const std::vector<TimingPath>& paths, int topK) {
     
-    // Create a copy of paths that we can sort
-    std::vector<std::shared_ptr<TimingPath>> pathPtrs;
-    for (const auto& path : paths) {
-        pathPtrs.push_back(std::make_shared<TimingPath>(path));
-    }
+    // Rank positions rather than copies of the paths; only the top K are copied
+    std::vector<uint32_t> candidates(paths.size());
+    std::iota(candidates.begin(), candidates.end(), 0u);
+    return findCriticalPaths(paths, std::move(candidates), topK);
+}
+
+std::vector<TimingPathAnalysis> TimingAnalyzer::findCriticalPaths(
+    const std::vector<TimingPath>& paths, std::vector<uint32_t> candidates, int topK) {
     
-    // Sort paths by total delay in descending order
-    std::sort(pathPtrs.begin(), pathPtrs.end(), 
-              [](const auto& a, const auto& b) {
-                  return a->totalDelay > b->totalDelay;
-              });
+    return analyzePaths(paths, rankPaths(paths, std::move(candidates), topK));
+}
+
+std::vector<TimingPathAnalysis> TimingAnalyzer::analyzePaths(
+    const std::vector<TimingPath>& paths, const std::vector<uint32_t>& ranked) {
     
-    // Get the top K paths
+    Profiler::ScopedTimer timer(Profiler::Phase::Analyze);
+    Trace::Span span("analyze", "phase");
     std::vector<TimingPathAnalysis> criticalPaths;
-    for (int i = 0; i < std::min(topK, static_cast<int>(pathPtrs.size())); ++i) {
-        auto analysis = analyzePath(*pathPtrs[i]);
-        criticalPaths.push_back(analysis);
+    for (uint32_t position : ranked) {
+        criticalPaths.push_back(analyzePath(paths[position]));
     }
     
+    timer.addItems(criticalPaths.size());
     return criticalPaths;
 }
 
+std::vector<uint32_t> TimingAnalyzer::rankPaths(
+    const std::vector<TimingPath>& paths, std::vector<uint32_t> candidates, int topK) {
+    
+    Profiler::ScopedTimer timer(Profiler::Phase::Rank);
+    Trace::Span span("rank", "phase");
+    timer.addItems(candidates.size());
+    
+    if (ranksAll(candidates, topK)) {
+        ThreadPool pool;
+        return RadixRank::rankPaths(paths, candidates, pool);
+    }
+    
+    size_t count = std::min(candidates.size(), static_cast<size_t>(std::max(topK, 0)));
+    
+    // Order by total delay; ties keep report order
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                      [&paths](uint32_t a, uint32_t b) {
+                          if (paths[a].totalDelay != paths[b].totalDelay) {
+                              return paths[a].totalDelay > paths[b].totalDelay;
+                          }
+                          return a < b;
+                      });
+    candidates.resize(count);
+    return candidates;
+}
+
+std::vector<uint32_t> TimingAnalyzer::rankPaths(
+    const PathColumns& columns, const std::vector<uint32_t>& candidates, int topK,
+    RankKey key) {
+    
+    Profiler::ScopedTimer timer(Profiler::Phase::Rank);
+    Trace::Span span("rank", "phase");
+    timer.addItems(candidates.size());
+    
+    if (ranksAll(candidates, topK)) {
+        ThreadPool pool;
+        return RadixRank::rankRows(columns, candidates, key, pool);
+    }
+    
+    // Dispatch once; each instantiation ranks with its own inlined key
+    switch (key) {
+        case RankKey::Slack:
+            return rankRows<RankKeys::Slack>(columns, candidates, topK);
+        case RankKey::WorstStage:
+            return rankRows<RankKeys::WorstStage>(columns, candidates, topK);
+        case RankKey::Stages:
+            return rankRows<RankKeys::Stages>(columns, candidates, topK);
+        case RankKey::NetDelayShare:
+            return rankRows<RankKeys::NetDelayShare>(columns, candidates, topK);
+        case RankKey::Delay:
+            break;
+    }
+    return rankRows<RankKeys::Delay>(columns, candidates, topK);
+}
+
+std::vector<std::vector<uint32_t>> TimingAnalyzer::rankPaths(
+    const PathColumns& columns, const std::vector<uint32_t>& candidates, int topK,
+    const std::vector<RankKey>& keys) {
+    
+    Profiler::ScopedTimer timer(Profiler::Phase::Rank);
+    Trace::Span span("rank", "phase");
+    timer.addItems(candidates.size());
+    
+    if (ranksAll(candidates, topK)) {
+        // Heaps as large as the input only slow a full ranking down
+        ThreadPool pool;
+        std::vector<std::vector<uint32_t>> ranked;
+        for (RankKey key : keys) {
+            ranked.push_back(RadixRank::rankRows(columns, candidates, key, pool));
+        }
+        return ranked;
+    }
+    
+    // Rows stream through once, a block at a time; every key's heap sees a
+    // block while it is in cache, through the loop specialized for that key
+    // -k all asks for INT_MAX rows; no heap keeps more than the candidates
+    constexpr size_t kBlockRows = 1024;
+    size_t count = std::min(candidates.size(), static_cast<size_t>(std::max(topK, 0)));
+    std::vector<TopKHeap> heaps(keys.size(), TopKHeap(count, count));
+    for (size_t begin = 0; begin < candidates.size(); begin += kBlockRows) {
+        const uint32_t* first = candidates.data() + begin;
+        const uint32_t* last = first + std::min(kBlockRows, candidates.size() - begin);
+        for (size_t k = 0; k < keys.size(); ++k) {
+            switch (keys[k]) {
+                case RankKey::Delay:
+                    offerRows<RankKeys::Delay>(heaps[k], columns, first, last);
+                    break;
+                case RankKey::Slack:
+                    offerRows<RankKeys::Slack>(heaps[k], columns, first, last);
+                    break;
+                case RankKey::WorstStage:
+                    offerRows<RankKeys::WorstStage>(heaps[k], columns, first, last);
+                    break;
+                case RankKey::Stages:
+                    offerRows<RankKeys::Stages>(heaps[k], columns, first, last);
+                    break;
+                case RankKey::NetDelayShare:
+                    offerRows<RankKeys::NetDelayShare>(heaps[k], columns, first, last);
+                    break;
+            }
+        }
+    }
+    
+    std::vector<std::vector<uint32_t>> ranked;
+    for (auto& heap : heaps) {
+        ranked.push_back(heap.take());
+    }
+    return ranked;
+}
+
+std::vector<uint32_t> TimingAnalyzer::rankRange(
+    const std::vector<TimingPath>& paths, const std::vector<uint32_t>& candidates,
+    size_t first, size_t last) {
+    
+    Profiler::ScopedTimer timer(Profiler::Phase::Rank);
+    Trace::Span span("rank", "phase");
+    timer.addItems(candidates.size());
+    
+    ThreadPool pool;
+    return RadixRank::rankRange(paths, candidates, first, last, pool);
+}
+
+std::vector<uint32_t> TimingAnalyzer::rankRange(
+    const PathColumns& columns, const std::vector<uint32_t>& candidates, size_t first,
+    size_t last, RankKey key) {
+    
+    Profiler::ScopedTimer timer(Profiler::Phase::Rank);
+    Trace::Span span("rank", "phase");
+    timer.addItems(candidates.size());
+    
+    ThreadPool pool;
+    return RadixRank::rankRange(columns, candidates, key, first, last, pool);
+}
+
+std::vector<TimingPathAnalysis> TimingAnalyzer::findPathsThrough(
+    const std::vector<TimingPath>& paths, const PathIndex& index,
+    uint32_t nodeId, int topK) {
+    
+    // Only the matching paths are touched, never the whole path set
+    return findCriticalPaths(paths, index.pathsThrough(nodeId), topK);
+}
+
 TimingPathAnalysis TimingAnalyzer::analyzePath(const TimingPath& path) {
     auto pathCopy = std::make_shared<TimingPath>(path);
     TimingPathAnalysis analysis(pathCopy);
@@ -8,12 +8,16 @@
 #include <vector>
 #include <string>
 #include "parser.h"
+#include "path_columns.h"
+#include "path_index.h"
+#include "rank_key.h"
 
 /**
  * @struct TimingPathAnalysis
  * @brief Extended information about a timing path including optimization suggestions
  */
-struct TimingPathAnalysis {
+struct TimingPathAnalysis
+    : MemoryStats::Tracked<TimingPathAnalysis, MemoryStats::Category::Analyses> {
     std::shared_ptr<TimingPath> path;
     double worstStageDelay{0.0};
     std::shared_ptr<TimingEdge> worstStage;
@@ -54,6 +58,101 @@ public:
     std::vector<TimingPathAnalysis> findCriticalPaths(
         const std::vector<TimingPath>& paths, int topK);
     
+    /**
+     * @brief Find the top N critical paths among a subset of paths
+     * @param paths Vector of timing paths
+     * @param candidates Positions in paths of the paths to rank
+     * @param topK Number of critical paths to return
+     * @return Vector of critical path analyses, sorted by total delay
+     */
+    std::vector<TimingPathAnalysis> findCriticalPaths(
+        const std::vector<TimingPath>& paths, std::vector<uint32_t> candidates, int topK);
+    
+    /**
+     * @brief Analyze paths in a given order, e.g. as ranked by rankPaths()
+     * @param paths Vector of timing paths
+     * @param ranked Positions in paths of the paths to analyze
+     * @return One analysis per position, in the same order
+     */
+    std::vector<TimingPathAnalysis> analyzePaths(
+        const std::vector<TimingPath>& paths, const std::vector<uint32_t>& ranked);
+    
+    /**
+     * @brief Select the top N paths by total delay without analyzing them
+     * @param paths Vector of timing paths
+     * @param candidates Positions in paths of the paths to rank
+     * @param topK Number of paths to keep
+     * @return Positions of the selected paths, most critical first
+     */
+    std::vector<uint32_t> rankPaths(
+        const std::vector<TimingPath>& paths, std::vector<uint32_t> candidates, int topK);
+    
+    /**
+     * @brief Select the top N paths by any ranking key
+     * @param columns Columns of the paths
+     * @param candidates Rows of the paths to rank
+     * @param topK Number of paths to keep
+     * @param key Ranking key
+     * @return Rows of the selected paths, most critical first; ties keep report order
+     */
+    std::vector<uint32_t> rankPaths(
+        const PathColumns& columns, const std::vector<uint32_t>& candidates, int topK,
+        RankKey key);
+    
+    /**
+     * @brief Select the top N paths by several ranking keys in one pass
+     * @param columns Columns of the paths
+     * @param candidates Rows of the paths to rank
+     * @param topK Number of paths to keep per key
+     * @param keys Ranking keys
+     * @return Rows of the selected paths for each key, in the order of keys,
+     *         each most critical first
+     */
+    std::vector<std::vector<uint32_t>> rankPaths(
+        const PathColumns& columns, const std::vector<uint32_t>& candidates, int topK,
+        const std::vector<RankKey>& keys);
+    
+    /**
+     * @brief Select the paths ranked first .. last - 1 by total delay
+     * @param paths Vector of timing paths
+     * @param candidates Positions in paths of the paths to rank
+     * @param first Zero-based rank of the first path to keep
+     * @param last One past the rank of the last path to keep
+     * @return Positions of the selected paths, most critical first; ties keep
+     *         report order
+     *
+     * Selects the range instead of sorting everything ahead of it, see
+     * RadixRank::selectRange().
+     */
+    std::vector<uint32_t> rankRange(
+        const std::vector<TimingPath>& paths, const std::vector<uint32_t>& candidates,
+        size_t first, size_t last);
+    
+    /**
+     * @brief Select the paths ranked first .. last - 1 by any ranking key
+     * @param columns Columns of the paths
+     * @param candidates Rows of the paths to rank
+     * @param first Zero-based rank of the first path to keep
+     * @param last One past the rank of the last path to keep
+     * @param key Ranking key
+     * @return Rows of the selected paths, most critical first; ties keep report order
+     */
+    std::vector<uint32_t> rankRange(
+        const PathColumns& columns, const std::vector<uint32_t>& candidates, size_t first,
+        size_t last, RankKey key);
+    
+    /**
+     * @brief Find the top N critical paths with a stage through a node
+     * @param paths Vector of timing paths the index was built from
+     * @param index Node-to-path index over paths
+     * @param nodeId Interned ID of the node
+     * @param topK Number of critical paths to return
+     * @return Vector of critical path analyses, sorted by total delay
+     */
+    std::vector<TimingPathAnalysis> findPathsThrough(
+        const std::vector<TimingPath>& paths, const PathIndex& index,
+        uint32_t nodeId, int topK);
+    
     /**
      * @brief Generate optimization suggestion for a timing path
      * @param path The timing path to analyze
@@ -0,0 +1,484 @@
+/**
+ * @file batch_reader.cpp
+ * @brief Implementation of the batched multi-file reader
+ */
+
+#include "batch_reader.h"
+#include "mem_stats.h"
+#include "profiler.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+// A chunk read that finished; result is bytes read or -errno
+struct Completion {
+    uint64_t tag;
+    long result;
+};
+
+} // namespace
+
+/**
+ * @class BatchReader::Engine
+ * @brief Issues chunk reads and reports them as they finish
+ */
+class BatchReader::Engine {
+public:
+    virtual ~Engine() = default;
+
+    // Queue a read of length bytes at offset into buffer; tag identifies it
+    virtual void submit(uint64_t tag, int fd, char* buffer, uint64_t offset, size_t length) = 0;
+
+    // Start queued reads without waiting for any
+    virtual void flush() {}
+
+    // Start queued reads and wait until at least one read has finished
+    virtual void wait(std::vector<Completion>& done) = 0;
+
+    // Reads queued or running
+    size_t inFlight() const { return running; }
+
+protected:
+    size_t running{0};
+};
+
+#ifdef HAVE_IO_URING
+
+/**
+ * @class BatchReader::UringEngine
+ * @brief IORING_OP_READ requests on one ring, driven by raw system calls
+ *
+ * The ring is set up with io_uring_setup() and mapped directly, so neither
+ * liburing nor a particular glibc is needed; only the kernel header is. The
+ * submission queue is filled by the calling thread and handed over with one
+ * io_uring_enter() per batch. Reads of cached pages finish inline and the
+ * rest are run by the kernel's own workers, which is what keeps many reads
+ * in flight without a thread per read.
+ */
+class BatchReader::UringEngine : public BatchReader::Engine {
+public:
+    explicit UringEngine(size_t depth) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        long fd = ::syscall(__NR_io_uring_setup, static_cast<unsigned>(depth), &params);
+        if (fd < 0) {
+            throw std::runtime_error(std::string("io_uring_setup failed: ") +
+                                     std::strerror(errno));
+        }
+        ringFd = static_cast<int>(fd);
+
+        // IORING_OP_READ arrived in 5.6, together with this feature flag
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+            release();
+            throw std::runtime_error("io_uring on this kernel lacks IORING_OP_READ");
+        }
+
+        sqBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) {
+            sqBytes = cqBytes = std::max(sqBytes, cqBytes);
+        }
+        sqRing = map(sqBytes, IORING_OFF_SQ_RING);
+        cqRing = singleMap ? sqRing : map(cqBytes, IORING_OFF_CQ_RING);
+        sqeBytes = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(map(sqeBytes, IORING_OFF_SQES));
+        if (!sqRing || !cqRing || !sqes) {
+            release();
+            throw std::runtime_error(std::string("io_uring ring mapping failed: ") +
+                                     std::strerror(errno));
+        }
+
+        char* sq = static_cast<char*>(sqRing);
+        char* cq = static_cast<char*>(cqRing);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    ~UringEngine() override { release(); }
+
+    void submit(uint64_t tag, int fd, char* buffer, uint64_t offset, size_t length) override {
+        // Only this thread writes the tail, so a plain read of it is current
+        unsigned tail = *sqTail;
+        unsigned index = tail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer);
+        sqe->len = static_cast<unsigned>(length);
+        sqe->off = offset;
+        sqe->user_data = tag;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++unsubmitted;
+        ++running;
+    }
+
+    void flush() override {
+        while (unsubmitted > 0) {
+            enter(0);
+        }
+    }
+
+    void wait(std::vector<Completion>& done) override {
+        for (;;) {
+            reap(done);
+            if (!done.empty() && unsubmitted == 0) {
+                return;
+            }
+            enter(done.empty() ? 1 : 0);
+        }
+    }
+
+private:
+    void* map(size_t bytes, off_t offset) {
+        void* ring = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ringFd, offset);
+        return ring == MAP_FAILED ? nullptr : ring;
+    }
+
+    // Hand over queued requests and optionally wait for completions
+    void enter(unsigned minComplete) {
+        unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        long submitted = ::syscall(__NR_io_uring_enter, ringFd, unsubmitted, minComplete,
+                                   flags, nullptr, 0);
+        if (submitted < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                return;
+            }
+            throw std::runtime_error(std::string("io_uring_enter failed: ") +
+                                     std::strerror(errno));
+        }
+        unsubmitted -= static_cast<unsigned>(submitted);
+    }
+
+    void reap(std::vector<Completion>& done) {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes[head & cqMask];
+            done.push_back({cqe.user_data, static_cast<long>(cqe.res)});
+            --running;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    void release() {
+        if (sqes) {
+            ::munmap(sqes, sqeBytes);
+        }
+        if (cqRing && cqRing != sqRing) {
+            ::munmap(cqRing, cqBytes);
+        }
+        if (sqRing) {
+            ::munmap(sqRing, sqBytes);
+        }
+        if (ringFd >= 0) {
+            ::close(ringFd);
+        }
+        sqes = nullptr;
+        sqRing = cqRing = nullptr;
+        ringFd = -1;
+    }
+
+    int ringFd{-1};
+    void* sqRing{nullptr};
+    void* cqRing{nullptr};
+    size_t sqBytes{0};
+    size_t cqBytes{0};
+    size_t sqeBytes{0};
+    io_uring_sqe* sqes{nullptr};
+    unsigned* sqTail{nullptr};
+    unsigned* sqArray{nullptr};
+    unsigned sqMask{0};
+    unsigned* cqHead{nullptr};
+    unsigned* cqTail{nullptr};
+    unsigned cqMask{0};
+    io_uring_cqe* cqes{nullptr};
+    unsigned unsubmitted{0};
+};
+
+#endif // HAVE_IO_URING
+
+/**
+ * @class BatchReader::PreadEngine
+ * @brief Blocking pread() calls, one read per pool thread at a time
+ */
+class BatchReader::PreadEngine : public BatchReader::Engine {
+public:
+    explicit PreadEngine(size_t depth) : pool(depth) {}
+
+    void submit(uint64_t tag, int fd, char* buffer, uint64_t offset, size_t length) override {
+        ++running;
+        pool.submit([this, tag, fd, buffer, offset, length] {
+            // Loop over short reads so a completion covers the whole chunk
+            size_t total = 0;
+            long result = 0;
+            while (total < length) {
+                ssize_t got = ::pread(fd, buffer + total, length - total,
+                                      static_cast<off_t>(offset + total));
+                if (got < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (got <= 0) {
+                    result = got < 0 ? -errno : 0;
+                    break;
+                }
+                total += static_cast<size_t>(got);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.push_back({tag, total > 0 ? static_cast<long>(total) : result});
+            }
+            ready.notify_one();
+        });
+    }
+
+    void wait(std::vector<Completion>& done) override {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return !finished.empty(); });
+        running -= finished.size();
+        done.insert(done.end(), finished.begin(), finished.end());
+        finished.clear();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<Completion> finished;
+    ThreadPool pool;  // Last, so its workers stop before the members they use go
+};
+
+BatchReader::BatchReader(std::vector<std::string> files)
+    : BatchReader(std::move(files), Options()) {}
+
+BatchReader::BatchReader(std::vector<std::string> files, const Options& options)
+    : options(options), paths(std::move(files)) {
+    this->options.queueDepth = std::max<size_t>(this->options.queueDepth, 1);
+    this->options.chunkBytes = std::max<size_t>(this->options.chunkBytes, 4096);
+
+#ifdef HAVE_IO_URING
+    if (options.backend != Backend::Pread) {
+        try {
+            engine = std::make_unique<UringEngine>(this->options.queueDepth);
+            activeBackend = Backend::IoUring;
+        } catch (const std::runtime_error&) {
+            if (options.backend == Backend::IoUring) {
+                throw;
+            }
+        }
+    }
+#else
+    if (options.backend == Backend::IoUring) {
+        throw std::runtime_error("io_uring support was not built in");
+    }
+#endif
+    if (!engine) {
+        engine = std::make_unique<PreadEngine>(this->options.queueDepth);
+        activeBackend = Backend::Pread;
+    }
+}
+
+BatchReader::~BatchReader() {
+    // The kernel or a pool thread may still be writing into slot buffers
+    std::vector<Completion> done;
+    try {
+        while (engine->inFlight() > 0) {
+            engine->wait(done);
+        }
+    } catch (const std::exception&) {
+        // Nothing more can be done; the process is most likely exiting
+    }
+    for (Slot& slot : slots) {
+        if (slot.fd >= 0) {
+            ::close(slot.fd);
+        }
+        MemoryStats::charge(MemoryStats::Category::Lines, -static_cast<int64_t>(slot.size), -1);
+    }
+}
+
+bool BatchReader::next(File& file) {
+    if (firstSlot == paths.size()) {
+        return false;
+    }
+    Profiler::ScopedTimer timer(Profiler::Phase::FileRead);
+
+    auto submitPending = [this] {
+        while (!pending.empty() && engine->inFlight() < options.queueDepth) {
+            const Chunk& chunk = pending.front();
+            Slot& slot = slots[chunk.slot - firstSlot];
+            uint64_t tag;
+            if (freeTags.empty()) {
+                tag = submitted.size();
+                submitted.push_back(chunk);
+            } else {
+                tag = freeTags.back();
+                freeTags.pop_back();
+                submitted[tag] = chunk;
+            }
+            engine->submit(tag, slot.fd, slot.data.get() + chunk.offset, chunk.offset,
+                           chunk.length);
+            pending.pop_front();
+        }
+    };
+
+    openAhead();
+    submitPending();
+    std::vector<Completion> done;
+    while (slots.front().chunksLeft > 0) {
+        done.clear();
+        engine->wait(done);
+        for (const Completion& completion : done) {
+            freeTags.push_back(completion.tag);
+            complete(submitted[completion.tag], completion.result);
+        }
+        openAhead();
+        submitPending();
+    }
+
+    Slot slot = std::move(slots.front());
+    slots.pop_front();
+    ++firstSlot;
+    bufferedBytes -= slot.size;
+    MemoryStats::charge(MemoryStats::Category::Lines, -static_cast<int64_t>(slot.size), -1);
+
+    // Keep the queue full while the caller parses this file
+    openAhead();
+    submitPending();
+    engine->flush();
+
+    if (!slot.error.empty()) {
+        throw std::runtime_error(slot.error);
+    }
+    file.path = std::move(slot.path);
+    file.data = std::move(slot.data);
+    file.size = slot.size;
+    timer.addItems(1);
+    timer.addBytes(file.size);
+    return true;
+}
+
+void BatchReader::openAhead() {
+    // The file count bound keeps tiny files from using up descriptors
+    while (nextOpen < paths.size() &&
+           (slots.empty() || (bufferedBytes < options.maxBufferedBytes &&
+                              slots.size() < 4 * options.queueDepth))) {
+        Slot slot;
+        slot.path = paths[nextOpen];
+        slot.fd = ::open(slot.path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st {};
+        if (slot.fd < 0 || ::fstat(slot.fd, &st) != 0) {
+            slot.error = "Failed to open file: " + slot.path;
+        } else {
+            slot.size = static_cast<size_t>(st.st_size);
+            slot.data.reset(new char[std::max<size_t>(slot.size, 1)]);
+            for (uint64_t offset = 0; offset < slot.size; offset += options.chunkBytes) {
+                pending.push_back({nextOpen, offset,
+                                   std::min<size_t>(options.chunkBytes, slot.size - offset)});
+                ++slot.chunksLeft;
+            }
+        }
+        bufferedBytes += slot.size;
+        MemoryStats::charge(MemoryStats::Category::Lines, static_cast<int64_t>(slot.size), 1);
+        slots.push_back(std::move(slot));
+        if (slots.back().chunksLeft == 0) {
+            finishSlot(slots.back());
+        }
+        ++nextOpen;
+    }
+}
+
+void BatchReader::complete(const Chunk& chunk, long result) {
+    Slot& slot = slots[chunk.slot - firstSlot];
+    if (result == -EAGAIN || result == -EINTR) {
+        pending.push_front(chunk);
+        return;
+    }
+    if (result < 0) {
+        slot.error = "Failed to read file: " + slot.path + ": " + std::strerror(-result);
+    } else if (result == 0) {
+        // The file shrank after it was opened; keep what was there
+        size_t kept = std::min<size_t>(slot.size, chunk.offset);
+        bufferedBytes -= slot.size - kept;
+        slot.size = kept;
+    } else if (static_cast<size_t>(result) < chunk.length) {
+        // Short read: ask again for the rest
+        readBytes += static_cast<uint64_t>(result);
+        pending.push_front({chunk.slot, chunk.offset + static_cast<uint64_t>(result),
+                            chunk.length - static_cast<size_t>(result)});
+        return;
+    } else {
+        readBytes += static_cast<uint64_t>(result);
+    }
+    if (--slot.chunksLeft == 0) {
+        finishSlot(slot);
+    }
+}
+
+void BatchReader::finishSlot(Slot& slot) {
+    if (slot.fd >= 0) {
+        ::close(slot.fd);
+        slot.fd = -1;
+    }
+}
+
+bool BatchReader::ioUringAvailable() {
+#ifdef HAVE_IO_URING
+    static const bool available = [] {
+        try {
+            UringEngine probe(1);
+            return true;
+        } catch (const std::runtime_error&) {
+            return false;
+        }
+    }();
+    return available;
+#else
+    return false;
+#endif
+}
+
+const char* BatchReader::backendName(Backend backend) {
+    switch (backend) {
+        case Backend::IoUring:
+            return "uring";
+        case Backend::Pread:
+            return "pread";
+        default:
+            return "auto";
+    }
+}
+
+BatchReader::Backend BatchReader::parseBackend(const std::string& name) {
+    if (name == "auto") {
+        return Backend::Auto;
+    }
+    if (name == "uring") {
+        return Backend::IoUring;
+    }
+    if (name == "pread") {
+        return Backend::Pread;
+    }
+    throw std::runtime_error("Unknown I/O backend '" + name + "' (expected auto, uring or pread)");
+}
@@ -0,0 +1,166 @@
+/**
+ * @file batch_reader.h
+ * @brief Reads many report files with many reads in flight
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class BatchReader
+ * @brief Reads a list of files into memory ahead of the code that parses them
+ *
+ * Files are split into chunks and up to a queue depth of chunk reads are kept
+ * in flight at once, across as many files as that takes. Reads go through
+ * io_uring where the kernel supports it, so one thread keeps the whole queue
+ * busy; otherwise a pool of threads issues blocking pread() calls. next()
+ * hands files back whole and in the order they were listed, waiting only when
+ * the next file is not complete yet. Read-ahead stops once the buffered but
+ * undelivered files reach a byte limit, which bounds memory on large batches.
+ */
+class BatchReader {
+public:
+    /**
+     * @enum Backend
+     * @brief How reads are issued
+     */
+    enum class Backend {
+        Auto,     // io_uring when available, else Pread
+        IoUring,  // Asynchronous reads on an io_uring submission queue
+        Pread     // Blocking pread() calls on a thread pool
+    };
+
+    /**
+     * @struct Options
+     * @brief Read-ahead settings
+     */
+    struct Options {
+        Backend backend{Backend::Auto};
+        size_t queueDepth{64};                   // Chunk reads in flight at once
+        size_t chunkBytes{1 << 20};              // Bytes per read request
+        size_t maxBufferedBytes{256u << 20};     // Read-ahead limit
+    };
+
+    /**
+     * @struct File
+     * @brief One file's contents
+     */
+    struct File {
+        std::string path;
+        std::unique_ptr<char[]> data;
+        size_t size{0};
+    };
+
+    /**
+     * @brief Start reading files with the default settings
+     * @param files Files to read, in delivery order
+     */
+    explicit BatchReader(std::vector<std::string> files);
+
+    /**
+     * @brief Start reading files
+     * @param files Files to read, in delivery order
+     * @param options Read-ahead settings
+     * @throws std::runtime_error if io_uring is requested but unavailable
+     */
+    BatchReader(std::vector<std::string> files, const Options& options);
+
+    /**
+     * @brief Wait for reads still in flight and release the buffers
+     */
+    ~BatchReader();
+
+    BatchReader(const BatchReader&) = delete;
+    BatchReader& operator=(const BatchReader&) = delete;
+
+    /**
+     * @brief Get the next file in list order, waiting until it is read
+     * @param file Receives the path and contents
+     * @return False once every file has been delivered
+     * @throws std::runtime_error if the file cannot be opened or read
+     */
+    bool next(File& file);
+
+    /**
+     * @brief Get the backend in use; never Auto
+     * @return Backend
+     */
+    Backend backend() const { return activeBackend; }
+
+    /**
+     * @brief Get the bytes read so far
+     * @return Bytes read
+     */
+    uint64_t bytesRead() const { return readBytes; }
+
+    /**
+     * @brief Check whether this kernel can run the io_uring backend
+     * @return True if a ring with IORING_OP_READ can be set up
+     */
+    static bool ioUringAvailable();
+
+    /**
+     * @brief Name a backend as the --io-backend option spells it
+     * @param backend Backend
+     * @return "auto", "uring" or "pread"
+     */
+    static const char* backendName(Backend backend);
+
+    /**
+     * @brief Parse an --io-backend value
+     * @param name "auto", "uring" or "pread"
+     * @return Backend
+     * @throws std::runtime_error on any other name
+     */
+    static Backend parseBackend(const std::string& name);
+
+private:
+    // A file opened for reading and not yet delivered
+    struct Slot {
+        std::string path;
+        int fd{-1};
+        std::unique_ptr<char[]> data;
+        size_t size{0};
+        size_t chunksLeft{0};
+        std::string error;  // Set when the open or a read failed
+    };
+
+    // Part of a file; several chunks of one file may be in flight together
+    struct Chunk {
+        size_t slot;
+        uint64_t offset;
+        size_t length;
+    };
+
+    class Engine;
+    class UringEngine;
+    class PreadEngine;
+
+    // Open files ahead of delivery and queue their chunks
+    void openAhead();
+
+    // Account for a finished read; result is bytes read or -errno
+    void complete(const Chunk& chunk, long result);
+
+    // Close a slot's file once its last chunk is in
+    void finishSlot(Slot& slot);
+
+    Options options;
+    Backend activeBackend{Backend::Pread};
+    std::vector<std::string> paths;
+    std::deque<Slot> slots;         // Files nextOpen - slots.size() .. nextOpen - 1
+    std::deque<Chunk> pending;      // Chunks not submitted yet
+    std::vector<Chunk> submitted;   // Chunks in flight, indexed by request tag
+    std::vector<uint64_t> freeTags; // Entries of submitted that are free for reuse
+    size_t firstSlot{0};            // Index in paths of slots.front()
+    size_t nextOpen{0};
+    size_t bufferedBytes{0};
+    uint64_t readBytes{0};
+    std::unique_ptr<Engine> engine;
+};
@@ -0,0 +1,75 @@
+/**
+ * @file bitmap_index.cpp
+ * @brief Implementation of BitmapIndex
+ */
+
+#include "bitmap_index.h"
+#include <algorithm>
+
+BitmapIndex BitmapIndex::build(const PathIndex& index, uint32_t minPaths, ThreadPool& pool) {
+    BitmapIndex bitmapIndex;
+    bitmapIndex.slots.assign(index.nodeCount(), -1);
+
+    std::vector<uint32_t> selected;
+    for (uint32_t node = 0; node < index.nodeCount(); ++node) {
+        if (index.pathCount(node) > 0 && index.pathCount(node) >= minPaths) {
+            bitmapIndex.slots[node] = static_cast<int32_t>(selected.size());
+            selected.push_back(node);
+        }
+    }
+
+    // Every bitmap is independent, so workers fill disjoint slots
+    bitmapIndex.bitmaps.resize(selected.size());
+    pool.parallelFor(selected.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            bitmapIndex.bitmaps[i] = RoaringBitmap::fromSorted(index.pathsThrough(selected[i]));
+        }
+    });
+
+    return bitmapIndex;
+}
+
+const RoaringBitmap* BitmapIndex::find(uint32_t nodeId) const {
+    if (nodeId >= slots.size() || slots[nodeId] < 0) {
+        return nullptr;
+    }
+    return &bitmaps[static_cast<size_t>(slots[nodeId])];
+}
+
+RoaringBitmap BitmapIndex::bitmapFor(const PathIndex& index, uint32_t nodeId) const {
+    if (const RoaringBitmap* bitmap = find(nodeId)) {
+        return *bitmap;
+    }
+    return RoaringBitmap::fromSorted(index.pathsThrough(nodeId));
+}
+
+RoaringBitmap BitmapIndex::select(const PathIndex& index, const std::vector<uint32_t>& include,
+                                  const std::vector<uint32_t>& exclude, uint32_t pathCount) const {
+    // Intersect the rarest nodes first so intermediate results stay small
+    std::vector<uint32_t> ordered = include;
+    std::sort(ordered.begin(), ordered.end(), [&index](uint32_t a, uint32_t b) {
+        return index.pathCount(a) < index.pathCount(b);
+    });
+
+    RoaringBitmap result = ordered.empty() ? RoaringBitmap::range(pathCount)
+                                           : bitmapFor(index, ordered[0]);
+    for (size_t i = 1; i < ordered.size() && !result.empty(); ++i) {
+        const RoaringBitmap* bitmap = find(ordered[i]);
+        result = bitmap ? (result & *bitmap) : (result & bitmapFor(index, ordered[i]));
+    }
+
+    for (size_t i = 0; i < exclude.size() && !result.empty(); ++i) {
+        const RoaringBitmap* bitmap = find(exclude[i]);
+        result = bitmap ? andNot(result, *bitmap) : andNot(result, bitmapFor(index, exclude[i]));
+    }
+
+    return result;
+}
+
+size_t BitmapIndex::sizeInBytes() const {
+    size_t bytes = slots.capacity() * sizeof(int32_t);
+    for (const auto& bitmap : bitmaps) {
+        bytes += bitmap.sizeInBytes();
+    }
+    return bytes;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file bitmap_index.h
+ * @brief Defines BitmapIndex, compressed path bitmaps for frequently used nodes
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "path_index.h"
+#include "roaring.h"
+#include "thread_pool.h"
+
+/**
+ * @class BitmapIndex
+ * @brief Roaring bitmaps of path IDs for nodes on many paths
+ *
+ * Only nodes with at least a threshold number of paths get a bitmap, which
+ * keeps memory bounded; less common nodes are served from their PathIndex
+ * posting lists on demand. Multi-node queries ("through A and B but not C")
+ * combine the bitmaps with AND / ANDNOT.
+ */
+class BitmapIndex {
+public:
+    // Default minimum number of paths through a node before it gets a bitmap
+    static constexpr uint32_t kDefaultMinPaths = 1024;
+
+    BitmapIndex() = default;
+
+    /**
+     * @brief Build bitmaps for every node on at least minPaths paths
+     * @param index Posting lists to build from
+     * @param minPaths Path-count threshold for materializing a bitmap
+     * @param pool Workers the bitmaps are built on
+     * @return The built index
+     */
+    static BitmapIndex build(const PathIndex& index, uint32_t minPaths, ThreadPool& pool);
+
+    /**
+     * @brief Get the precomputed bitmap of a node
+     * @param nodeId Interned node ID
+     * @return Bitmap, or nullptr if the node is below the threshold
+     */
+    const RoaringBitmap* find(uint32_t nodeId) const;
+
+    /**
+     * @brief Select paths through every included node and none of the excluded ones
+     * @param index Posting lists for nodes without a bitmap
+     * @param include Node IDs every selected path must go through
+     * @param exclude Node IDs no selected path may go through
+     * @param pathCount Total number of paths, used when include is empty
+     * @return Selected path IDs
+     */
+    RoaringBitmap select(const PathIndex& index, const std::vector<uint32_t>& include,
+                         const std::vector<uint32_t>& exclude, uint32_t pathCount) const;
+
+    /**
+     * @brief Get the number of materialized bitmaps
+     * @return Bitmap count
+     */
+    size_t bitmapCount() const { return bitmaps.size(); }
+
+    /**
+     * @brief Get the memory held by the materialized bitmaps
+     * @return Bytes
+     */
+    size_t sizeInBytes() const;
+
+private:
+    /**
+     * @brief Get a node's bitmap, decoding its posting list if it has none
+     * @param index Posting lists
+     * @param nodeId Interned node ID
+     * @return The bitmap
+     */
+    RoaringBitmap bitmapFor(const PathIndex& index, uint32_t nodeId) const;
+
+    std::vector<int32_t> slots;            // Node ID -> position in bitmaps, or -1
+    std::vector<RoaringBitmap> bitmaps;
+};
@@ -0,0 +1,167 @@
+/**
+ * @file content_hash.cpp
+ * @brief Implementation of XXH64 and chunked file hashing
+ */
+
+#include "content_hash.h"
+#include "thread_pool.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t kPrime1 = 11400714785074694791ULL;
+constexpr uint64_t kPrime2 = 14029467366897019727ULL;
+constexpr uint64_t kPrime3 = 1609587929392839161ULL;
+constexpr uint64_t kPrime4 = 9650029242287828579ULL;
+constexpr uint64_t kPrime5 = 2870177450012600261ULL;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// Little-endian loads; memcpy keeps unaligned reads well-defined
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t mixRound(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value) {
+    acc ^= mixRound(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+} // namespace
+
+namespace ContentHash {
+
+uint64_t xxh64(const void* data, size_t length, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + length;
+    uint64_t h;
+
+    if (length >= 32) {
+        // Four independent lanes over 32-byte stripes
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = mixRound(v1, read64(p));
+            v2 = mixRound(v2, read64(p + 8));
+            v3 = mixRound(v3, read64(p + 16));
+            v4 = mixRound(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + kPrime5;
+    }
+    h += static_cast<uint64_t>(length);
+
+    // Tail: 8, then 4, then single bytes
+    for (; p + 8 <= end; p += 8) {
+        h ^= mixRound(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= (*p) * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t hashFile(const std::string& filename, ThreadPool& pool, size_t chunkBytes) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file: " + filename);
+    }
+    size_t bytes = static_cast<size_t>(st.st_size);
+    if (bytes == 0) {
+        ::close(fd);
+        return xxh64(nullptr, 0, 0);
+    }
+    void* data = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+    ::madvise(data, bytes, MADV_SEQUENTIAL);
+
+    uint64_t hash;
+    try {
+        hash = hashBuffer(data, bytes, pool, chunkBytes);
+    } catch (...) {
+        ::munmap(data, bytes);
+        throw;
+    }
+    ::munmap(data, bytes);
+    return hash;
+}
+
+uint64_t hashBuffer(const void* data, size_t bytes, ThreadPool& pool, size_t chunkBytes) {
+    if (bytes == 0) {
+        return xxh64(nullptr, 0, 0);
+    }
+    const unsigned char* base = static_cast<const unsigned char*>(data);
+    size_t chunks = (bytes + chunkBytes - 1) / chunkBytes;
+    std::vector<uint64_t> chunkHashes(chunks);
+    pool.parallelFor(chunks, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            size_t offset = c * chunkBytes;
+            chunkHashes[c] = xxh64(base + offset, std::min(chunkBytes, bytes - offset), 0);
+        }
+    });
+
+    return xxh64(chunkHashes.data(), chunkHashes.size() * sizeof(uint64_t),
+                 static_cast<uint64_t>(bytes));
+}
+
+std::string toHex(uint64_t hash) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash));
+    return text;
+}
+
+} // namespace ContentHash
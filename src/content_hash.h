@@ -0,0 +1,66 @@
+/**
+ * @file content_hash.h
+ * @brief Fast 64-bit content hashes of report files
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class ThreadPool;
+
+/**
+ * @namespace ContentHash
+ * @brief XXH64 hashing of memory and of whole files
+ *
+ * hashFile() splits a file into fixed-size chunks, hashes the chunks in
+ * parallel and then hashes the list of chunk hashes seeded with the file
+ * size. The chunk size is fixed, so the result does not depend on the number
+ * of workers.
+ */
+namespace ContentHash {
+
+// Bytes per independently hashed chunk of a file
+constexpr size_t kChunkBytes = 1 << 20;
+
+/**
+ * @brief Hash a block of memory
+ * @param data First byte
+ * @param length Number of bytes
+ * @param seed Hash seed
+ * @return XXH64 of the bytes
+ */
+uint64_t xxh64(const void* data, size_t length, uint64_t seed = 0);
+
+/**
+ * @brief Hash the contents of a file
+ * @param filename File path
+ * @param pool Workers that hash the chunks
+ * @param chunkBytes Bytes per chunk
+ * @return 64-bit content hash
+ * @throws std::runtime_error if the file cannot be read
+ */
+uint64_t hashFile(const std::string& filename, ThreadPool& pool,
+                  size_t chunkBytes = kChunkBytes);
+
+/**
+ * @brief Hash file contents already in memory; equals hashFile() of that file
+ * @param data File contents
+ * @param bytes Size of the contents
+ * @param pool Workers that hash the chunks
+ * @param chunkBytes Bytes per chunk
+ * @return 64-bit content hash
+ */
+uint64_t hashBuffer(const void* data, size_t bytes, ThreadPool& pool,
+                    size_t chunkBytes = kChunkBytes);
+
+/**
+ * @brief Format a hash as 16 lowercase hex digits
+ * @param hash Hash value
+ * @return Hex string
+ */
+std::string toHex(uint64_t hash);
+
+} // namespace ContentHash
@@ -0,0 +1,218 @@
+/**
+ * @file group_rank.cpp
+ * @brief Implementation of PathGrouping
+ */
+
+#include "group_rank.h"
+#include "profiler.h"
+#include "trace.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * @class GroupTable
+ * @brief Flat open-addressing map from group ID to the group's bounded heap
+ *
+ * Slots hold 1-based positions into dense key and heap arrays, so probing
+ * touches one small array and iterating the groups touches no empty slots.
+ * Heaps start empty and grow with their group, so a group holding one path
+ * costs one entry whatever the per-group limit.
+ */
+class GroupTable {
+public:
+    explicit GroupTable(size_t perGroup) : perGroup(perGroup), slots(16, 0) {}
+
+    TopKHeap& heapFor(uint32_t group) {
+        size_t mask = slots.size() - 1;
+        size_t slot = hash(group) & mask;
+        while (slots[slot] != 0) {
+            size_t position = slots[slot] - 1;
+            if (keys[position] == group) {
+                return heaps[position];
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        keys.push_back(group);
+        heaps.emplace_back(perGroup);
+        slots[slot] = static_cast<uint32_t>(keys.size());
+        if (keys.size() * 2 > slots.size()) {
+            grow();
+        }
+        return heaps.back();
+    }
+
+    size_t size() const { return keys.size(); }
+    uint32_t key(size_t position) const { return keys[position]; }
+    const TopKHeap& heap(size_t position) const { return heaps[position]; }
+
+private:
+    static size_t hash(uint32_t group) {
+        return static_cast<size_t>((group * 0x9E3779B97F4A7C15ull) >> 29);
+    }
+
+    // Double the slots and reinsert; keys and heaps stay where they are
+    void grow() {
+        std::vector<uint32_t> larger(slots.size() * 2, 0);
+        size_t mask = larger.size() - 1;
+        for (size_t position = 0; position < keys.size(); ++position) {
+            size_t slot = hash(keys[position]) & mask;
+            while (larger[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            larger[slot] = static_cast<uint32_t>(position + 1);
+        }
+        slots.swap(larger);
+    }
+
+    size_t perGroup;
+    std::vector<uint32_t> slots;
+    std::vector<uint32_t> keys;
+    std::vector<TopKHeap> heaps;
+};
+
+// Offer a slice of rows to their groups' heaps, scored by one key
+template <typename Key>
+void groupRows(GroupTable& table, const PathGrouping& grouping, const PathColumns& columns,
+               const uint32_t* first, const uint32_t* last) {
+    for (; first != last; ++first) {
+        table.heapFor(grouping.groupOf(columns, *first)).offer(Key::score(columns, *first), *first);
+    }
+}
+
+void groupSlice(RankKey key, GroupTable& table, const PathGrouping& grouping,
+                const PathColumns& columns, const uint32_t* first, const uint32_t* last) {
+    switch (key) {
+        case RankKey::Delay:
+            groupRows<RankKeys::Delay>(table, grouping, columns, first, last);
+            break;
+        case RankKey::Slack:
+            groupRows<RankKeys::Slack>(table, grouping, columns, first, last);
+            break;
+        case RankKey::WorstStage:
+            groupRows<RankKeys::WorstStage>(table, grouping, columns, first, last);
+            break;
+        case RankKey::Stages:
+            groupRows<RankKeys::Stages>(table, grouping, columns, first, last);
+            break;
+        case RankKey::NetDelayShare:
+            groupRows<RankKeys::NetDelayShare>(table, grouping, columns, first, last);
+            break;
+    }
+}
+
+// Slices smaller than this are grouped faster than they are merged
+constexpr size_t kMinRowsPerWorker = size_t(1) << 16;
+
+} // namespace
+
+PathGrouping PathGrouping::parse(const std::string& spec) {
+    PathGrouping grouping;
+    static const std::string prefix = "prefix:";
+    if (spec == "endpoint") {
+        grouping.by = By::Endpoint;
+    } else if (spec == "startpoint") {
+        grouping.by = By::Startpoint;
+    } else if (spec.compare(0, prefix.size(), prefix) == 0 && spec.size() > prefix.size() &&
+               spec.find_first_not_of("0123456789", prefix.size()) == std::string::npos &&
+               std::stoul(spec.substr(prefix.size())) >= 1) {
+        grouping.by = By::Prefix;
+        grouping.levels = static_cast<unsigned>(std::stoul(spec.substr(prefix.size())));
+    } else {
+        throw std::runtime_error("Unknown grouping: " + spec +
+                                 " (expected endpoint, startpoint or prefix:N)");
+    }
+    return grouping;
+}
+
+void PathGrouping::resolve(const TimingParser& parser) {
+    if (by != By::Prefix) {
+        return;
+    }
+
+    // Names sharing their first levels share a group, e.g. u_core/u_alu for
+    // u_core/u_alu/r5/D at prefix:2; shallower names are their own group
+    std::unordered_map<std::string, uint32_t> groups;
+    prefixGroups.assign(parser.nodeCount(), 0);
+    for (uint32_t id = 0; id < parser.nodeCount(); ++id) {
+        const std::string& name = parser.nodeName(id);
+        size_t end = 0;
+        for (unsigned level = 0; level < levels && end != std::string::npos; ++level) {
+            end = name.find('/', level == 0 ? 0 : end + 1);
+        }
+        auto inserted = groups.emplace(name.substr(0, end), static_cast<uint32_t>(groups.size()));
+        prefixGroups[id] = inserted.first->second;
+    }
+}
+
+std::vector<uint32_t> PathGrouping::selectTop(const PathColumns& columns,
+                                              const std::vector<uint32_t>& candidates, int topK,
+                                              RankKey key, size_t perGroup, ThreadPool& pool) {
+    Profiler::ScopedTimer timer(Profiler::Phase::Rank);
+    Trace::Span span("rank", "phase");
+    timer.addItems(candidates.size());
+
+    // No group can keep more rows than there are candidates
+    perGroup = std::min(perGroup, candidates.size());
+    GroupTable merged(perGroup);
+    size_t workers = std::min(pool.size(), candidates.size() / kMinRowsPerWorker);
+    if (workers <= 1) {
+        groupSlice(key, merged, *this, columns, candidates.data(),
+                   candidates.data() + candidates.size());
+    } else {
+        // Each worker groups its own slice into its own table; the tables are
+        // merged afterwards, so workers never share a heap
+        std::vector<GroupTable> locals(workers, GroupTable(perGroup));
+        for (size_t w = 0; w < workers; ++w) {
+            size_t begin = candidates.size() * w / workers;
+            size_t end = candidates.size() * (w + 1) / workers;
+            pool.submit([&, w, begin, end] {
+                Trace::Span chunk("group", "pool");
+                chunk.setRange(begin, end);
+                groupSlice(key, locals[w], *this, columns, candidates.data() + begin,
+                           candidates.data() + end);
+            });
+        }
+        pool.wait();
+
+        for (const auto& local : locals) {
+            for (size_t position = 0; position < local.size(); ++position) {
+                TopKHeap& heap = merged.heapFor(local.key(position));
+                for (const auto& entry : local.heap(position).entries()) {
+                    heap.offer(entry.score, entry.row);
+                }
+            }
+        }
+    }
+    groupCount = merged.size();
+
+    // The overall top K comes from the survivors of every group
+    std::vector<ScoredRow> kept;
+    for (size_t position = 0; position < merged.size(); ++position) {
+        const auto& entries = merged.heap(position).entries();
+        kept.insert(kept.end(), entries.begin(), entries.end());
+    }
+    size_t count = std::min(kept.size(), static_cast<size_t>(std::max(topK, 0)));
+    std::partial_sort(kept.begin(), kept.begin() + count, kept.end(), moreCritical);
+
+    std::vector<uint32_t> ranked(count);
+    for (size_t i = 0; i < count; ++i) {
+        ranked[i] = kept[i].row;
+    }
+    return ranked;
+}
+
+std::string PathGrouping::describe() const {
+    switch (by) {
+        case By::Startpoint:
+            return "startpoint";
+        case By::Prefix:
+            return "prefix:" + std::to_string(levels);
+        case By::Endpoint:
+            break;
+    }
+    return "endpoint";
+}
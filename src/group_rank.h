@@ -0,0 +1,102 @@
+/**
+ * @file group_rank.h
+ * @brief Defines PathGrouping, the per-group top-K ranking behind --group-by
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "parser.h"
+#include "path_columns.h"
+#include "rank_key.h"
+#include "thread_pool.h"
+
+/**
+ * @class PathGrouping
+ * @brief Groups paths by endpoint, startpoint or endpoint hierarchy prefix
+ *
+ * selectTop() ranks like report_timing -max_paths / -nworst: the most
+ * critical paths overall, but never more than a fixed number from one group.
+ * Each group keeps a bounded heap, so memory grows with groups times the
+ * per-group limit rather than with the number of paths.
+ */
+class PathGrouping {
+public:
+    /**
+     * @enum By
+     * @brief What a group shares
+     */
+    enum class By {
+        Endpoint,
+        Startpoint,
+        Prefix    // The first N '/'-separated levels of the endpoint name
+    };
+
+    /**
+     * @brief Parse a --group-by argument
+     * @param spec endpoint, startpoint or prefix:N with N >= 1
+     * @return The grouping
+     * @throws std::runtime_error for anything else
+     */
+    static PathGrouping parse(const std::string& spec);
+
+    /**
+     * @brief Map the parser's node IDs to hierarchy prefix groups
+     * @param parser Parser that interned the endpoints
+     *
+     * Needed for By::Prefix once parsing is done; a no-op otherwise.
+     */
+    void resolve(const TimingParser& parser);
+
+    /**
+     * @brief Get the group of a row
+     * @param columns Columns of the paths
+     * @param row Row
+     * @return Group ID: a node ID, or a prefix ID after resolve()
+     */
+    uint32_t groupOf(const PathColumns& columns, uint32_t row) const {
+        switch (by) {
+            case By::Startpoint:
+                return columns.startId[row];
+            case By::Prefix:
+                return prefixGroups[columns.endId[row]];
+            case By::Endpoint:
+                break;
+        }
+        return columns.endId[row];
+    }
+
+    /**
+     * @brief Select the top K rows with at most perGroup rows from any group
+     * @param columns Columns of the paths
+     * @param candidates Rows to rank
+     * @param topK Number of rows to keep in total
+     * @param key Ranking key
+     * @param perGroup Most rows kept from one group
+     * @param pool Workers that group disjoint slices of the candidates
+     * @return Selected rows, most critical first; ties keep row order
+     */
+    std::vector<uint32_t> selectTop(const PathColumns& columns,
+                                    const std::vector<uint32_t>& candidates, int topK,
+                                    RankKey key, size_t perGroup, ThreadPool& pool);
+
+    /**
+     * @brief Name the grouping as --group-by spells it
+     * @return e.g. "endpoint" or "prefix:2"
+     */
+    std::string describe() const;
+
+    /**
+     * @brief Get the number of groups found by the last selectTop()
+     * @return Group count
+     */
+    size_t lastGroupCount() const { return groupCount; }
+
+private:
+    By by{By::Endpoint};
+    unsigned levels{0};                   // Prefix depth for By::Prefix
+    std::vector<uint32_t> prefixGroups;   // Prefix group of each node ID
+    size_t groupCount{0};                 // Groups seen by the last selectTop()
+};
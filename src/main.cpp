@@ -23,17 +23,96 @@
 #endif
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 #include "parser.h"
 #include "analyzer.h"
+#include "batch_reader.h"
+#include "bitmap_index.h"
+#include "group_rank.h"
+#include "mem_stats.h"
+#include "offset_index.h"
+#include "profiler.h"
+#include "query.h"
+#include "report_follower.h"
+#include "result_cache.h"
+#include "server.h"
+#include "thread_pool.h"
+#include "trace.h"
 #include "utils.h"
 
+// Server or follower to stop on SIGINT/SIGTERM with --serve or --follow
+static TimingServer* activeServer = nullptr;
+static ReportFollower* activeFollower = nullptr;
+
+static void handleStopSignal(int) {
+    if (activeServer) {
+        activeServer->stop();
+    }
+    if (activeFollower) {
+        activeFollower->stop();
+    }
+}
+
 void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " [OPTIONS]\n"
               << "Options:\n"
               << "  -f, --file PATH       Input timing report file path\n"
               << "  -d, --dir PATH        Directory containing timing reports\n"
               << "  -o, --output PATH     Output analysis results to file\n"
-              << "  -k, --topk N          Number of critical paths to show (default: 10)\n"
+              << "  -k, --topk N          Number of critical paths to show (default: 10);\n"
+              << "                        'all' ranks every path\n"
+              << "  --through NODE        Only show paths with a stage through NODE; repeat to\n"
+              << "                        require several nodes\n"
+              << "  --not-through NODE    Drop paths with a stage through NODE (repeatable)\n"
+              << "  --bitmap-threshold N  Build path bitmaps for nodes on at least N paths when\n"
+              << "                        combining nodes (default: 1024)\n"
+              << "  --where EXPR          Only show paths matching a filter expression, e.g.\n"
+              << "                        'delay > 4.5 and stages >= 6 and endpoint ~ \"FF*_D\"'\n"
+              << "  --serve SOCKET        Keep the parsed report resident and answer queries\n"
+              << "                        on a Unix domain socket\n"
+              << "  --profile             Print wall time, CPU time and throughput per phase\n"
+              << "                        to stderr\n"
+              << "  --mem-stats           Print memory used per data structure, peak RSS and\n"
+              << "                        bytes per path to stderr\n"
+              << "  --trace PATH          Write file, phase and worker spans as a Chrome trace\n"
+              << "                        (open in Perfetto or chrome://tracing)\n"
+              << "  --min-delay X         Skip paths with a total delay below X ns while parsing\n"
+              << "  --min-slack S         Skip paths with more than S ns of slack against the\n"
+              << "                        report's Clock Period while parsing\n"
+              << "  --build-index         Write a PATH.idx sidecar mapping path IDs to their\n"
+              << "                        byte ranges in the report given with -f\n"
+              << "  --path ID             Print one path using the sidecar index instead of\n"
+              << "                        parsing the report (repeatable)\n"
+              << "  --cache-dir DIR       Keep each report's top-K paths in DIR, keyed by a\n"
+              << "                        content hash, and reuse them while it is unchanged\n"
+              << "  --follow              Tail a report that is still being written and refresh\n"
+              << "                        the top K as paths complete (needs -f)\n"
+              << "  --interval SEC        Seconds between --follow refreshes (default: 2)\n"
+              << "  --parse-threads N     Tokenizer threads for full parses (filtered runs);\n"
+              << "                        0 parses serially (default: one per core)\n"
+              << "  --io-backend NAME     How -d reads reports: auto, uring or pread\n"
+              << "                        (default: auto, io_uring when the kernel has it)\n"
+              << "  --io-depth N          Reads kept in flight across reports (default: 64)\n"
+              << "  --rank-by KEYS        Rank paths by delay, slack, worst-stage, stages or\n"
+              << "                        net-share (default: delay); several comma-separated\n"
+              << "                        or repeated keys print one section each\n"
+              << "  --group-by SPEC       Rank with at most --per-group paths per endpoint,\n"
+              << "                        startpoint or prefix:N (first N levels of the\n"
+              << "                        endpoint's hierarchy)\n"
+              << "  --per-group K         Most paths shown per --group-by group (default: 1)\n"
+              << "  --rank-range A:B      Show the paths ranked A to B (1-based, inclusive)\n"
+              << "                        instead of the top K\n"
+              << "  --unique-endpoints    Keep only the worst path to each endpoint while\n"
+              << "                        parsing\n"
               << "  -h, --help            Show this help message\n";
 }
 
@@ -42,7 +121,32 @@ int main(int argc, char* argv[]) {
     std::string inputFile;
     std::string inputDir;
     std::string outputFile;
+    std::string socketPath;
+    std::string traceFile;
+    std::string cacheDir;
+    std::vector<std::string> throughNodes;
+    std::vector<std::string> avoidNodes;
+    uint32_t bitmapThreshold = BitmapIndex::kDefaultMinPaths;
+    size_t parseThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::string whereClause;
+    std::string rankBy;  // Comma-separated keys from every --rank-by
+    std::string groupBy;
+    size_t perGroup = 1;
+    bool uniqueEndpoints = false;
     int topK = 10;
+    bool rankAll = false;  // -k all
+    std::string rankRange;
+    double minDelay = -std::numeric_limits<double>::infinity();
+    double minSlack = 0.0;
+    bool haveMinSlack = false;
+    bool profile = false;
+    bool memStats = false;
+    bool buildIndex = false;
+    bool follow = false;
+    double refreshSeconds = 2.0;
+    std::string ioBackend = "auto";
+    size_t ioDepth = BatchReader::Options().queueDepth;
+    std::vector<std::string> lookupIds;
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -57,7 +161,56 @@ int main(int argc, char* argv[]) {
         } else if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
             outputFile = argv[++i];
         } else if ((arg == "-k" || arg == "--topk") && i + 1 < argc) {
-            topK = std::stoi(argv[++i]);
+            std::string count = argv[++i];
+            rankAll = count == "all";
+            topK = rankAll ? std::numeric_limits<int>::max() : std::stoi(count);
+        } else if (arg == "--group-by" && i + 1 < argc) {
+            groupBy = argv[++i];
+        } else if (arg == "--per-group" && i + 1 < argc) {
+            perGroup = std::stoul(argv[++i]);
+        } else if (arg == "--rank-range" && i + 1 < argc) {
+            rankRange = argv[++i];
+        } else if (arg == "--unique-endpoints") {
+            uniqueEndpoints = true;
+        } else if (arg == "--rank-by" && i + 1 < argc) {
+            rankBy += (rankBy.empty() ? "" : ",") + std::string(argv[++i]);
+        } else if (arg == "--min-delay" && i + 1 < argc) {
+            minDelay = std::stod(argv[++i]);
+        } else if (arg == "--min-slack" && i + 1 < argc) {
+            minSlack = std::stod(argv[++i]);
+            haveMinSlack = true;
+        } else if (arg == "--through" && i + 1 < argc) {
+            throughNodes.push_back(argv[++i]);
+        } else if (arg == "--not-through" && i + 1 < argc) {
+            avoidNodes.push_back(argv[++i]);
+        } else if (arg == "--bitmap-threshold" && i + 1 < argc) {
+            bitmapThreshold = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--where" && i + 1 < argc) {
+            whereClause = argv[++i];
+        } else if (arg == "--parse-threads" && i + 1 < argc) {
+            parseThreads = std::stoul(argv[++i]);
+        } else if (arg == "--serve" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (arg == "--profile") {
+            profile = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            traceFile = argv[++i];
+        } else if (arg == "--mem-stats") {
+            memStats = true;
+        } else if (arg == "--build-index") {
+            buildIndex = true;
+        } else if (arg == "--path" && i + 1 < argc) {
+            lookupIds.push_back(argv[++i]);
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            cacheDir = argv[++i];
+        } else if (arg == "--follow") {
+            follow = true;
+        } else if (arg == "--interval" && i + 1 < argc) {
+            refreshSeconds = std::stod(argv[++i]);
+        } else if (arg == "--io-backend" && i + 1 < argc) {
+            ioBackend = argv[++i];
+        } else if (arg == "--io-depth" && i + 1 < argc) {
+            ioDepth = std::stoul(argv[++i]);
         } else {
             std::cerr << "Unknown argument: " << arg << std::endl;
             printUsage(argv[0]);
@@ -71,46 +224,486 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    if ((buildIndex || !lookupIds.empty()) && inputFile.empty()) {
+        std::cerr << "Error: --build-index and --path need a report file (-f)\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    if (follow && (inputFile.empty() || !whereClause.empty() || !throughNodes.empty() ||
+                   !avoidNodes.empty() || !socketPath.empty())) {
+        std::cerr << "Error: --follow needs a report file (-f) and no filters or --serve\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    if (((!rankBy.empty() && rankBy != "delay") || !groupBy.empty() || uniqueEndpoints ||
+         rankAll || !rankRange.empty()) &&
+        (follow || !socketPath.empty())) {
+        std::cerr << "Error: --follow and --serve rank by delay only, without --group-by, "
+                  << "--unique-endpoints, --rank-range or -k all\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    if (!rankRange.empty() && !groupBy.empty()) {
+        std::cerr << "Error: --rank-range cannot be combined with --group-by\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    Profiler::setEnabled(profile);
+    if (!traceFile.empty()) {
+        Trace::start();
+    }
+    
+    // Every mode, including --path and --build-index, ends here
+    auto finish = [&](int status) {
+        if (!traceFile.empty()) {
+            Trace::stop();
+            Trace::writeFile(traceFile);
+            std::cerr << "Trace written to " << traceFile << std::endl;
+        }
+        
+        if (profile) {
+            std::cerr << Profiler::report();
+        }
+        return status;
+    };
+    
     try {
-        if (!inputFile.empty()) {
-            // Process single file
-            std::cout << "Processing timing report: " << inputFile << std::endl;
+        if (buildIndex) {
+            Profiler::ScopedTimer timer(Profiler::Phase::Index);
+            Trace::Span span("build index", "phase");
+            size_t indexed = OffsetIndex::build(inputFile);
+            timer.addItems(indexed);
+            std::cout << "Indexed " << indexed << " paths into "
+                      << OffsetIndex::sidecarPath(inputFile) << std::endl;
+        }
+        
+        if (!lookupIds.empty()) {
+            int status = 0;
+            {
+                // Parse only the requested sections of the mapped report
+                Profiler::ScopedTimer timer(Profiler::Phase::Parse);
+                Trace::Span span("lookup", "phase");
+                timer.addItems(lookupIds.size());
+                auto index = OffsetIndex::open(inputFile);
+                TimingParser parser;
+                TimingAnalyzer analyzer;
+                
+                for (size_t i = 0; i < lookupIds.size(); ++i) {
+                    auto section = index.find(lookupIds[i]);
+                    if (!section) {
+                        std::cerr << "Error: Path " << lookupIds[i] << " is not in the index\n";
+                        status = 1;
+                        continue;
+                    }
+                
+                    auto path = parser.parseSection(std::string(*section));
+                    std::cout << Utils::formatPathResult(static_cast<int>(i + 1),
+                                                         analyzer.analyzePath(path)) << "\n";
+                    for (const auto& edge : path.edges) {
+                        std::cout << "    " << edge->from->name << " → " << edge->to->name << "  "
+                                  << std::fixed << std::setprecision(3) << edge->delay << " ns\n";
+                    }
+                }
+            }
+            return finish(status);
+        }
+        
+        if (buildIndex) {
+            return finish(0);
+        }
+        
+        // Compile the filter up front so syntax errors surface before parsing
+        PathQuery query;
+        if (!whereClause.empty()) {
+            query = PathQuery::compile(whereClause);
+        }
+        auto rankKeys = RankKeys::parseList(rankBy.empty() ? "delay" : rankBy);
+        bool rankByDelay = rankKeys == std::vector<RankKey>{RankKey::Delay};
+        bool grouped = !groupBy.empty();
+        PathGrouping grouping;
+        if (grouped) {
+            grouping = PathGrouping::parse(groupBy);
+            if (perGroup == 0) {
+                throw std::runtime_error("--per-group must be at least 1");
+            }
+        }
+        
+        // --rank-range A:B keeps zero-based ranks rangeFirst .. rangeLast - 1
+        bool ranged = !rankRange.empty();
+        size_t rangeFirst = 0;
+        size_t rangeLast = 0;
+        if (ranged) {
+            size_t colon = rankRange.find(':');
+            bool digits = colon != std::string::npos && colon > 0 && colon + 1 < rankRange.size() &&
+                          rankRange.find_first_not_of("0123456789:") == std::string::npos &&
+                          rankRange.find(':', colon + 1) == std::string::npos;
+            bool valid = digits;
+            if (digits) {
+                try {
+                    rangeFirst = std::stoul(rankRange.substr(0, colon));
+                    rangeLast = std::stoul(rankRange.substr(colon + 1));
+                } catch (const std::out_of_range&) {
+                    valid = false;  // Ranks past what size_t holds
+                }
+            }
+            if (!valid || rangeFirst == 0 || rangeLast < rangeFirst) {
+                throw std::runtime_error("Invalid rank range: " + rankRange +
+                                         " (expected A:B with 1 <= A <= B)");
+            }
+            --rangeFirst;
+        }
+        BatchReader::Options ioOptions;
+        ioOptions.backend = BatchReader::parseBackend(ioBackend);
+        ioOptions.queueDepth = ioDepth;
+        
+        if (follow) {
+            // Refresh the top K of the completed paths until the trailer or a signal
+            std::cout << "Following timing report: " << inputFile << std::endl;
+            ReportFollower follower(inputFile, topK);
+            activeFollower = &follower;
+            std::signal(SIGINT, handleStopSignal);
+            std::signal(SIGTERM, handleStopSignal);
+            
+            TimingAnalyzer analyzer;
+            auto interval = std::chrono::milliseconds(static_cast<int64_t>(refreshSeconds * 1000));
+            follower.follow(interval, [&]() {
+                std::cout << "\n[" << follower.pathCount() << " paths, checkpoint at byte "
+                          << follower.checkpoint()
+                          << (follower.finished() ? ", report complete]" : "]") << std::endl;
+                Utils::printResults(analyzer.findCriticalPaths(follower.topPaths(), topK),
+                                    outputFile);
+            });
+            activeFollower = nullptr;
+            
+            if (memStats) {
+                std::cerr << MemoryStats::report(follower.pathCount());
+            }
+            
+        } else if (!socketPath.empty()) {
+            // Parse once, then answer queries until interrupted
+            const std::string& source = inputFile.empty() ? inputDir : inputFile;
+            std::cout << "Loading timing reports: " << source << std::endl;
+            
+            TimingServer server(source, topK);
+            activeServer = &server;
+            std::signal(SIGINT, handleStopSignal);
+            std::signal(SIGTERM, handleStopSignal);
+            
+            std::cout << "Serving queries on " << socketPath << std::endl;
+            server.serve(socketPath);
+            activeServer = nullptr;
             
-            // Parse the timing report
+            if (memStats) {
+                // Every resident path is one live TimingPath
+                auto paths = MemoryStats::usage(MemoryStats::Category::Paths).objects;
+                std::cerr << MemoryStats::report(static_cast<uint64_t>(paths));
+            }
+            
+        } else {
             TimingParser parser;
-            auto timingPaths = parser.parseFile(inputFile);
+            std::vector<TimingPath> timingPaths;
             
-            // Analyze the timing paths
+            bool nodeFilter = !throughNodes.empty() || !avoidNodes.empty();
+            
+            // Filters and keys other than delay look at the stages of every
+            // path; a plain top-K run scans headers first and parses stages
+            // only for the paths it prints
+            bool lazy = whereClause.empty() && !nodeFilter && rankByDelay;
+            std::vector<PathExtent> extents;
+            parser.setMinDelay(minDelay);
+            parser.setParseThreads(parseThreads);
+            parser.setUniqueEndpoints(uniqueEndpoints);
+            if (haveMinSlack) {
+                parser.setMinSlack(minSlack);
+            }
+            
+            // The running cutoff would count paths that are later replaced
+            // at their endpoint, so it only applies to plain runs
+            bool plain = lazy && !grouped && !uniqueEndpoints && !ranged;
+            
+            // -k all keeps every path, so it has no cutoff; 0 turns it off
+            size_t cutoff = rankAll ? 0 : static_cast<size_t>(std::max(topK, 0));
+            if (plain) {
+                // Every kept path competes for the same top K
+                parser.setTopKCutoff(cutoff);
+            }
+            
+            // Only plain top-K runs are cached; filters need every path's stages
+            std::unique_ptr<ResultCache> cache;
+            std::unique_ptr<ThreadPool> hashPool;
             TimingAnalyzer analyzer;
-            auto criticalPaths = analyzer.findCriticalPaths(timingPaths, topK);
+            if (!cacheDir.empty() && !plain) {
+                std::cerr << "Warning: --cache-dir is ignored with --where, --through, "
+                          << "--not-through, --rank-by, --group-by, --rank-range and "
+                          << "--unique-endpoints" << std::endl;
+            } else if (!cacheDir.empty()) {
+                std::ostringstream settings;
+                settings << "topk=" << (rankAll ? "all" : std::to_string(cutoff))
+                         << " min-delay=" << minDelay << " min-slack=";
+                if (haveMinSlack) {
+                    settings << minSlack;
+                } else {
+                    settings << "none";
+                }
+                cache = std::make_unique<ResultCache>(cacheDir, settings.str());
+                hashPool = std::make_unique<ThreadPool>();
+            }
             
-            // Generate and display results
-            Utils::printResults(criticalPaths, outputFile);
+            // contents is the report already read into memory, or null to read it here
+            auto readReport = [&](const std::string& filename,
+                                  const BatchReader::File* contents) {
+                if (!lazy) {
+                    return contents ? parser.parseBuffer(filename, contents->data.get(),
+                                                         contents->size)
+                                    : parser.parseFile(filename);
+                }
+                auto scan = [&] {
+                    return contents ? parser.scanBuffer(filename, contents->data.get(),
+                                                        contents->size, extents)
+                                    : parser.scanFile(filename, extents);
+                };
+                if (!cache) {
+                    return scan();
+                }
+                
+                // A cached report must hold its own top K, not just the paths
+                // that beat earlier reports, so the cutoff restarts per report
+                parser.setTopKCutoff(cutoff);
+                auto entry = contents ? cache->lookup(contents->data.get(), contents->size,
+                                                      *hashPool)
+                                      : cache->lookup(filename, *hashPool);
+                if (entry.hit) {
+                    return parser.scanFile(entry.path, extents);
+                }
+                
+                size_t first = extents.size();
+                auto paths = scan();
+                std::vector<PathExtent> reportExtents(extents.begin() + first, extents.end());
+                std::vector<uint32_t> positions(paths.size());
+                std::iota(positions.begin(), positions.end(), 0u);
+                cache->store(entry, filename, reportExtents,
+                             analyzer.rankPaths(paths, std::move(positions), topK));
+                return paths;
+            };
             
-        } else {
-            // Process multiple files in directory
-            std::cout << "Processing timing reports in: " << inputDir << std::endl;
+            // Slack ranks against each report's own Clock Period
+            std::vector<double> clockPeriods;
+            auto noteClockPeriod = [&](const std::string& filename) {
+                if (std::find(rankKeys.begin(), rankKeys.end(), RankKey::Slack) == rankKeys.end()) {
+                    return;
+                }
+                double period = parser.lastClockPeriod();
+                if (std::isnan(period)) {
+                    std::cerr << "Warning: No Clock Period in " << filename
+                              << "; its paths rank last by slack" << std::endl;
+                }
+                clockPeriods.resize(timingPaths.size(), period);
+            };
             
-            std::vector<TimingPath> allPaths;
-            TimingParser parser;
+            // A later report can beat an earlier report's path to an endpoint;
+            // dropping it after every report keeps one path per endpoint
+            auto dropDominated = [&] {
+                if (!uniqueEndpoints) {
+                    return;
+                }
+                size_t kept = 0;
+                for (size_t row = 0; row < timingPaths.size(); ++row) {
+                    if (!parser.isWorstForEndpoint(timingPaths[row])) {
+                        continue;
+                    }
+                    if (kept != row) {
+                        timingPaths[kept] = std::move(timingPaths[row]);
+                        if (lazy) {
+                            extents[kept] = extents[row];
+                        }
+                        if (!clockPeriods.empty()) {
+                            clockPeriods[kept] = clockPeriods[row];
+                        }
+                    }
+                    ++kept;
+                }
+                timingPaths.erase(timingPaths.begin() + kept, timingPaths.end());
+                if (lazy) {
+                    extents.resize(kept);
+                }
+                if (!clockPeriods.empty()) {
+                    clockPeriods.resize(kept);
+                }
+            };
             
-            for (const auto& entry : fs::directory_iterator(inputDir)) {
-                if (entry.is_regular_file() && entry.path().extension() == ".rpt") {
-                    std::cout << "  Processing: " << entry.path().filename() << std::endl;
-                    auto paths = parser.parseFile(entry.path().string());
-                    allPaths.insert(allPaths.end(), paths.begin(), paths.end());
+            if (!inputFile.empty()) {
+                // Process single file
+                std::cout << "Processing timing report: " << inputFile << std::endl;
+                timingPaths = readReport(inputFile, nullptr);
+                noteClockPeriod(inputFile);
+            } else {
+                // Process multiple files in directory
+                std::cout << "Processing timing reports in: " << inputDir << std::endl;
+                
+                std::vector<std::string> reports;
+                for (const auto& entry : fs::directory_iterator(inputDir)) {
+                    if (entry.is_regular_file() && entry.path().extension() == ".rpt") {
+                        reports.push_back(entry.path().string());
+                    }
+                }
+                
+                // Later reports are read while earlier ones are parsed
+                BatchReader reader(std::move(reports), ioOptions);
+                BatchReader::File contents;
+                while (reader.next(contents)) {
+                    std::cout << "  Processing: " << fs::path(contents.path).filename() << std::endl;
+                    auto paths = readReport(contents.path, &contents);
+                    timingPaths.insert(timingPaths.end(), paths.begin(), paths.end());
+                    noteClockPeriod(contents.path);
+                    dropDominated();
                 }
             }
             
-            // Analyze all collected paths
-            TimingAnalyzer analyzer;
-            auto criticalPaths = analyzer.findCriticalPaths(allPaths, topK);
+            if (cache) {
+                std::cout << cache->summary() << std::endl;
+            }
+            
+            // Analyze the timing paths
+            std::vector<Utils::ResultSection> sections;
+            
+            // Filters, groupings and rankings by other keys read the same columns
+            PathColumns columns;
+            if (!whereClause.empty() || !rankByDelay || grouped) {
+                columns = PathColumns::build(timingPaths, clockPeriods);
+            }
+            std::unique_ptr<ThreadPool> groupPool;
+            std::string groupNote;
+            if (grouped) {
+                grouping.resolve(parser);
+                groupPool = std::make_unique<ThreadPool>();
+                groupNote = "at most " + std::to_string(perGroup) + " per " + grouping.describe();
+            }
+            auto rank = [&](std::vector<uint32_t> candidates) {
+                std::vector<Utils::ResultSection> ranked;
+                if (grouped) {
+                    // A bounded heap per group for each key
+                    for (RankKey key : rankKeys) {
+                        auto rows = grouping.selectTop(columns, candidates, topK, key, perGroup,
+                                                       *groupPool);
+                        if (!lazy) {
+                            ranked.push_back({rankByDelay ? "" : RankKeys::name(key),
+                                              analyzer.analyzePaths(timingPaths, rows), groupNote});
+                            continue;
+                        }
+                        // Header-only paths need their stages before analysis
+                        parser.loadStages(timingPaths, extents, rows);
+                        ranked.push_back({"", analyzer.analyzePaths(timingPaths, rows), groupNote});
+                    }
+                } else if (ranged) {
+                    // Select each key's range; nothing ahead of it is sorted
+                    for (RankKey key : rankKeys) {
+                        auto rows = rankByDelay
+                            ? analyzer.rankRange(timingPaths, candidates, rangeFirst, rangeLast)
+                            : analyzer.rankRange(columns, candidates, rangeFirst, rangeLast, key);
+                        ranked.push_back({rankByDelay ? "" : RankKeys::name(key),
+                                          analyzer.analyzePaths(timingPaths, rows), "",
+                                          rangeFirst + 1});
+                    }
+                } else if (rankByDelay) {
+                    ranked.push_back({"", analyzer.findCriticalPaths(timingPaths,
+                                                                     std::move(candidates), topK),
+                                      ""});
+                } else if (rankKeys.size() == 1) {
+                    ranked.push_back({RankKeys::name(rankKeys[0]),
+                                      analyzer.analyzePaths(timingPaths,
+                                                            analyzer.rankPaths(columns, candidates,
+                                                                               topK, rankKeys[0])),
+                                      ""});
+                } else {
+                    // One pass over the candidates fills a bounded heap per key
+                    auto rows = analyzer.rankPaths(columns, candidates, topK, rankKeys);
+                    for (size_t i = 0; i < rankKeys.size(); ++i) {
+                        ranked.push_back({RankKeys::name(rankKeys[i]),
+                                          analyzer.analyzePaths(timingPaths, rows[i]), ""});
+                    }
+                }
+                return ranked;
+            };
+            
+            if (!whereClause.empty() || nodeFilter) {
+                PathIndex index;
+                {
+                    Profiler::ScopedTimer timer(Profiler::Phase::Index);
+                    Trace::Span span("index", "phase");
+                    timer.addItems(timingPaths.size());
+                    index = PathIndex::build(timingPaths, parser.nodeCount());
+                }
+                
+                std::vector<uint32_t> candidates;
+                {
+                    Profiler::ScopedTimer timer(Profiler::Phase::Filter);
+                    Trace::Span span("filter", "phase");
+                    timer.addItems(timingPaths.size());
+                    
+                    if (throughNodes.size() == 1 && avoidNodes.empty()) {
+                        // A single node is answered straight from its posting list
+                        candidates = index.pathsThrough(parser.findNodeId(throughNodes[0]));
+                    } else if (nodeFilter) {
+                        // Combine several nodes with bitmaps over the common ones
+                        std::vector<uint32_t> include, exclude;
+                        for (const auto& name : throughNodes) {
+                            include.push_back(parser.findNodeId(name));
+                        }
+                        for (const auto& name : avoidNodes) {
+                            exclude.push_back(parser.findNodeId(name));
+                        }
+                        
+                        ThreadPool pool;
+                        auto bitmaps = BitmapIndex::build(index, bitmapThreshold, pool);
+                        candidates = bitmaps.select(index, include, exclude,
+                                                    static_cast<uint32_t>(timingPaths.size())).toIds();
+                    }
+                    
+                    if (!whereClause.empty()) {
+                        // Filter column by column, then rank only the selected paths
+                        auto selected = query.evaluate(columns, parser, index);
+                        if (nodeFilter) {
+                            candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                                            [&selected](uint32_t id) {
+                                                                return !selected.test(id);
+                                                            }),
+                                             candidates.end());
+                        } else {
+                            candidates = selected.toIds();
+                        }
+                    }
+                }
+                
+                sections = rank(std::move(candidates));
+            } else if (!lazy || grouped) {
+                std::vector<uint32_t> positions(timingPaths.size());
+                std::iota(positions.begin(), positions.end(), 0u);
+                sections = rank(std::move(positions));
+            } else {
+                std::vector<uint32_t> positions(timingPaths.size());
+                std::iota(positions.begin(), positions.end(), 0u);
+                auto top = ranged
+                    ? analyzer.rankRange(timingPaths, positions, rangeFirst, rangeLast)
+                    : analyzer.rankPaths(timingPaths, std::move(positions), topK);
+                parser.loadStages(timingPaths, extents, top);
+                sections.push_back({"", analyzer.analyzePaths(timingPaths, top), "",
+                                    ranged ? rangeFirst + 1 : 1});
+            }
             
             // Generate and display results
-            Utils::printResults(criticalPaths, outputFile);
+            Utils::printResults(sections, outputFile);
+            
+            if (memStats) {
+                // Report while the parsed data is still live
+                std::cerr << MemoryStats::report(timingPaths.size());
+            }
         }
         
-        return 0;
+        return finish(0);
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
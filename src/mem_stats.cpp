@@ -0,0 +1,125 @@
+/**
+ * @file mem_stats.cpp
+ * @brief Implementation of the memory accounting counters
+ */
+
+#include "mem_stats.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace MemoryStats {
+
+namespace {
+
+struct Counters {
+    std::atomic<int64_t> bytes{0};
+    std::atomic<int64_t> peakBytes{0};
+    std::atomic<int64_t> objects{0};
+};
+
+Counters counters[static_cast<size_t>(Category::Count)];
+
+const char* categoryName(Category category) {
+    switch (category) {
+        case Category::Lines: return "line storage";
+        case Category::NodeTable: return "node table";
+        case Category::Edges: return "edges";
+        case Category::Paths: return "paths";
+        case Category::Analyses: return "analyses";
+        case Category::Output: return "output buffer";
+        default: return "?";
+    }
+}
+
+std::string formatBytes(double bytes) {
+    static const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    size_t unit = 0;
+    while (bytes >= 1024.0 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+        bytes /= 1024.0;
+        ++unit;
+    }
+    std::stringstream result;
+    result << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << bytes << " " << units[unit];
+    return result.str();
+}
+
+} // namespace
+
+void charge(Category category, int64_t bytes, int64_t objects) {
+    Counters& c = counters[static_cast<size_t>(category)];
+    if (objects != 0) {
+        c.objects.fetch_add(objects, std::memory_order_relaxed);
+    }
+    int64_t now = c.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = c.peakBytes.load(std::memory_order_relaxed);
+    while (now > peak && !c.peakBytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+void Charge::add(uint64_t moreBytes, uint64_t moreObjects) {
+    bytes += moreBytes;
+    objects += moreObjects;
+    charge(category, static_cast<int64_t>(moreBytes), static_cast<int64_t>(moreObjects));
+}
+
+void Charge::release() {
+    charge(category, -static_cast<int64_t>(bytes), -static_cast<int64_t>(objects));
+    bytes = 0;
+    objects = 0;
+}
+
+Usage usage(Category category) {
+    const Counters& c = counters[static_cast<size_t>(category)];
+    return {c.bytes.load(), c.peakBytes.load(), c.objects.load()};
+}
+
+uint64_t processStatusBytes(const std::string& field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        // e.g. "VmHWM:     123456 kB"
+        if (line.compare(0, field.size(), field) == 0 && line.size() > field.size() &&
+            line[field.size()] == ':') {
+            std::istringstream value(line.substr(field.size() + 1));
+            uint64_t kilobytes = 0;
+            value >> kilobytes;
+            return kilobytes * 1024;
+        }
+    }
+    return 0;
+}
+
+std::string report(uint64_t pathCount) {
+    std::stringstream out;
+    out << "Memory (live and peak bytes per structure; excludes allocator overhead):\n"
+        << std::left << std::setw(16) << "Structure" << std::right
+        << std::setw(14) << "Objects" << std::setw(14) << "Live"
+        << std::setw(14) << "Peak" << std::setw(14) << "Peak/path" << "\n";
+
+    int64_t totalPeak = 0;
+    for (size_t i = 0; i < static_cast<size_t>(Category::Count); ++i) {
+        Usage u = usage(static_cast<Category>(i));
+        totalPeak += u.peakBytes;
+        out << std::left << std::setw(16) << categoryName(static_cast<Category>(i)) << std::right
+            << std::setw(14) << u.objects
+            << std::setw(14) << formatBytes(static_cast<double>(u.bytes))
+            << std::setw(14) << formatBytes(static_cast<double>(u.peakBytes))
+            << std::setw(14)
+            << (pathCount ? formatBytes(static_cast<double>(u.peakBytes) / pathCount) : "-")
+            << "\n";
+    }
+
+    uint64_t peakRss = processStatusBytes("VmHWM");
+    out << std::left << std::setw(16) << "sum of peaks" << std::right << std::setw(42)
+        << formatBytes(static_cast<double>(totalPeak)) << std::setw(14)
+        << (pathCount ? formatBytes(static_cast<double>(totalPeak) / pathCount) : "-") << "\n"
+        << std::left << std::setw(16) << "peak RSS" << std::right << std::setw(42)
+        << (peakRss ? formatBytes(static_cast<double>(peakRss)) : "-") << std::setw(14)
+        << (pathCount && peakRss ? formatBytes(static_cast<double>(peakRss) / pathCount) : "-")
+        << "\n"
+        << "paths parsed: " << pathCount << "\n";
+    return out.str();
+}
+
+} // namespace MemoryStats
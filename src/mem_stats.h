@@ -0,0 +1,156 @@
+/**
+ * @file mem_stats.h
+ * @brief Per-structure memory accounting behind the --mem-stats option
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @namespace MemoryStats
+ * @brief Live bytes, peak bytes and object counts per data structure
+ *
+ * The structures keep their own counts: standard containers use
+ * MemoryStats::Allocator, object types derive from MemoryStats::Tracked, and
+ * buffers that are neither use a Charge. Shared-pointer control blocks and
+ * the heap parts of long strings are not counted, so the totals are a lower
+ * bound that should be read next to the process peak RSS.
+ */
+namespace MemoryStats {
+
+/**
+ * @enum Category
+ * @brief Structures memory is reported for
+ */
+enum class Category {
+    Lines,      // Report lines held while parsing
+    NodeTable,  // Name -> ID map and interned nodes
+    Edges,      // Path stages
+    Paths,      // TimingPath objects and their stage lists, including copies
+    Analyses,   // Analysis results
+    Output,     // Formatted results
+    Count
+};
+
+/**
+ * @brief Adjust a category's counters
+ * @param category Category to charge
+ * @param bytes Bytes allocated (positive) or freed (negative)
+ * @param objects Objects created (positive) or destroyed (negative)
+ */
+void charge(Category category, int64_t bytes, int64_t objects);
+
+/**
+ * @class Allocator
+ * @brief std::allocator that charges its allocations to a category
+ */
+template <class T, Category C>
+class Allocator {
+public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = Allocator<U, C>;
+    };
+
+    Allocator() noexcept = default;
+
+    template <class U>
+    Allocator(const Allocator<U, C>&) noexcept {}
+
+    T* allocate(size_t n) {
+        T* p = std::allocator<T>().allocate(n);
+        charge(C, static_cast<int64_t>(n * sizeof(T)), 0);
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        charge(C, -static_cast<int64_t>(n * sizeof(T)), 0);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(const Allocator&, const Allocator&) { return true; }
+    friend bool operator!=(const Allocator&, const Allocator&) { return false; }
+};
+
+/**
+ * @class Tracked
+ * @brief Base class that counts live objects of T and their size
+ */
+template <class T, Category C>
+class Tracked {
+public:
+    Tracked() noexcept { charge(C, static_cast<int64_t>(sizeof(T)), 1); }
+    Tracked(const Tracked&) noexcept : Tracked() {}
+    Tracked& operator=(const Tracked&) noexcept { return *this; }
+    ~Tracked() { charge(C, -static_cast<int64_t>(sizeof(T)), -1); }
+};
+
+/**
+ * @class Charge
+ * @brief Charges a buffer's memory to a category until destroyed
+ */
+class Charge {
+public:
+    explicit Charge(Category category) : category(category) {}
+    ~Charge() { release(); }
+
+    Charge(const Charge&) = delete;
+    Charge& operator=(const Charge&) = delete;
+
+    /**
+     * @brief Charge more bytes and objects
+     * @param bytes Bytes to add
+     * @param objects Objects to add
+     */
+    void add(uint64_t bytes, uint64_t objects = 0);
+
+    /**
+     * @brief Give back everything charged so far
+     */
+    void release();
+
+private:
+    Category category;
+    uint64_t bytes{0};
+    uint64_t objects{0};
+};
+
+/**
+ * @struct Usage
+ * @brief Snapshot of one category
+ */
+struct Usage {
+    int64_t bytes{0};
+    int64_t peakBytes{0};
+    int64_t objects{0};
+};
+
+/**
+ * @brief Read a category's counters
+ * @param category Category to read
+ * @return Current bytes, peak bytes and live objects
+ */
+Usage usage(Category category);
+
+/**
+ * @brief Read a field of /proc/self/status
+ * @param field Field name such as "VmHWM"
+ * @return Value in bytes, or 0 where unavailable
+ */
+uint64_t processStatusBytes(const std::string& field);
+
+/**
+ * @brief Format the per-structure table, peak RSS and bytes per path
+ * @param pathCount Number of parsed paths, for the per-path figures
+ * @return Report text
+ */
+std::string report(uint64_t pathCount);
+
+} // namespace MemoryStats
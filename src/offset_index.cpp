@@ -0,0 +1,229 @@
+/**
+ * @file offset_index.cpp
+ * @brief Implementation of the path offset sidecar index
+ */
+
+#include "offset_index.h"
+#include "parser.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kMagic[8] = {'T', 'A', 'I', 'D', 'X', '0', '0', '1'};
+
+// Fixed-size sidecar header; entries follow immediately
+struct SidecarHeader {
+    char magic[8];
+    uint64_t reportBytes;
+    int64_t reportMtimeNs;
+    uint64_t count;
+};
+
+struct FileStamp {
+    uint64_t bytes;
+    int64_t mtimeNs;
+};
+
+FileStamp stampOf(const std::string& filename) {
+    struct stat st {};
+    if (::stat(filename.c_str(), &st) != 0) {
+        throw std::runtime_error("Failed to stat file: " + filename);
+    }
+    return {static_cast<uint64_t>(st.st_size),
+            static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec};
+}
+
+// Map a whole file read-only; returns null for an empty file
+void* mapFile(const std::string& filename, size_t& bytes) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file: " + filename);
+    }
+    bytes = static_cast<size_t>(st.st_size);
+    void* data = nullptr;
+    if (bytes > 0) {
+        data = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Failed to map file: " + filename);
+        }
+    }
+    ::close(fd);
+    return data;
+}
+
+// The ID token of a "Path <id> ..." header
+std::string_view headerId(std::string_view header) {
+    size_t begin = 4;  // After "Path"
+    while (begin < header.size() && std::isspace(static_cast<unsigned char>(header[begin]))) {
+        ++begin;
+    }
+    size_t end = begin;
+    while (end < header.size() && !std::isspace(static_cast<unsigned char>(header[end]))) {
+        ++end;
+    }
+    return header.substr(begin, end - begin);
+}
+
+} // namespace
+
+OffsetIndex::~OffsetIndex() {
+    release();
+}
+
+OffsetIndex::OffsetIndex(OffsetIndex&& other) noexcept {
+    *this = std::move(other);
+}
+
+OffsetIndex& OffsetIndex::operator=(OffsetIndex&& other) noexcept {
+    if (this != &other) {
+        release();
+        report = other.report;
+        reportBytes = other.reportBytes;
+        sidecar = other.sidecar;
+        sidecarBytes = other.sidecarBytes;
+        entries = other.entries;
+        count = other.count;
+        other.report = nullptr;
+        other.sidecar = nullptr;
+        other.entries = nullptr;
+        other.reportBytes = other.sidecarBytes = other.count = 0;
+    }
+    return *this;
+}
+
+void OffsetIndex::release() {
+    if (report) {
+        ::munmap(const_cast<char*>(report), reportBytes);
+        report = nullptr;
+    }
+    if (sidecar) {
+        ::munmap(sidecar, sidecarBytes);
+        sidecar = nullptr;
+    }
+}
+
+uint64_t OffsetIndex::hashId(std::string_view id) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : id) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+size_t OffsetIndex::build(const std::string& reportFile) {
+    FileStamp stamp = stampOf(reportFile);
+    std::ifstream file(reportFile, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file: " + reportFile);
+    }
+
+    // Stream the report once, keeping only 24 bytes per path
+    std::vector<Entry> found;
+    std::string line;
+    uint64_t offset = 0;
+    bool haveLine = static_cast<bool>(std::getline(file, line));
+    while (haveLine) {
+        if (line.compare(0, 5, "Path ") != 0) {
+            offset += line.size() + 1;
+            haveLine = static_cast<bool>(std::getline(file, line));
+            continue;
+        }
+
+        Entry entry{hashId(headerId(line)), offset, 0};
+        do {
+            offset += line.size() + 1;
+        } while ((haveLine = static_cast<bool>(std::getline(file, line))) &&
+                 !TimingParser::endsPathSection(line));
+        entry.length = std::min<uint64_t>(offset, stamp.bytes) - entry.offset;
+        found.push_back(entry);
+    }
+
+    // Equal hashes keep report order, so duplicate IDs resolve to the first
+    std::sort(found.begin(), found.end(), [](const Entry& a, const Entry& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.offset < b.offset;
+    });
+
+    SidecarHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.reportBytes = stamp.bytes;
+    header.reportMtimeNs = stamp.mtimeNs;
+    header.count = found.size();
+
+    std::string sidecarFile = sidecarPath(reportFile);
+    std::ofstream out(sidecarFile, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(found.data()),
+              static_cast<std::streamsize>(found.size() * sizeof(Entry)));
+    if (!out) {
+        throw std::runtime_error("Failed to write index: " + sidecarFile);
+    }
+    return found.size();
+}
+
+OffsetIndex OffsetIndex::open(const std::string& reportFile) {
+    std::string sidecarFile = sidecarPath(reportFile);
+    if (::access(sidecarFile.c_str(), R_OK) != 0) {
+        throw std::runtime_error("No index for " + reportFile + "; build it with --build-index");
+    }
+
+    OffsetIndex index;
+    index.sidecar = mapFile(sidecarFile, index.sidecarBytes);
+
+    SidecarHeader header{};
+    if (index.sidecarBytes < sizeof(header)) {
+        throw std::runtime_error("Malformed index: " + sidecarFile);
+    }
+    std::memcpy(&header, index.sidecar, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        index.sidecarBytes != sizeof(header) + header.count * sizeof(Entry)) {
+        throw std::runtime_error("Malformed index: " + sidecarFile);
+    }
+
+    FileStamp stamp = stampOf(reportFile);
+    if (stamp.bytes != header.reportBytes || stamp.mtimeNs != header.reportMtimeNs) {
+        throw std::runtime_error("Index is out of date for " + reportFile +
+                                 "; rebuild it with --build-index");
+    }
+
+    index.entries = reinterpret_cast<const Entry*>(static_cast<const char*>(index.sidecar) +
+                                                   sizeof(header));
+    index.count = header.count;
+    index.report = static_cast<const char*>(mapFile(reportFile, index.reportBytes));
+    return index;
+}
+
+std::optional<std::string_view> OffsetIndex::find(const std::string& id) const {
+    uint64_t hash = hashId(id);
+    const Entry* end = entries + count;
+    const Entry* it = std::lower_bound(entries, end, hash, [](const Entry& entry, uint64_t h) {
+        return entry.hash < h;
+    });
+
+    for (; it != end && it->hash == hash; ++it) {
+        if (it->offset + it->length > reportBytes) {
+            continue;
+        }
+        std::string_view section(report + it->offset, it->length);
+        std::string_view header = section.substr(0, section.find('\n'));
+        if (headerId(header) == id) {
+            return section;
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file offset_index.h
+ * @brief Sidecar index from path ID to the byte range of its report section
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * @class OffsetIndex
+ * @brief Random access to single paths of a large report
+ *
+ * build() scans a report once and writes REPORT.idx next to it: a header with
+ * the report's size and modification time, then one fixed-size entry per path
+ * (64-bit hash of the ID, byte offset and length of the section) sorted by
+ * hash. open() maps both files; find() binary-searches the hash and confirms
+ * the ID against the section's header line, so hash collisions are harmless.
+ */
+class OffsetIndex {
+public:
+    OffsetIndex() = default;
+    ~OffsetIndex();
+
+    OffsetIndex(const OffsetIndex&) = delete;
+    OffsetIndex& operator=(const OffsetIndex&) = delete;
+    OffsetIndex(OffsetIndex&& other) noexcept;
+    OffsetIndex& operator=(OffsetIndex&& other) noexcept;
+
+    /**
+     * @brief Get the sidecar file name for a report
+     * @param reportFile Report file path
+     * @return reportFile + ".idx"
+     */
+    static std::string sidecarPath(const std::string& reportFile) { return reportFile + ".idx"; }
+
+    /**
+     * @brief Scan a report and write its sidecar index
+     * @param reportFile Report file path
+     * @return Number of paths indexed
+     * @throws std::runtime_error if the report cannot be read or the index written
+     */
+    static size_t build(const std::string& reportFile);
+
+    /**
+     * @brief Map a report and its sidecar index for lookups
+     * @param reportFile Report file path
+     * @return The opened index
+     * @throws std::runtime_error if the index is missing, malformed or stale
+     */
+    static OffsetIndex open(const std::string& reportFile);
+
+    /**
+     * @brief Find the section of a path
+     * @param id Path ID such as "P123456"
+     * @return Header and stage lines of the path, or nothing if it is not indexed
+     */
+    std::optional<std::string_view> find(const std::string& id) const;
+
+    /**
+     * @brief Get the number of indexed paths
+     * @return Path count
+     */
+    size_t size() const { return count; }
+
+private:
+    struct Entry {
+        uint64_t hash;
+        uint64_t offset;   // Byte offset of the "Path" header line
+        uint64_t length;   // Bytes from the header to the end of the section
+    };
+
+    /**
+     * @brief Hash a path ID for the sidecar
+     * @param id Path ID
+     * @return 64-bit FNV-1a hash
+     */
+    static uint64_t hashId(std::string_view id);
+
+    void release();
+
+    const char* report{nullptr};
+    size_t reportBytes{0};
+    void* sidecar{nullptr};
+    size_t sidecarBytes{0};
+    const Entry* entries{nullptr};
+    size_t count{0};
+};
@@ -0,0 +1,301 @@
+/**
+ * @file parse_pipeline.cpp
+ * @brief Implementation of the pipelined report parser
+ */
+
+#include "parse_pipeline.h"
+#include "mem_stats.h"
+#include "profiler.h"
+#include "spsc_queue.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Byte range of one path section within a batch's text
+struct SectionSpan {
+    size_t begin;
+    size_t end;
+    size_t line;  // Report line of the header
+};
+
+// Reader -> tokenizer: whole path sections, newline-terminated
+struct SectionBatch {
+    std::string text;
+    std::vector<SectionSpan> sections;
+};
+
+// One path with its fields extracted but no names interned
+struct PathTokens {
+    std::string id;
+    std::string startpoint;
+    std::string endpoint;
+    double delay{0.0};
+    bool valid{false};
+    std::vector<std::pair<std::string, std::string>> stageNames;  // from, to
+    std::vector<double> stageDelays;
+    std::vector<std::string> warnings;
+};
+
+// Tokenizer -> builder
+struct TokenBatch {
+    std::vector<PathTokens> paths;
+};
+
+/**
+ * @class StageErrors
+ * @brief First exception raised by any stage; raising one cancels the others
+ */
+class StageErrors {
+public:
+    void raise(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!first) {
+            first = error;
+        }
+        cancelled = true;
+    }
+
+    void rethrow() {
+        if (first) {
+            std::rethrow_exception(first);
+        }
+    }
+
+    std::atomic<bool> cancelled{false};
+
+private:
+    std::mutex mutex;
+    std::exception_ptr first;
+};
+
+} // namespace
+
+ParsePipeline::ParsePipeline(TimingParser& parser, size_t tokenizers)
+    : parser(parser), tokenizers(std::max<size_t>(tokenizers, 1)) {}
+
+std::vector<TimingPath> ParsePipeline::run(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    return run(file);
+}
+
+std::vector<TimingPath> ParsePipeline::run(std::istream& file) {
+    parser.beginFile();
+
+    // Header and stage matchers; a lambda so it shares run()'s access to the parser
+    auto tokenize = [](const SectionBatch& batch, TokenBatch& out) {
+        out.paths.resize(batch.sections.size());
+        std::string line;
+        for (size_t s = 0; s < batch.sections.size(); ++s) {
+            const SectionSpan& span = batch.sections[s];
+            PathTokens& tokens = out.paths[s];
+
+            size_t begin = span.begin;
+            size_t end = batch.text.find('\n', begin);
+            line.assign(batch.text, begin, end - begin);
+            try {
+                auto [id, startpoint, endpoint, delay] = TimingParser::parsePathHeader(line);
+                tokens.id = std::move(id);
+                tokens.startpoint = std::move(startpoint);
+                tokens.endpoint = std::move(endpoint);
+                tokens.delay = delay;
+                tokens.valid = true;
+            } catch (const std::exception& e) {
+                tokens.warnings.push_back("Warning: Failed to parse path at line " +
+                                          std::to_string(span.line) + ": " + e.what());
+                continue;
+            }
+
+            // Same stage filter as TimingParser::parseStages()
+            const std::string stagePrefix = tokens.id + ".";
+            size_t lineIndex = span.line;
+            TimingParser::StageFields stage;
+            for (begin = end + 1; begin < span.end; begin = end + 1) {
+                end = batch.text.find('\n', begin);
+                ++lineIndex;
+                line.assign(batch.text, begin, end - begin);
+                if (line.find(stagePrefix) == std::string::npos) {
+                    continue;
+                }
+                try {
+                    if (TimingParser::matchStage(line, stage)) {
+                        tokens.stageNames.emplace_back(std::move(stage.fromName),
+                                                       std::move(stage.toName));
+                        tokens.stageDelays.push_back(stage.delay);
+                    }
+                } catch (const std::exception& e) {
+                    tokens.warnings.push_back("Warning: Failed to parse stage at line " +
+                                              std::to_string(lineIndex) + ": " + e.what());
+                }
+            }
+        }
+    };
+
+    std::vector<std::unique_ptr<SpscQueue<SectionBatch>>> sectionQueues;
+    std::vector<std::unique_ptr<SpscQueue<TokenBatch>>> tokenQueues;
+    for (size_t t = 0; t < tokenizers; ++t) {
+        sectionQueues.push_back(std::make_unique<SpscQueue<SectionBatch>>(kQueueDepth));
+        tokenQueues.push_back(std::make_unique<SpscQueue<TokenBatch>>(kQueueDepth));
+    }
+    StageErrors errors;
+    std::vector<std::thread> threads;
+
+    // Stage 1: split the report into batches of sections, round-robin
+    threads.emplace_back([&] {
+        Trace::Span span("read", "pipeline");
+        try {
+            Profiler::ScopedTimer timer(Profiler::Phase::FileRead);
+            SectionBatch batch;
+            size_t sent = 0;
+            uint64_t bytes = 0;
+            size_t lineIndex = 0;
+            auto send = [&] {
+                MemoryStats::charge(MemoryStats::Category::Lines,
+                                    static_cast<int64_t>(batch.text.capacity()), 1);
+                bool pushed = sectionQueues[sent % tokenizers]->push(std::move(batch),
+                                                                     errors.cancelled);
+                batch = SectionBatch();
+                ++sent;
+                return pushed;
+            };
+
+            std::string line;
+            auto readLine = [&] {
+                if (!std::getline(file, line)) {
+                    return false;
+                }
+                bytes += line.size() + 1;
+                return true;
+            };
+
+            bool haveLine = readLine();
+            while (haveLine) {
+                if (line.find("Path ") != 0) {
+                    parser.noteReportLine(line);
+                    ++lineIndex;
+                    haveLine = readLine();
+                    continue;
+                }
+
+                // Rejected sections are read past without being batched
+                bool rejected = parser.rejectHeader(line);
+                SectionSpan section{batch.text.size(), 0, lineIndex};
+                do {
+                    if (!rejected) {
+                        batch.text.append(line).push_back('\n');
+                    }
+                    ++lineIndex;
+                } while ((haveLine = readLine()) && !TimingParser::endsPathSection(line));
+                if (rejected) {
+                    continue;
+                }
+
+                section.end = batch.text.size();
+                batch.sections.push_back(section);
+                if (batch.text.size() >= kBatchBytes && !send()) {
+                    break;
+                }
+            }
+            if (!batch.sections.empty()) {
+                send();
+            }
+            timer.addItems(lineIndex);
+            timer.addBytes(bytes);
+        } catch (...) {
+            errors.raise(std::current_exception());
+        }
+        for (auto& queue : sectionQueues) {
+            queue->close();
+        }
+    });
+
+    // Stages 2 and 3 are timed once, on this thread, until the last path is
+    // built; per-batch timers on concurrent tokenizers would add up their wall
+    // time as if the tokenizers had run one after another
+    Profiler::ScopedTimer parseTimer(Profiler::Phase::Parse);
+    std::atomic<uint64_t> tokenizedPaths{0};
+    std::atomic<uint64_t> tokenizedBytes{0};
+
+    // Stage 2: regex tokenizing, the bulk of the work
+    for (size_t t = 0; t < tokenizers; ++t) {
+        threads.emplace_back([&, t] {
+            Trace::Span span("tokenize", "pipeline");
+            try {
+                SectionBatch batch;
+                while (sectionQueues[t]->pop(batch, errors.cancelled)) {
+                    TokenBatch tokens;
+                    tokenize(batch, tokens);
+                    tokenizedPaths.fetch_add(tokens.paths.size(), std::memory_order_relaxed);
+                    tokenizedBytes.fetch_add(batch.text.size(), std::memory_order_relaxed);
+                    MemoryStats::charge(MemoryStats::Category::Lines,
+                                        -static_cast<int64_t>(batch.text.capacity()), -1);
+                    batch = SectionBatch();
+                    if (!tokenQueues[t]->push(std::move(tokens), errors.cancelled)) {
+                        break;
+                    }
+                }
+            } catch (...) {
+                errors.raise(std::current_exception());
+            }
+            tokenQueues[t]->close();
+        });
+    }
+
+    // Stage 3: intern names and build paths in report order on this thread
+    std::vector<TimingPath> paths;
+    TimingParser::EndpointRows endpointRows;
+    try {
+        Trace::Span span("build", "pipeline");
+        TokenBatch batch;
+        for (size_t received = 0;
+             tokenQueues[received % tokenizers]->pop(batch, errors.cancelled); ++received) {
+            for (PathTokens& tokens : batch.paths) {
+                if (tokens.valid) {
+                    TimingPath path;
+                    path.id = std::move(tokens.id);
+                    path.startpoint = std::move(tokens.startpoint);
+                    path.endpoint = std::move(tokens.endpoint);
+                    path.totalDelay = tokens.delay;
+                    path.startpointId = parser.internName(path.startpoint);
+                    path.endpointId = parser.internName(path.endpoint);
+                    path.edges.reserve(tokens.stageNames.size());
+                    for (size_t i = 0; i < tokens.stageNames.size(); ++i) {
+                        path.edges.push_back(parser.makeEdge(tokens.stageNames[i].first,
+                                                             tokens.stageNames[i].second,
+                                                             tokens.stageDelays[i]));
+                    }
+                    size_t row = parser.rowFor(path.endpointId, paths.size(), endpointRows);
+                    if (row == paths.size()) {
+                        paths.push_back(std::move(path));
+                    } else {
+                        paths[row] = std::move(path);
+                    }
+                }
+                for (const auto& warning : tokens.warnings) {
+                    std::cerr << warning << std::endl;
+                }
+            }
+        }
+    } catch (...) {
+        errors.raise(std::current_exception());
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    parseTimer.addItems(tokenizedPaths.load());
+    parseTimer.addBytes(tokenizedBytes.load());
+    errors.rethrow();
+    return paths;
+}
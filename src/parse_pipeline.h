@@ -0,0 +1,63 @@
+/**
+ * @file parse_pipeline.h
+ * @brief Read / tokenize / build pipeline for full report parses
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+#include "parser.h"
+
+/**
+ * @class ParsePipeline
+ * @brief Parses one report with reading, tokenizing and building overlapped
+ *
+ * A reader thread splits the report into batches of whole path sections and
+ * applies the parser's delay thresholds. Tokenizer threads run the header and
+ * stage regexes, which dominate parse time and touch no parser state. The
+ * calling thread interns names and builds the paths, so node IDs, path order
+ * and warnings match a serial TimingParser::parseFile().
+ *
+ * Stages are linked by bounded SpscQueues. Batch i goes to tokenizer i mod N
+ * and comes back on that tokenizer's output queue, so the builder reads
+ * batches in report order without a reorder buffer. A full queue stalls the
+ * stage feeding it, which bounds the text and tokens in flight to a few
+ * batches per tokenizer.
+ */
+class ParsePipeline {
+public:
+    // Report text per batch handed from the reader to a tokenizer
+    static constexpr size_t kBatchBytes = 256 * 1024;
+
+    // Batches each queue holds before its producer waits
+    static constexpr size_t kQueueDepth = 4;
+
+    /**
+     * @brief Create a pipeline that builds paths into a parser
+     * @param parser Parser whose thresholds apply and whose node table is filled
+     * @param tokenizers Number of tokenizer threads, at least 1
+     */
+    ParsePipeline(TimingParser& parser, size_t tokenizers);
+
+    /**
+     * @brief Parse a report
+     * @param filename Report file path
+     * @return Parsed paths in report order
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    std::vector<TimingPath> run(const std::string& filename);
+
+    /**
+     * @brief Parse a report from a stream
+     * @param input Report text; read only by the reader thread
+     * @return Parsed paths in report order
+     */
+    std::vector<TimingPath> run(std::istream& input);
+
+private:
+    TimingParser& parser;
+    size_t tokenizers;
+};
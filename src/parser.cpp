@@ -4,37 +4,178 @@
  */
 
 #include "parser.h"
+#include "parse_pipeline.h"
+#include "profiler.h"
+#include "trace.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <regex>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <stdexcept>
 
+namespace {
+
+/**
+ * @struct HeaderFields
+ * @brief Tokens of a path header, pointing into the line
+ */
+struct HeaderFields {
+    const char* token[3];   // ID, endpoint, startpoint
+    size_t length[3];
+    double delay;
+};
+
+// Split "Path ID ENDPOINT STARTPOINT DELAY" without allocating. This is the
+// one header grammar: rejectHeader() and parsePathHeader() both use it, so a
+// header is valid, and its delay the same, for both. The delay is the run of
+// digits and dots after the startpoint, so "1.5e3" reads as 1.5
+bool splitHeader(const std::string& line, HeaderFields& fields) {
+    if (line.compare(0, 4, "Path") != 0) {
+        return false;
+    }
+    const char* p = line.c_str() + 4;
+    for (int field = 0; field < 3; ++field) {
+        if (!std::isspace(static_cast<unsigned char>(*p))) {
+            return false;
+        }
+        while (std::isspace(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+        fields.token[field] = p;
+        while (*p && !std::isspace(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+        fields.length[field] = static_cast<size_t>(p - fields.token[field]);
+        if (fields.length[field] == 0) {
+            return false;
+        }
+    }
+    if (!std::isspace(static_cast<unsigned char>(*p))) {
+        return false;
+    }
+    while (std::isspace(static_cast<unsigned char>(*p))) {
+        ++p;
+    }
+
+    // Convert only the run, so strtod cannot read an exponent or hex past it
+    char run[64];
+    size_t length = 0;
+    while ((std::isdigit(static_cast<unsigned char>(p[length])) || p[length] == '.') &&
+           length + 1 < sizeof(run)) {
+        run[length] = p[length];
+        ++length;
+    }
+    run[length] = '\0';
+    char* end = nullptr;
+    fields.delay = std::strtod(run, &end);
+    return end != run;
+}
+
+// Read-only stream over bytes already in memory, without copying them
+class MemoryStreamBuf : public std::streambuf {
+public:
+    MemoryStreamBuf(const char* data, size_t size) {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+};
+
+// Replace lines with the newline-separated lines of text
+template <class Lines>
+void splitLines(const std::string& text, Lines& lines) {
+    lines.clear();
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find('\n', begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        lines.emplace_back(text, begin, end - begin);
+        begin = end + 1;
+    }
+}
+
+} // namespace
+
 std::vector<TimingPath> TimingParser::parseFile(const std::string& filename) {
-    std::vector<TimingPath> paths;
+    Trace::Span fileSpan("parse file", "file");
+    fileSpan.setDetail(filename);
     std::ifstream file(filename);
     
     if (!file) {
         throw std::runtime_error("Failed to open file: " + filename);
     }
+    return parseStream(file);
+}
+
+std::vector<TimingPath> TimingParser::parseBuffer(const std::string& name, const char* data,
+                                                  size_t size) {
+    Trace::Span fileSpan("parse file", "file");
+    fileSpan.setDetail(name);
+    MemoryStreamBuf buffer(data, size);
+    std::istream file(&buffer);
+    return parseStream(file);
+}
+
+std::vector<TimingPath> TimingParser::parseStream(std::istream& file) {
+    if (parseThreads > 0) {
+        return ParsePipeline(*this, parseThreads).run(file);
+    }
+    
+    std::vector<TimingPath> paths;
+    EndpointRows endpointRows;
     
     // Read the entire file into memory
-    std::vector<std::string> lines;
+    ReportLines lines;
     std::string line;
+    uint64_t bytes = 0;
+    MemoryStats::Charge lineText(MemoryStats::Category::Lines);
     
-    while (std::getline(file, line)) {
-        lines.push_back(line);
+    {
+        Profiler::ScopedTimer timer(Profiler::Phase::FileRead);
+        Trace::Span span("file read", "phase");
+        while (std::getline(file, line)) {
+            bytes += line.size() + 1;
+            lines.push_back(line);
+            
+            // Count the character buffer unless it fits in the string itself
+            const std::string& stored = lines.back();
+            const char* text = stored.data();
+            bool onHeap = text < reinterpret_cast<const char*>(&stored) ||
+                          text >= reinterpret_cast<const char*>(&stored + 1);
+            lineText.add(onHeap ? stored.capacity() + 1 : 0, 1);
+        }
+        timer.addItems(lines.size());
+        timer.addBytes(bytes);
     }
     
     // Process the file line by line
+    Profiler::ScopedTimer timer(Profiler::Phase::Parse);
+    Trace::Span span("parse", "phase");
+    beginFile();
     size_t lineIndex = 0;
     while (lineIndex < lines.size()) {
         // Look for path header lines
         if (lineIndex < lines.size() && lines[lineIndex].find("Path ") == 0) {
+            if (rejectHeader(lines[lineIndex])) {
+                // Below the threshold: skip the section without parsing it
+                do {
+                    lineIndex++;
+                } while (lineIndex < lines.size() && !endsPathSection(lines[lineIndex]));
+                continue;
+            }
             try {
                 // Parse path and get next line index
                 auto [path, nextLine] = parsePath(lines, lineIndex);
-                paths.push_back(path);
+                size_t row = rowFor(path.endpointId, paths.size(), endpointRows);
+                if (row == paths.size()) {
+                    paths.push_back(std::move(path));
+                } else {
+                    paths[row] = std::move(path);
+                }
                 lineIndex = nextLine;
             } catch (const std::exception& e) {
                 std::cerr << "Warning: Failed to parse path at line " << lineIndex 
@@ -42,15 +183,161 @@ std::vector<TimingPath> TimingParser::parseFile(const std::string& filename) {
                 lineIndex++;
             }
         } else {
+            noteReportLine(lines[lineIndex]);
             lineIndex++;
         }
     }
     
+    timer.addItems(paths.size());
+    timer.addBytes(bytes);
+    return paths;
+}
+
+std::vector<TimingPath> TimingParser::scanFile(const std::string& filename,
+                                               std::vector<PathExtent>& extents) {
+    Trace::Span fileSpan("scan file", "file");
+    fileSpan.setDetail(filename);
+    std::ifstream file(filename);
+    
+    if (!file) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    return scanStream(file, filename, extents);
+}
+
+std::vector<TimingPath> TimingParser::scanBuffer(const std::string& filename, const char* data,
+                                                 size_t size, std::vector<PathExtent>& extents) {
+    Trace::Span fileSpan("scan file", "file");
+    fileSpan.setDetail(filename);
+    MemoryStreamBuf buffer(data, size);
+    std::istream file(&buffer);
+    return scanStream(file, filename, extents);
+}
+
+std::vector<TimingPath> TimingParser::scanStream(std::istream& file, const std::string& filename,
+                                                 std::vector<PathExtent>& extents) {
+    std::vector<TimingPath> paths;
+    EndpointRows endpointRows;
+    size_t firstExtent = extents.size();
+    uint32_t fileIndex = static_cast<uint32_t>(scannedFiles.size());
+    scannedFiles.push_back(filename);
+    beginFile();
+    
+    Profiler::ScopedTimer timer(Profiler::Phase::Parse);
+    Trace::Span span("scan", "phase");
+    std::string line;
+    uint64_t offset = 0;
+    size_t lineIndex = 0;
+    bool haveLine = static_cast<bool>(std::getline(file, line));
+    
+    // Bytes the last getline consumed; a final line may have no '\n'
+    auto lineBytes = [&file, &line] { return line.size() + (file.eof() ? 0 : 1); };
+    
+    while (haveLine) {
+        if (line.find("Path ") != 0) {
+            noteReportLine(line);
+            offset += lineBytes();
+            ++lineIndex;
+            haveLine = static_cast<bool>(std::getline(file, line));
+            continue;
+        }
+        
+        if (rejectHeader(line)) {
+            // Below the threshold: skip the section without recording it
+            do {
+                offset += lineBytes();
+                ++lineIndex;
+            } while ((haveLine = static_cast<bool>(std::getline(file, line))) &&
+                     !endsPathSection(line));
+            continue;
+        }
+        
+        TimingPath path;
+        try {
+            auto [id, startpoint, endpoint, delay] = parsePathHeader(line);
+            path.id = id;
+            path.startpoint = startpoint;
+            path.endpoint = endpoint;
+            path.totalDelay = delay;
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to parse path at line " << lineIndex 
+                      << ": " << e.what() << std::endl;
+            offset += lineBytes();
+            ++lineIndex;
+            haveLine = static_cast<bool>(std::getline(file, line));
+            continue;
+        }
+        path.startpointId = internName(path.startpoint);
+        path.endpointId = internName(path.endpoint);
+        
+        PathExtent extent;
+        extent.file = fileIndex;
+        extent.headerLine = static_cast<uint32_t>(lineIndex);
+        extent.headerLength = static_cast<uint32_t>(lineBytes());
+        offset += lineBytes();
+        ++lineIndex;
+        extent.offset = offset;
+        
+        // Skip the stage section without tokenizing it
+        while ((haveLine = static_cast<bool>(std::getline(file, line))) &&
+               !endsPathSection(line)) {
+            offset += lineBytes();
+            ++lineIndex;
+            ++extent.lineCount;
+        }
+        extent.length = offset - extent.offset;
+        
+        size_t row = rowFor(path.endpointId, paths.size(), endpointRows);
+        if (row == paths.size()) {
+            paths.push_back(std::move(path));
+            extents.push_back(extent);
+        } else {
+            paths[row] = std::move(path);
+            extents[firstExtent + row] = extent;
+        }
+    }
+    
+    timer.addItems(paths.size());
+    timer.addBytes(offset);
     return paths;
 }
 
+void TimingParser::loadStages(std::vector<TimingPath>& paths,
+                              const std::vector<PathExtent>& extents,
+                              const std::vector<uint32_t>& selected) {
+    Profiler::ScopedTimer timer(Profiler::Phase::LoadStages);
+    Trace::Span span("load stages", "phase");
+    timer.addItems(selected.size());
+    
+    std::vector<std::ifstream> files(scannedFiles.size());
+    std::string buffer;
+    ReportLines lines;
+    
+    for (uint32_t position : selected) {
+        const PathExtent& extent = extents[position];
+        TimingPath& path = paths[position];
+        path.edges.clear();
+        
+        std::ifstream& file = files[extent.file];
+        if (!file.is_open()) {
+            file.open(scannedFiles[extent.file], std::ios::binary);
+        }
+        buffer.resize(extent.length);
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(extent.offset));
+        if (!file || !file.read(&buffer[0], static_cast<std::streamsize>(extent.length))) {
+            throw std::runtime_error("Failed to read stages of path " + path.id + " from " +
+                                     scannedFiles[extent.file]);
+        }
+        timer.addBytes(extent.length);
+        
+        splitLines(buffer, lines);
+        parseStages(path, lines, 0, extent.headerLine + 1);
+    }
+}
+
 std::pair<TimingPath, size_t> TimingParser::parsePath(
-    const std::vector<std::string>& lines, size_t startLine) {
+    const ReportLines& lines, size_t startLine) {
     
     TimingPath path;
     
@@ -60,28 +347,37 @@ std::pair<TimingPath, size_t> TimingParser::parsePath(
     path.startpoint = startpoint;
     path.endpoint = endpoint;
     path.totalDelay = delay;
-    
-    // Move to the next line
-    size_t lineIndex = startLine + 1;
+    path.startpointId = internName(path.startpoint);
+    path.endpointId = internName(path.endpoint);
     
     // Parse path stages until we reach the end of the path section
+    size_t lineIndex = parseStages(path, lines, startLine + 1);
+    
+    return {path, lineIndex};
+}
+
+size_t TimingParser::parseStages(TimingPath& path, const ReportLines& lines,
+                                 size_t firstLine, size_t lineBase) {
+    const std::string stagePrefix = path.id + ".";
+    size_t lineIndex = firstLine;
+    
     while (lineIndex < lines.size()) {
         const auto& line = lines[lineIndex];
         
         // Check if we've reached the end of the path section
-        if (line.empty() || line.find("Path ") == 0 || line.find("End of") != std::string::npos) {
+        if (endsPathSection(line)) {
             break;
         }
         
         // Check if this is a path stage line
-        if (line.find(path.id + ".") != std::string::npos) {
+        if (line.find(stagePrefix) != std::string::npos) {
             try {
                 auto edge = parsePathStage(line);
                 if (edge) {
                     path.edges.push_back(edge);
                 }
             } catch (const std::exception& e) {
-                std::cerr << "Warning: Failed to parse stage at line " << lineIndex 
+                std::cerr << "Warning: Failed to parse stage at line " << lineIndex + lineBase
                           << ": " << e.what() << std::endl;
             }
         }
@@ -89,103 +385,214 @@ std::pair<TimingPath, size_t> TimingParser::parsePath(
         lineIndex++;
     }
     
-    return {path, lineIndex};
+    return lineIndex;
 }
 
 std::tuple<std::string, std::string, std::string, double> 
 TimingParser::parsePathHeader(const std::string& line) {
     // Example header: "Path P1     FF_Q        PI          2.345"
-    std::string id, startpoint, endpoint;
-    double delay = 0.0;
-    
-    std::regex headerPattern(R"(Path\s+(\S+)\s+(\S+)\s+(\S+)\s+([\d\.]+))");
-    std::smatch matches;
-    
-    if (std::regex_search(line, matches, headerPattern) && matches.size() >= 5) {
-        id = matches[1].str();
-        endpoint = matches[2].str();
-        startpoint = matches[3].str();
-        delay = std::stod(matches[4].str());
-    } else {
+    HeaderFields fields;
+    if (!splitHeader(line, fields)) {
         throw std::runtime_error("Invalid path header format: " + line);
     }
     
-    return {id, startpoint, endpoint, delay};
+    return {std::string(fields.token[0], fields.length[0]),
+            std::string(fields.token[2], fields.length[2]),
+            std::string(fields.token[1], fields.length[1]), fields.delay};
 }
 
 std::shared_ptr<TimingEdge> TimingParser::parsePathStage(const std::string& line) {
+    StageFields stage;
+    return matchStage(line, stage) ? makeEdge(stage.fromName, stage.toName, stage.delay) : nullptr;
+}
+
+bool TimingParser::matchStage(const std::string& line, StageFields& stage) {
     // Example stage: "P1.1   NET1        PI          0.123"
-    std::regex stagePattern(R"((\S+\.\d+)\s+(\S+)\s+(\S+)\s+([\d\.]+))");
+    static const std::regex stagePattern(R"((\S+\.\d+)\s+(\S+)\s+(\S+)\s+([\d\.]+))");
     std::smatch matches;
     
     if (std::regex_search(line, matches, stagePattern) && matches.size() >= 5) {
-        std::string stageId = matches[1].str();
-        std::string toName = matches[2].str();
-        std::string fromName = matches[3].str();
-        double delay = std::stod(matches[4].str());
-        
-        // Get or create nodes
-        std::shared_ptr<TimingNode> fromNode;
-        std::shared_ptr<TimingNode> toNode;
-        
-        auto fromIt = nodeCache.find(fromName);
-        if (fromIt != nodeCache.end()) {
-            fromNode = fromIt->second;
-        } else {
-            // Try to determine node type based on name patterns
-            std::string fromType = "unknown";
-            if (fromName.find("NET") != std::string::npos) {
-                fromType = "net";
-            } else if (fromName.find("FF") != std::string::npos || 
-                       fromName.find("FLOP") != std::string::npos) {
-                fromType = "flop";
-            } else if (fromName.find("PI") != std::string::npos) {
-                fromType = "primary_input";
-            }
-            
-            fromNode = std::make_shared<TimingNode>(fromName, fromType);
-            nodeCache[fromName] = fromNode;
+        stage.toName = matches[2].str();
+        stage.fromName = matches[3].str();
+        stage.delay = std::stod(matches[4].str());
+        return true;
+    }
+    return false;
+}
+
+std::shared_ptr<TimingEdge> TimingParser::makeEdge(const std::string& fromName,
+                                                   const std::string& toName, double delay) {
+    // Get or create nodes; a name seen only in headers has an ID but no node yet
+    uint32_t fromId = internName(fromName);
+    uint32_t toId = internName(toName);
+    
+    if (!nodes[fromId]) {
+        // Try to determine node type based on name patterns
+        std::string fromType = "unknown";
+        if (fromName.find("NET") != std::string::npos) {
+            fromType = "net";
+        } else if (fromName.find("FF") != std::string::npos || 
+                   fromName.find("FLOP") != std::string::npos) {
+            fromType = "flop";
+        } else if (fromName.find("PI") != std::string::npos) {
+            fromType = "primary_input";
         }
         
-        auto toIt = nodeCache.find(toName);
-        if (toIt != nodeCache.end()) {
-            toNode = toIt->second;
-        } else {
-            // Try to determine node type based on name patterns
-            std::string toType = "unknown";
-            if (toName.find("NET") != std::string::npos) {
-                toType = "net";
-            } else if (toName.find("INV") != std::string::npos) {
-                toType = "inverter";
-            } else if (toName.find("BUF") != std::string::npos) {
-                toType = "buffer";
-            } else if (toName.find("NAND") != std::string::npos) {
-                toType = "nand";
-            } else if (toName.find("NOR") != std::string::npos) {
-                toType = "nor";
-            } else if (toName.find("FF") != std::string::npos || 
-                       toName.find("FLOP") != std::string::npos) {
-                toType = "flop";
-            } else if (toName.find("PO") != std::string::npos) {
-                toType = "primary_output";
-            }
-            
-            toNode = std::make_shared<TimingNode>(toName, toType);
-            nodeCache[toName] = toNode;
+        nodes[fromId] = std::make_shared<TimingNode>(fromName, fromType);
+        nodes[fromId]->id = fromId;
+    }
+    
+    if (!nodes[toId]) {
+        // Try to determine node type based on name patterns
+        std::string toType = "unknown";
+        if (toName.find("NET") != std::string::npos) {
+            toType = "net";
+        } else if (toName.find("INV") != std::string::npos) {
+            toType = "inverter";
+        } else if (toName.find("BUF") != std::string::npos) {
+            toType = "buffer";
+        } else if (toName.find("NAND") != std::string::npos) {
+            toType = "nand";
+        } else if (toName.find("NOR") != std::string::npos) {
+            toType = "nor";
+        } else if (toName.find("FF") != std::string::npos || 
+                   toName.find("FLOP") != std::string::npos) {
+            toType = "flop";
+        } else if (toName.find("PO") != std::string::npos) {
+            toType = "primary_output";
         }
         
-        // Create edge
-        auto edge = std::make_shared<TimingEdge>(fromNode, toNode, delay);
-        
-        // Determine if delay is net or cell delay based on the from/to types
-        if (fromNode->type == "net") {
-            edge->netDelay = delay;
-        } else {
-            edge->cellDelay = delay;
+        nodes[toId] = std::make_shared<TimingNode>(toName, toType);
+        nodes[toId]->id = toId;
+    }
+    
+    const auto& fromNode = nodes[fromId];
+    const auto& toNode = nodes[toId];
+    
+    // Create edge
+    auto edge = std::make_shared<TimingEdge>(fromNode, toNode, delay);
+    
+    // Determine if delay is net or cell delay based on the from/to types
+    if (fromNode->type == "net") {
+        edge->netDelay = delay;
+    } else {
+        edge->cellDelay = delay;
+    }
+    
+    return edge;
+}
+
+bool TimingParser::endsPathSection(const std::string& line) {
+    // A path section ends at a blank line, the next header or the report trailer
+    return line.empty() || line.find("Path ") == 0 || line.find("End of") != std::string::npos;
+}
+
+TimingPath TimingParser::parseSection(const std::string& text) {
+    ReportLines lines;
+    splitLines(text, lines);
+    if (lines.empty() || lines[0].find("Path ") != 0) {
+        throw std::runtime_error("Not a path section");
+    }
+    return parsePath(lines, 0).first;
+}
+
+void TimingParser::beginFile() {
+    haveClockPeriod = false;
+    warnedNoClockPeriod = false;
+}
+
+void TimingParser::noteReportLine(const std::string& line) {
+    // e.g. "Clock Period: 10.0 ns"
+    static const std::string prefix = "Clock Period:";
+    if (!haveClockPeriod && line.compare(0, prefix.size(), prefix) == 0) {
+        char* end = nullptr;
+        double period = std::strtod(line.c_str() + prefix.size(), &end);
+        if (end != line.c_str() + prefix.size()) {
+            clockPeriod = period;
+            haveClockPeriod = true;
+        }
+    }
+}
+
+bool TimingParser::rejectHeader(const std::string& line) {
+    HeaderFields fields;
+    if (!splitHeader(line, fields)) {
+        // Malformed headers are left to parsePathHeader to report, and must
+        // not move the endpoint table or the cutoff
+        return false;
+    }
+    double delay = fields.delay;
+    
+    double threshold = minDelay;
+    if (useSlack) {
+        if (haveClockPeriod) {
+            threshold = std::max(threshold, clockPeriod - maxSlack);
+        } else if (!warnedNoClockPeriod) {
+            std::cerr << "Warning: No Clock Period before the first path; "
+                      << "slack threshold not applied to this file" << std::endl;
+            warnedNoClockPeriod = true;
+        }
+    }
+    if (delay < threshold) {
+        ++rejected;
+        return true;
+    }
+    
+    if (uniqueEndpoints) {
+        headerEndpoint.assign(fields.token[1], fields.length[1]);
+        auto [it, inserted] = worstByEndpoint.try_emplace(headerEndpoint, delay);
+        if (!inserted) {
+            // Ties go to the earlier path, so only a worse delay replaces it
+            if (delay <= it->second) {
+                ++rejected;
+                return true;
+            }
+            it->second = delay;
         }
-        
-        return edge;
     }
     
-    return nullptr;
-} 
\ No newline at end of file
+    if (topKCutoff > 0) {
+        if (bestDelays.size() == topKCutoff) {
+            // Ties go to the earlier path, so an equal delay cannot get in
+            if (delay <= bestDelays.top()) {
+                ++rejected;
+                return true;
+            }
+            bestDelays.pop();
+        }
+        bestDelays.push(delay);
+    }
+    return false;
+}
+
+bool TimingParser::isWorstForEndpoint(const TimingPath& path) const {
+    if (!uniqueEndpoints) {
+        return true;
+    }
+    auto it = worstByEndpoint.find(path.endpoint);
+    return it == worstByEndpoint.end() || it->second == path.totalDelay;
+}
+
+size_t TimingParser::rowFor(uint32_t endpointId, size_t rows, EndpointRows& endpointRows) const {
+    if (!uniqueEndpoints) {
+        return rows;
+    }
+    // rejectHeader() let this path through, so it beats the one it replaces
+    return endpointRows.try_emplace(endpointId, rows).first->second;
+}
+
+uint32_t TimingParser::findNodeId(const std::string& name) const {
+    auto it = nodeIds.find(name);
+    return it != nodeIds.end() ? it->second : kInvalidNodeId;
+}
+
+uint32_t TimingParser::internName(const std::string& name) {
+    Profiler::ScopedTimer timer(Profiler::Phase::Intern, Profiler::Clocks::WallOnly);
+    timer.addItems(1);
+    auto [it, inserted] = nodeIds.try_emplace(name, static_cast<uint32_t>(nodes.size()));
+    if (inserted) {
+        nodes.emplace_back();
+        nodeNames.push_back(&it->first);
+    }
+    return it->second;
+}
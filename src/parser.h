@@ -5,20 +5,30 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <queue>
 #include <string>
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include "mem_stats.h"
+
+// ID of a node that has not been interned by a parser
+constexpr uint32_t kInvalidNodeId = std::numeric_limits<uint32_t>::max();
 
 /**
  * @struct TimingNode
  * @brief Represents a node in a timing path (e.g., cell or pin)
  */
-struct TimingNode {
+struct TimingNode : MemoryStats::Tracked<TimingNode, MemoryStats::Category::NodeTable> {
     std::string name;
     std::string type;       // e.g., "flop", "gate", "pin"
     double capacitance{0.0};
     double slew{0.0};
+    uint32_t id{kInvalidNodeId};  // Interned ID, dense per parser
     
     TimingNode(std::string name, std::string type) 
         : name(std::move(name)), type(std::move(type)) {}
@@ -28,7 +38,7 @@ struct TimingNode {
  * @struct TimingEdge
  * @brief Represents a connection between two TimingNodes
  */
-struct TimingEdge {
+struct TimingEdge : MemoryStats::Tracked<TimingEdge, MemoryStats::Category::Edges> {
     std::shared_ptr<TimingNode> from;
     std::shared_ptr<TimingNode> to;
     double delay{0.0};
@@ -45,12 +55,15 @@ struct TimingEdge {
  * @struct TimingPath
  * @brief Represents a complete timing path from startpoint to endpoint
  */
-struct TimingPath {
+struct TimingPath : MemoryStats::Tracked<TimingPath, MemoryStats::Category::Paths> {
     std::string id;
     std::string startpoint;
     std::string endpoint;
     double totalDelay{0.0};
-    std::vector<std::shared_ptr<TimingEdge>> edges;
+    uint32_t startpointId{kInvalidNodeId};  // Interned startpoint name
+    uint32_t endpointId{kInvalidNodeId};    // Interned endpoint name
+    std::vector<std::shared_ptr<TimingEdge>,
+                MemoryStats::Allocator<std::shared_ptr<TimingEdge>, MemoryStats::Category::Paths>> edges;
     
     // Calculate worst stage delay and its location
     std::pair<double, std::shared_ptr<TimingEdge>> getWorstStage() const {
@@ -76,12 +89,33 @@ struct TimingPath {
     }
 };
 
+/**
+ * @struct PathExtent
+ * @brief Where a path's stage lines are in its report, recorded by scanFile()
+ */
+struct PathExtent {
+    uint32_t file{0};          // Index of the scanned file
+    uint32_t headerLength{0};  // Bytes of the header line, newline included
+    uint64_t offset{0};        // Byte offset of the first line after the header
+    uint64_t length{0};        // Bytes of stage lines up to the end of the path
+    uint32_t headerLine{0};    // Zero-based line number of the header
+    uint32_t lineCount{0};     // Number of lines in the stage section
+};
+
 /**
  * @class TimingParser
  * @brief Parses static timing reports into TimingPath objects
  */
 class TimingParser {
 public:
+    TimingParser() = default;
+    
+    // nodeNames points into nodeIds, so parsers can be moved but not copied
+    TimingParser(const TimingParser&) = delete;
+    TimingParser& operator=(const TimingParser&) = delete;
+    TimingParser(TimingParser&&) = default;
+    TimingParser& operator=(TimingParser&&) = default;
+    
     /**
      * @brief Parse timing report from a file
      * @param filename Path to timing report file
@@ -89,22 +123,224 @@ public:
      */
     std::vector<TimingPath> parseFile(const std::string& filename);
     
+    /**
+     * @brief Parse a timing report that is already in memory
+     * @param name Report name for trace spans
+     * @param data Report text
+     * @param size Bytes of report text
+     * @return Vector of TimingPath objects
+     */
+    std::vector<TimingPath> parseBuffer(const std::string& name, const char* data, size_t size);
+    
+    /**
+     * @brief First phase of a lazy parse: read only the path headers
+     * @param filename Path to timing report file
+     * @param extents Receives one extent per returned path
+     * @return Paths with ID, endpoints and total delay but no edges
+     * @throws std::runtime_error if the file cannot be opened
+     *
+     * Stage lines are skipped without being tokenized; loadStages() parses
+     * them later for the paths that are actually needed.
+     */
+    std::vector<TimingPath> scanFile(const std::string& filename,
+                                     std::vector<PathExtent>& extents);
+    
+    /**
+     * @brief scanFile() over a copy of the file's contents already in memory
+     * @param filename File the data was read from; loadStages() reads it again
+     * @param data File contents
+     * @param size Bytes of file contents
+     * @param extents Receives one extent per returned path
+     * @return Paths with ID, endpoints and total delay but no edges
+     */
+    std::vector<TimingPath> scanBuffer(const std::string& filename, const char* data, size_t size,
+                                       std::vector<PathExtent>& extents);
+    
+    /**
+     * @brief Second phase of a lazy parse: parse the stages of some paths
+     * @param paths Paths returned by scanFile(); selected ones get their edges
+     * @param extents Extents matching paths
+     * @param selected Positions in paths to load
+     * @throws std::runtime_error if a scanned file can no longer be read
+     */
+    void loadStages(std::vector<TimingPath>& paths, const std::vector<PathExtent>& extents,
+                    const std::vector<uint32_t>& selected);
+    
+    /**
+     * @brief Parse one path section held in memory
+     * @param text Header line followed by the path's stage lines
+     * @return The parsed path
+     * @throws std::runtime_error if text does not start with a valid header
+     */
+    TimingPath parseSection(const std::string& text);
+    
+    /**
+     * @brief Check whether a line ends the stage section of a path
+     * @param line Report line
+     * @return True for blank lines, the next header and the report trailer
+     */
+    static bool endsPathSection(const std::string& line);
+    
+    /**
+     * @brief Skip paths whose total delay is below a threshold
+     * @param delay Smallest total delay to keep
+     *
+     * Thresholds are checked as soon as a header is read. A rejected path's
+     * stage lines are skipped without being tokenized, and nothing is interned
+     * or stored for it.
+     */
+    void setMinDelay(double delay) { minDelay = delay; }
+    
+    /**
+     * @brief Skip paths with more slack than a threshold
+     * @param slack Largest slack to keep, against each file's "Clock Period"
+     *
+     * Files without a Clock Period line before their first path are not
+     * filtered by slack.
+     */
+    void setMinSlack(double slack) {
+        maxSlack = slack;
+        useSlack = true;
+    }
+    
+    /**
+     * @brief Also skip paths that cannot reach the top K of the paths kept so far
+     * @param k Number of paths that will be ranked; 0 turns the cutoff off
+     *
+     * The K-th best delay seen so far raises the threshold as parsing goes on.
+     * Only use this when every kept path competes in a single top-K ranking;
+     * paths with the same delay as the K-th best are skipped because ties go
+     * to the earlier path. Calling it again restarts the running cutoff, so
+     * calling it before each file keeps each file's own top K.
+     */
+    void setTopKCutoff(size_t k) {
+        topKCutoff = k;
+        bestDelays = {};
+    }
+    
+    /**
+     * @brief Keep only the worst path to each endpoint
+     * @param unique True to drop every path that another path to its endpoint
+     *        beats; ties go to the earlier path
+     *
+     * Each header's delay is checked against the worst delay seen so far for
+     * its endpoint, across every file this parser reads. A dominated path is
+     * skipped like a path below the delay threshold; a path that beats one
+     * already built in the same file takes its place. A path built from an
+     * earlier file stays in that file's result, so callers that merge files
+     * drop it with isWorstForEndpoint().
+     */
+    void setUniqueEndpoints(bool unique) { uniqueEndpoints = unique; }
+    
+    /**
+     * @brief Check whether a path is the worst seen for its endpoint
+     * @param path Path returned by this parser with setUniqueEndpoints()
+     * @return False if a later path to the same endpoint beat it
+     */
+    bool isWorstForEndpoint(const TimingPath& path) const;
+    
+    /**
+     * @brief Parse whole reports with a read / tokenize / build pipeline
+     * @param threads Tokenizer threads for parseFile(); 0 parses serially
+     *
+     * A reader thread and the tokenizers run alongside the calling thread,
+     * which builds the paths. Results are identical to a serial parse.
+     */
+    void setParseThreads(size_t threads) { parseThreads = threads; }
+    
+    /**
+     * @brief Get the number of paths rejected by the delay thresholds
+     * @return Rejected path count across all files parsed, including paths
+     *         dominated at their endpoint
+     */
+    size_t rejectedPaths() const { return rejected; }
+    
+    /**
+     * @brief Get the Clock Period of the file parsed or scanned last
+     * @return Period in ns, or NaN if that file had no Clock Period line
+     *         before its first path
+     */
+    double lastClockPeriod() const {
+        return haveClockPeriod ? clockPeriod : std::numeric_limits<double>::quiet_NaN();
+    }
+    
+    /**
+     * @brief Look up the interned ID of a node by name
+     * @param name Node name as it appears in headers or stage lines
+     * @return Node ID, or kInvalidNodeId if the name was never seen
+     */
+    uint32_t findNodeId(const std::string& name) const;
+    
+    /**
+     * @brief Get the number of nodes interned so far
+     * @return Node count; IDs are 0 .. nodeCount() - 1
+     */
+    size_t nodeCount() const { return nodes.size(); }
+    
+    /**
+     * @brief Get an interned node by ID
+     * @param id Node ID below nodeCount()
+     * @return The shared node object; null for names only seen in path headers
+     */
+    const std::shared_ptr<TimingNode>& getNode(uint32_t id) const { return nodes[id]; }
+    
+    /**
+     * @brief Get the name of an interned node
+     * @param id Node ID below nodeCount()
+     * @return The node name
+     */
+    const std::string& nodeName(uint32_t id) const { return *nodeNames[id]; }
+    
 private:
+    // Report lines held in memory while a file is parsed
+    using ReportLines = std::vector<std::string,
+        MemoryStats::Allocator<std::string, MemoryStats::Category::Lines>>;
+    
+    template <class T>
+    using NodeTableAllocator = MemoryStats::Allocator<T, MemoryStats::Category::NodeTable>;
+    
+    /**
+     * @brief Parse a whole report from a stream
+     * @param file Report text
+     * @return Parsed paths
+     */
+    std::vector<TimingPath> parseStream(std::istream& file);
+    
+    /**
+     * @brief Scan the headers of a report from a stream
+     * @param file Report text
+     * @param filename File to record for loadStages()
+     * @param extents Receives one extent per returned path
+     * @return Paths without edges
+     */
+    std::vector<TimingPath> scanStream(std::istream& file, const std::string& filename,
+                                       std::vector<PathExtent>& extents);
+    
     /**
      * @brief Parse a single timing path section from the report
      * @param lines Vector of lines from the report
      * @param startLine Line index where the path section starts
      * @return A TimingPath object and the next line to process
      */
-    std::pair<TimingPath, size_t> parsePath(
-        const std::vector<std::string>& lines, size_t startLine);
+    std::pair<TimingPath, size_t> parsePath(const ReportLines& lines, size_t startLine);
+    
+    /**
+     * @brief Parse the stage lines that follow a path header
+     * @param path Path to add edges to
+     * @param lines Lines holding the stage section
+     * @param firstLine Index of the first line after the header
+     * @param lineBase Added to line indices in warnings
+     * @return Index of the line that ended the section
+     */
+    size_t parseStages(TimingPath& path, const ReportLines& lines, size_t firstLine,
+                       size_t lineBase = 0);
     
     /**
      * @brief Parse a timing path header line
      * @param line Header line from the report
      * @return Extracted path ID, startpoint, endpoint, and total delay
      */
-    std::tuple<std::string, std::string, std::string, double> 
+    static std::tuple<std::string, std::string, std::string, double> 
     parsePathHeader(const std::string& line);
     
     /**
@@ -114,6 +350,105 @@ private:
      */
     std::shared_ptr<TimingEdge> parsePathStage(const std::string& line);
     
-    // Node cache to avoid creating duplicate nodes
-    std::unordered_map<std::string, std::shared_ptr<TimingNode>> nodeCache;
+    // Fields of a stage line, before any names are interned
+    struct StageFields {
+        std::string toName;
+        std::string fromName;
+        double delay{0.0};
+    };
+    
+    /**
+     * @brief Match a stage line without touching parser state
+     * @param line Stage line from the report
+     * @param stage Receives the node names and stage delay
+     * @return False if the line is not a stage line
+     */
+    static bool matchStage(const std::string& line, StageFields& stage);
+    
+    /**
+     * @brief Intern the names of a stage and create its edge
+     * @param fromName Driving node name
+     * @param toName Driven node name
+     * @param delay Stage delay
+     * @return The new edge
+     */
+    std::shared_ptr<TimingEdge> makeEdge(const std::string& fromName, const std::string& toName,
+                                         double delay);
+    
+    /**
+     * @brief Get the ID of a name, assigning the next free ID on first use
+     * @param name Node name
+     * @return Interned node ID
+     */
+    uint32_t internName(const std::string& name);
+    
+    // Row of each endpoint's path in the file being parsed
+    using EndpointRows = std::unordered_map<uint32_t, size_t>;
+    
+    /**
+     * @brief Choose the row for a newly built path
+     * @param endpointId Interned endpoint of the path
+     * @param rows Paths kept so far in the file being parsed
+     * @param endpointRows Rows already taken per endpoint in this file
+     * @return rows for a new row, or with setUniqueEndpoints() the row of the
+     *         path to the same endpoint that the new path beats
+     */
+    size_t rowFor(uint32_t endpointId, size_t rows, EndpointRows& endpointRows) const;
+    
+    /**
+     * @brief Reset per-file state before a file is parsed or scanned
+     */
+    void beginFile();
+    
+    /**
+     * @brief Pick up the clock period from a line outside any path
+     * @param line Report line
+     */
+    void noteReportLine(const std::string& line);
+    
+    /**
+     * @brief Decide from a header's total delay whether to skip its path
+     * @param line Header line from the report
+     * @return True if the path is below the current threshold
+     */
+    bool rejectHeader(const std::string& line);
+    
+    // Lets timing_bench time the per-line parsers directly
+    friend struct TimingParserBenchAccess;
+    
+    // Tokenizes on worker threads and builds paths through the private parsers
+    friend class ParsePipeline;
+    
+    // Checks a section's header against its top K before parsing the section
+    friend class ReportFollower;
+    
+    // Node cache to avoid creating duplicate nodes: name -> ID -> node
+    std::unordered_map<std::string, uint32_t, std::hash<std::string>, std::equal_to<std::string>,
+                       NodeTableAllocator<std::pair<const std::string, uint32_t>>> nodeIds;
+    std::vector<std::shared_ptr<TimingNode>, NodeTableAllocator<std::shared_ptr<TimingNode>>> nodes;
+    std::vector<const std::string*, NodeTableAllocator<const std::string*>> nodeNames;  // Keys of nodeIds, by ID
+    
+    std::vector<std::string> scannedFiles;  // Files named by PathExtent::file
+    size_t parseThreads{0};                 // parseFile() tokenizers; 0 parses serially
+    
+    // Early rejection thresholds and the best delays kept so far
+    double minDelay{-std::numeric_limits<double>::infinity()};
+    double maxSlack{0.0};
+    bool useSlack{false};
+    size_t topKCutoff{0};
+    std::priority_queue<double, std::vector<double>, std::greater<double>> bestDelays;
+    size_t rejected{0};
+    
+    // Worst delay per endpoint name with setUniqueEndpoints(). Keyed by name,
+    // not ID, because the pipeline's reader checks headers before the builder
+    // interns them
+    bool uniqueEndpoints{false};
+    std::unordered_map<std::string, double, std::hash<std::string>, std::equal_to<std::string>,
+                       NodeTableAllocator<std::pair<const std::string, double>>> worstByEndpoint;
+    std::string headerEndpoint;  // Scratch key for rejectHeader()
+    
+    // Clock period of the file being parsed
+    double clockPeriod{0.0};
+    bool haveClockPeriod{false};
+    bool warnedNoClockPeriod{false};
 }; 
\ No newline at end of file
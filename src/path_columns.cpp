@@ -0,0 +1,41 @@
+/**
+ * @file path_columns.cpp
+ * @brief Implementation of PathColumns
+ */
+
+#include "path_columns.h"
+#include <limits>
+
+PathColumns PathColumns::build(const std::vector<TimingPath>& paths,
+                               const std::vector<double>& clockPeriods) {
+    PathColumns columns;
+    columns.delay.reserve(paths.size());
+    columns.worstStageDelay.reserve(paths.size());
+    columns.stageCount.reserve(paths.size());
+    columns.startId.reserve(paths.size());
+    columns.endId.reserve(paths.size());
+    columns.netDelayShare.reserve(paths.size());
+    columns.slack.reserve(paths.size());
+
+    const double unknown = std::numeric_limits<double>::quiet_NaN();
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const auto& path = paths[i];
+        double netDelay = 0.0;
+        for (const auto& edge : path.edges) {
+            if (edge) {
+                netDelay += edge->netDelay;
+            }
+        }
+
+        columns.delay.push_back(path.totalDelay);
+        columns.worstStageDelay.push_back(path.getWorstStage().first);
+        columns.stageCount.push_back(static_cast<uint32_t>(path.edges.size()));
+        columns.startId.push_back(path.startpointId);
+        columns.endId.push_back(path.endpointId);
+        columns.netDelayShare.push_back(path.totalDelay > 0.0 ? netDelay / path.totalDelay : 0.0);
+        columns.slack.push_back(i < clockPeriods.size() ? clockPeriods[i] - path.totalDelay
+                                                        : unknown);
+    }
+
+    return columns;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file path_columns.h
+ * @brief Defines PathColumns, a column-oriented copy of per-path attributes
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "parser.h"
+
+/**
+ * @struct PathColumns
+ * @brief Per-path attributes stored one array per attribute
+ *
+ * Row i describes the path at position i of the vector the columns were built
+ * from. Filters and rankings scan these arrays instead of chasing the
+ * shared_ptr edges of every path.
+ */
+struct PathColumns {
+    std::vector<double> delay;             // Total path delay
+    std::vector<double> worstStageDelay;   // Largest single stage delay
+    std::vector<uint32_t> stageCount;      // Number of stages (edges)
+    std::vector<uint32_t> startId;         // Interned startpoint name
+    std::vector<uint32_t> endId;           // Interned endpoint name
+    std::vector<double> netDelayShare;     // Fraction of the delay spent in nets
+    std::vector<double> slack;             // Clock period minus delay; NaN if unknown
+
+    /**
+     * @brief Build the columns for a set of paths
+     * @param paths Parsed paths
+     * @param clockPeriods Clock period of each path's report, NaN where the
+     *        report has none; empty leaves every slack unknown
+     * @return Columns with one row per path
+     */
+    static PathColumns build(const std::vector<TimingPath>& paths,
+                             const std::vector<double>& clockPeriods = {});
+
+    /**
+     * @brief Get the number of rows
+     * @return Path count
+     */
+    size_t size() const { return delay.size(); }
+};
@@ -0,0 +1,119 @@
+/**
+ * @file path_index.cpp
+ * @brief Implementation of the PathIndex class
+ */
+
+#include "path_index.h"
+#include <stdexcept>
+
+namespace {
+
+// Number of bytes a LEB128 varint needs for a value
+size_t varintSize(uint32_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+// Call visit(nodeId) once for every distinct interned stage node of a path
+template <typename Visitor>
+void forEachPathNode(const TimingPath& path, uint32_t pathId, size_t nodeCount,
+                     std::vector<uint32_t>& lastSeen, Visitor visit) {
+    auto touch = [&](const std::shared_ptr<TimingNode>& node) {
+        if (!node || node->id >= nodeCount || lastSeen[node->id] == pathId) {
+            return;
+        }
+        lastSeen[node->id] = pathId;
+        visit(node->id);
+    };
+
+    for (const auto& edge : path.edges) {
+        if (!edge) continue;
+        touch(edge->from);
+        touch(edge->to);
+    }
+}
+
+} // namespace
+
+PathIndex PathIndex::build(const std::vector<TimingPath>& paths, size_t nodeCount) {
+    if (paths.size() >= kInvalidNodeId) {
+        throw std::runtime_error("Too many paths to index");
+    }
+
+    PathIndex index;
+    index.counts.assign(nodeCount, 0);
+    index.offsets.assign(nodeCount + 1, 0);
+
+    // Path ID of the previous posting per node; kInvalidNodeId before the first.
+    // The first delta is stored as pathId + 1 so that no delta is ever zero.
+    std::vector<uint32_t> lastSeen(nodeCount, kInvalidNodeId);
+    std::vector<uint32_t> previous(nodeCount, kInvalidNodeId);
+
+    // First pass: list lengths and encoded sizes, so lists can be written in place
+    for (uint32_t pathId = 0; pathId < paths.size(); ++pathId) {
+        forEachPathNode(paths[pathId], pathId, nodeCount, lastSeen, [&](uint32_t nodeId) {
+            uint32_t delta = pathId - previous[nodeId];
+            previous[nodeId] = pathId;
+            index.counts[nodeId]++;
+            index.offsets[nodeId + 1] += varintSize(delta);
+        });
+    }
+
+    for (size_t node = 0; node < nodeCount; ++node) {
+        index.offsets[node + 1] += index.offsets[node];
+    }
+    index.postings.resize(index.offsets[nodeCount]);
+
+    // Second pass: encode each posting at its node's write cursor
+    std::vector<uint64_t> cursor(index.offsets.begin(), index.offsets.end() - 1);
+    lastSeen.assign(nodeCount, kInvalidNodeId);
+    previous.assign(nodeCount, kInvalidNodeId);
+
+    for (uint32_t pathId = 0; pathId < paths.size(); ++pathId) {
+        forEachPathNode(paths[pathId], pathId, nodeCount, lastSeen, [&](uint32_t nodeId) {
+            uint32_t delta = pathId - previous[nodeId];
+            previous[nodeId] = pathId;
+
+            uint64_t& pos = cursor[nodeId];
+            while (delta >= 0x80) {
+                index.postings[pos++] = static_cast<uint8_t>(delta | 0x80);
+                delta >>= 7;
+            }
+            index.postings[pos++] = static_cast<uint8_t>(delta);
+        });
+    }
+
+    return index;
+}
+
+std::vector<uint32_t> PathIndex::pathsThrough(uint32_t nodeId) const {
+    std::vector<uint32_t> pathIds;
+    if (nodeId >= counts.size()) {
+        return pathIds;
+    }
+
+    pathIds.reserve(counts[nodeId]);
+    const uint8_t* data = postings.data() + offsets[nodeId];
+    const uint8_t* end = postings.data() + offsets[nodeId + 1];
+
+    uint32_t pathId = kInvalidNodeId;
+    while (data < end) {
+        uint32_t delta = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            byte = *data++;
+            delta |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+
+        pathId += delta;  // Wraps from kInvalidNodeId to the first path ID
+        pathIds.push_back(pathId);
+    }
+
+    return pathIds;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file path_index.h
+ * @brief Defines the PathIndex class mapping node IDs to the paths through them
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "parser.h"
+
+/**
+ * @class PathIndex
+ * @brief Inverted index from interned node ID to the IDs of paths through it
+ *
+ * A path ID is the path's position in the vector the index was built from.
+ * Each node's posting list holds ascending path IDs, delta-encoded as varints;
+ * all lists share one contiguous byte buffer, so a lookup only decodes the
+ * bytes of the matching paths.
+ */
+class PathIndex {
+public:
+    PathIndex() = default;
+
+    /**
+     * @brief Build the index over the stage nodes of a set of paths
+     * @param paths Parsed paths; a path's ID is its position in this vector
+     * @param nodeCount Number of interned nodes (TimingParser::nodeCount())
+     * @return The built index
+     */
+    static PathIndex build(const std::vector<TimingPath>& paths, size_t nodeCount);
+
+    /**
+     * @brief Get the IDs of all paths with a stage through a node
+     * @param nodeId Interned node ID
+     * @return Ascending path IDs; empty for unknown nodes
+     */
+    std::vector<uint32_t> pathsThrough(uint32_t nodeId) const;
+
+    /**
+     * @brief Get the number of paths through a node without decoding its list
+     * @param nodeId Interned node ID
+     * @return Posting list length
+     */
+    uint32_t pathCount(uint32_t nodeId) const {
+        return nodeId < counts.size() ? counts[nodeId] : 0;
+    }
+
+    /**
+     * @brief Get the number of nodes the index covers
+     * @return Node count
+     */
+    size_t nodeCount() const { return counts.size(); }
+
+    /**
+     * @brief Get the size of the encoded posting lists
+     * @return Buffer size in bytes
+     */
+    size_t encodedBytes() const { return postings.size(); }
+
+private:
+    // Byte offset of each node's list in postings; one extra entry marks the end
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> counts;
+    std::vector<uint8_t> postings;
+};
@@ -0,0 +1,150 @@
+/**
+ * @file profiler.cpp
+ * @brief Implementation of the phase profiler
+ */
+
+#include "profiler.h"
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include "utils.h"
+
+namespace Profiler {
+
+namespace {
+
+struct PhaseTotals {
+    std::atomic<uint64_t> wallNs{0};
+    std::atomic<uint64_t> cpuNs{0};
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> items{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<bool> hasCpu{false};
+};
+
+PhaseTotals totals[static_cast<size_t>(Phase::Count)];
+std::atomic<uint64_t> enabledWall{0};
+std::atomic<uint64_t> enabledCpu{0};
+
+const char* phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::FileRead: return "file read";
+        case Phase::Parse: return "parse";
+        case Phase::Intern: return "  intern";
+        case Phase::Index: return "index";
+        case Phase::Filter: return "filter";
+        case Phase::Rank: return "rank";
+        case Phase::LoadStages: return "load stages";
+        case Phase::Analyze: return "analyze";
+        case Phase::Output: return "output";
+        default: return "?";
+    }
+}
+
+// Right-align text that may contain multi-byte UTF-8 (formatTime uses "μs")
+std::string padLeft(const std::string& text, size_t width) {
+    size_t chars = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80) {
+            ++chars;
+        }
+    }
+    return std::string(width > chars ? width - chars : 0, ' ') + text;
+}
+
+std::string formatRate(double perSecond, const char* unit) {
+    std::stringstream result;
+    result << std::fixed << std::setprecision(perSecond < 100 ? 2 : 0) << perSecond << unit;
+    return result.str();
+}
+
+double seconds(uint64_t ns) {
+    return static_cast<double>(ns) * 1e-9;
+}
+
+} // namespace
+
+namespace detail {
+
+std::atomic<bool> enabled{false};
+
+uint64_t wallNow() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(
+        duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// Process CPU, so phases that fan out to worker threads are fully charged
+uint64_t cpuNow() {
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void record(Phase phase, uint64_t wallNs, uint64_t cpuNs, bool hasCpu,
+            uint64_t items, uint64_t bytes) {
+    PhaseTotals& t = totals[static_cast<size_t>(phase)];
+    t.wallNs.fetch_add(wallNs, std::memory_order_relaxed);
+    t.cpuNs.fetch_add(cpuNs, std::memory_order_relaxed);
+    t.calls.fetch_add(1, std::memory_order_relaxed);
+    t.items.fetch_add(items, std::memory_order_relaxed);
+    t.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (hasCpu) {
+        t.hasCpu.store(true, std::memory_order_relaxed);
+    }
+}
+
+} // namespace detail
+
+void setEnabled(bool on) {
+    if (on) {
+        for (auto& t : totals) {
+            t.wallNs = 0;
+            t.cpuNs = 0;
+            t.calls = 0;
+            t.items = 0;
+            t.bytes = 0;
+            t.hasCpu = false;
+        }
+        enabledWall = detail::wallNow();
+        enabledCpu = detail::cpuNow();
+    }
+    detail::enabled.store(on, std::memory_order_relaxed);
+}
+
+std::string report() {
+    std::stringstream out;
+    out << "Profile (parse includes intern; CPU is process time):\n"
+        << std::left << std::setw(12) << "Phase" << std::right
+        << std::setw(12) << "Wall" << std::setw(12) << "CPU"
+        << std::setw(10) << "Calls" << std::setw(12) << "Items"
+        << std::setw(14) << "Items/s" << std::setw(12) << "MB/s" << "\n";
+
+    for (size_t i = 0; i < static_cast<size_t>(Phase::Count); ++i) {
+        const PhaseTotals& t = totals[i];
+        uint64_t calls = t.calls.load();
+        if (calls == 0) {
+            continue;
+        }
+
+        double wall = seconds(t.wallNs.load());
+        uint64_t items = t.items.load();
+        uint64_t bytes = t.bytes.load();
+        out << std::left << std::setw(12) << phaseName(static_cast<Phase>(i)) << std::right
+            << padLeft(Utils::formatTime(wall), 12)
+            << padLeft(t.hasCpu.load() ? Utils::formatTime(seconds(t.cpuNs.load())) : "-", 12)
+            << std::setw(10) << calls
+            << std::setw(12) << (items ? std::to_string(items) : "-")
+            << std::setw(14) << (items && wall > 0 ? formatRate(items / wall, "/s") : "-")
+            << std::setw(12) << (bytes && wall > 0 ? formatRate(bytes / wall / 1e6, "") : "-")
+            << "\n";
+    }
+
+    out << std::left << std::setw(12) << "total" << std::right
+        << padLeft(Utils::formatTime(seconds(detail::wallNow() - enabledWall.load())), 12)
+        << padLeft(Utils::formatTime(seconds(detail::cpuNow() - enabledCpu.load())), 12) << "\n";
+    return out.str();
+}
+
+} // namespace Profiler
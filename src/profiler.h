@@ -0,0 +1,130 @@
+/**
+ * @file profiler.h
+ * @brief Scoped phase timers behind the --profile option
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @namespace Profiler
+ * @brief Per-phase wall time, CPU time and throughput counters
+ *
+ * Timers are compiled in everywhere. While profiling is off a ScopedTimer
+ * costs one load and one predictable branch in its constructor and
+ * destructor; no clocks are read and nothing is recorded.
+ */
+namespace Profiler {
+
+/**
+ * @enum Phase
+ * @brief Stages of a run, in the order they are reported
+ */
+enum class Phase {
+    FileRead,   // Reading report lines into memory
+    Parse,      // Turning lines into paths; includes Intern
+    Intern,     // Mapping node names to IDs
+    Index,      // Building path indexes, bitmaps and columns
+    Filter,     // Evaluating --through / --where selections
+    Rank,       // Selecting the top-K paths
+    LoadStages, // Parsing stage lines of selected paths after a header scan
+    Analyze,    // Worst-stage analysis and suggestions
+    Output,     // Formatting and writing results
+    Count
+};
+
+/**
+ * @enum Clocks
+ * @brief Which clocks a timer reads
+ */
+enum class Clocks {
+    WallAndCpu,   // For coarse phases
+    WallOnly      // For timers around very short, very frequent calls
+};
+
+namespace detail {
+
+extern std::atomic<bool> enabled;
+
+/**
+ * @brief Add one finished timer to its phase totals
+ */
+void record(Phase phase, uint64_t wallNs, uint64_t cpuNs, bool hasCpu,
+            uint64_t items, uint64_t bytes);
+
+uint64_t wallNow();
+uint64_t cpuNow();
+
+} // namespace detail
+
+/**
+ * @brief Check whether profiling is on
+ * @return True if timers record
+ */
+inline bool enabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Turn profiling on or off; turning it on clears previous totals
+ * @param on New state
+ */
+void setEnabled(bool on);
+
+/**
+ * @class ScopedTimer
+ * @brief Times its own lifetime and charges it to a phase
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Phase phase, Clocks clocks = Clocks::WallAndCpu)
+        : phase(phase), active(enabled()), cpu(clocks == Clocks::WallAndCpu) {
+        if (active) {
+            wallStart = detail::wallNow();
+            cpuStart = cpu ? detail::cpuNow() : 0;
+        }
+    }
+
+    ~ScopedTimer() {
+        if (active) {
+            uint64_t wall = detail::wallNow() - wallStart;
+            uint64_t cpuTime = cpu ? detail::cpuNow() - cpuStart : 0;
+            detail::record(phase, wall, cpuTime, cpu, items, bytes);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    /**
+     * @brief Count items (lines, paths, names...) processed in this scope
+     * @param count Items to add
+     */
+    void addItems(uint64_t count) { items += count; }
+
+    /**
+     * @brief Count bytes processed in this scope
+     * @param count Bytes to add
+     */
+    void addBytes(uint64_t count) { bytes += count; }
+
+private:
+    Phase phase;
+    bool active;
+    bool cpu;
+    uint64_t wallStart{0};
+    uint64_t cpuStart{0};
+    uint64_t items{0};
+    uint64_t bytes{0};
+};
+
+/**
+ * @brief Format the per-phase table
+ * @return Table with wall time, CPU time, calls, items, items/s and MB/s
+ */
+std::string report();
+
+} // namespace Profiler
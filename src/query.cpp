@@ -0,0 +1,620 @@
+/**
+ * @file query.cpp
+ * @brief Implementation of PathQuery and SelectionBitmap
+ */
+
+#include "query.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define TIMING_QUERY_SSE2 1
+#endif
+
+// ---------------------------------------------------------------------------
+// SelectionBitmap
+// ---------------------------------------------------------------------------
+
+SelectionBitmap::SelectionBitmap(size_t size, bool value)
+    : bits(size), words((size + 63) / 64, value ? ~uint64_t{0} : 0) {
+    clearTail();
+}
+
+size_t SelectionBitmap::count() const {
+    size_t total = 0;
+    for (uint64_t word : words) {
+        total += static_cast<size_t>(__builtin_popcountll(word));
+    }
+    return total;
+}
+
+std::vector<uint32_t> SelectionBitmap::toIds() const {
+    std::vector<uint32_t> ids;
+    ids.reserve(count());
+    for (size_t w = 0; w < words.size(); ++w) {
+        uint64_t word = words[w];
+        while (word) {
+            ids.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+    return ids;
+}
+
+SelectionBitmap& SelectionBitmap::operator&=(const SelectionBitmap& other) {
+    for (size_t w = 0; w < words.size(); ++w) {
+        words[w] &= other.words[w];
+    }
+    return *this;
+}
+
+SelectionBitmap& SelectionBitmap::operator|=(const SelectionBitmap& other) {
+    for (size_t w = 0; w < words.size(); ++w) {
+        words[w] |= other.words[w];
+    }
+    return *this;
+}
+
+void SelectionBitmap::flip() {
+    for (auto& word : words) {
+        word = ~word;
+    }
+    clearTail();
+}
+
+void SelectionBitmap::clearTail() {
+    if (bits % 64 != 0) {
+        words.back() &= (uint64_t{1} << (bits % 64)) - 1;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Column scan kernels
+// ---------------------------------------------------------------------------
+
+namespace {
+
+template <CompareOp Op, typename T>
+inline bool compareScalar(T a, T b) {
+    if constexpr (Op == CompareOp::Less) return a < b;
+    if constexpr (Op == CompareOp::LessEqual) return a <= b;
+    if constexpr (Op == CompareOp::Greater) return a > b;
+    if constexpr (Op == CompareOp::GreaterEqual) return a >= b;
+    if constexpr (Op == CompareOp::Equal) return a == b;
+    if constexpr (Op == CompareOp::NotEqual) return a != b;
+}
+
+// Fill bitmap words from index `firstWord` on with a branch-free scalar loop
+template <CompareOp Op, typename T>
+void compareTail(const T* column, size_t n, T value, size_t firstWord, uint64_t* out) {
+    for (size_t base = firstWord * 64; base < n; base += 64) {
+        size_t end = std::min(n, base + 64);
+        uint64_t word = 0;
+        for (size_t i = base; i < end; ++i) {
+            word |= static_cast<uint64_t>(compareScalar<Op>(column[i], value)) << (i - base);
+        }
+        out[base / 64] = word;
+    }
+}
+
+#ifdef TIMING_QUERY_SSE2
+
+// Two-lane double compare returning a 2-bit lane mask
+template <CompareOp Op>
+inline int compareLanes(__m128d a, __m128d b) {
+    if constexpr (Op == CompareOp::Less) return _mm_movemask_pd(_mm_cmplt_pd(a, b));
+    if constexpr (Op == CompareOp::LessEqual) return _mm_movemask_pd(_mm_cmple_pd(a, b));
+    if constexpr (Op == CompareOp::Greater) return _mm_movemask_pd(_mm_cmpgt_pd(a, b));
+    if constexpr (Op == CompareOp::GreaterEqual) return _mm_movemask_pd(_mm_cmpge_pd(a, b));
+    if constexpr (Op == CompareOp::Equal) return _mm_movemask_pd(_mm_cmpeq_pd(a, b));
+    if constexpr (Op == CompareOp::NotEqual) return _mm_movemask_pd(_mm_cmpneq_pd(a, b));
+}
+
+// Four-lane unsigned compare returning a 4-bit lane mask. SSE2 only has signed
+// compares, so both sides are biased by 2^31 first.
+template <CompareOp Op>
+inline int compareLanes(__m128i a, __m128i b) {
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    a = _mm_xor_si128(a, bias);
+    b = _mm_xor_si128(b, bias);
+    auto mask = [](__m128i m) { return _mm_movemask_ps(_mm_castsi128_ps(m)); };
+
+    if constexpr (Op == CompareOp::Less) return mask(_mm_cmplt_epi32(a, b));
+    if constexpr (Op == CompareOp::LessEqual) return mask(_mm_cmpgt_epi32(a, b)) ^ 0xf;
+    if constexpr (Op == CompareOp::Greater) return mask(_mm_cmpgt_epi32(a, b));
+    if constexpr (Op == CompareOp::GreaterEqual) return mask(_mm_cmplt_epi32(a, b)) ^ 0xf;
+    if constexpr (Op == CompareOp::Equal) return mask(_mm_cmpeq_epi32(a, b));
+    if constexpr (Op == CompareOp::NotEqual) return mask(_mm_cmpeq_epi32(a, b)) ^ 0xf;
+}
+
+template <CompareOp Op>
+void compareKernel(const double* column, size_t n, double value, uint64_t* out) {
+    const __m128d threshold = _mm_set1_pd(value);
+    size_t fullWords = n / 64;
+    for (size_t w = 0; w < fullWords; ++w) {
+        const double* block = column + w * 64;
+        uint64_t word = 0;
+        for (size_t j = 0; j < 64; j += 2) {
+            word |= static_cast<uint64_t>(compareLanes<Op>(_mm_loadu_pd(block + j), threshold)) << j;
+        }
+        out[w] = word;
+    }
+    compareTail<Op>(column, n, value, fullWords, out);
+}
+
+template <CompareOp Op>
+void compareKernel(const uint32_t* column, size_t n, uint32_t value, uint64_t* out) {
+    const __m128i threshold = _mm_set1_epi32(static_cast<int>(value));
+    size_t fullWords = n / 64;
+    for (size_t w = 0; w < fullWords; ++w) {
+        const uint32_t* block = column + w * 64;
+        uint64_t word = 0;
+        for (size_t j = 0; j < 64; j += 4) {
+            __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + j));
+            word |= static_cast<uint64_t>(compareLanes<Op>(lanes, threshold)) << j;
+        }
+        out[w] = word;
+    }
+    compareTail<Op>(column, n, value, fullWords, out);
+}
+
+#else
+
+template <CompareOp Op, typename T>
+void compareKernel(const T* column, size_t n, T value, uint64_t* out) {
+    compareTail<Op>(column, n, value, 0, out);
+}
+
+#endif
+
+// Compare every value of a column against a constant into a bitmap
+template <typename T>
+SelectionBitmap compareColumn(const std::vector<T>& column, CompareOp op, T value) {
+    SelectionBitmap result(column.size());
+    const T* data = column.data();
+    size_t n = column.size();
+    uint64_t* out = result.data();
+
+    switch (op) {
+        case CompareOp::Less: compareKernel<CompareOp::Less>(data, n, value, out); break;
+        case CompareOp::LessEqual: compareKernel<CompareOp::LessEqual>(data, n, value, out); break;
+        case CompareOp::Greater: compareKernel<CompareOp::Greater>(data, n, value, out); break;
+        case CompareOp::GreaterEqual: compareKernel<CompareOp::GreaterEqual>(data, n, value, out); break;
+        case CompareOp::Equal: compareKernel<CompareOp::Equal>(data, n, value, out); break;
+        case CompareOp::NotEqual: compareKernel<CompareOp::NotEqual>(data, n, value, out); break;
+    }
+
+    return result;
+}
+
+// Select the rows whose ID is in a pre-resolved set; IDs past the set never match
+SelectionBitmap matchIdSet(const std::vector<uint32_t>& column, const std::vector<uint8_t>& idSet) {
+    SelectionBitmap result(column.size());
+    uint64_t* out = result.data();
+    uint32_t limit = static_cast<uint32_t>(idSet.size() - 1);  // Last entry is always 0
+
+    for (size_t base = 0; base < column.size(); base += 64) {
+        size_t end = std::min(column.size(), base + 64);
+        uint64_t word = 0;
+        for (size_t i = base; i < end; ++i) {
+            word |= static_cast<uint64_t>(idSet[std::min(column[i], limit)]) << (i - base);
+        }
+        out[base / 64] = word;
+    }
+
+    return result;
+}
+
+// Glob match supporting '*' (any run) and '?' (any single character)
+bool globMatch(const std::string& pattern, const std::string& text) {
+    size_t p = 0, t = 0;
+    size_t star = std::string::npos, mark = 0;
+
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            ++p;
+            ++t;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            mark = t;
+        } else if (star != std::string::npos) {
+            p = star + 1;
+            t = ++mark;
+        } else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+// Resolve a name or glob to the interned IDs it matches
+std::vector<uint32_t> resolveNames(const TimingParser& parser, const std::string& pattern, bool glob) {
+    std::vector<uint32_t> ids;
+    if (!glob) {
+        uint32_t id = parser.findNodeId(pattern);
+        if (id != kInvalidNodeId) {
+            ids.push_back(id);
+        }
+        return ids;
+    }
+
+    for (uint32_t id = 0; id < parser.nodeCount(); ++id) {
+        if (globMatch(pattern, parser.nodeName(id))) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+const char* compareOpName(CompareOp op) {
+    switch (op) {
+        case CompareOp::Less: return "<";
+        case CompareOp::LessEqual: return "<=";
+        case CompareOp::Greater: return ">";
+        case CompareOp::GreaterEqual: return ">=";
+        case CompareOp::Equal: return "==";
+        case CompareOp::NotEqual: return "!=";
+    }
+    return "?";
+}
+
+const char* fieldName(PathQuery::Field field) {
+    switch (field) {
+        case PathQuery::Field::Delay: return "delay";
+        case PathQuery::Field::WorstStage: return "worst";
+        case PathQuery::Field::Stages: return "stages";
+        case PathQuery::Field::Startpoint: return "startpoint";
+        case PathQuery::Field::Endpoint: return "endpoint";
+    }
+    return "?";
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Compiler
+// ---------------------------------------------------------------------------
+
+/**
+ * @class QueryCompiler
+ * @brief Recursive-descent parser emitting a PathQuery's postfix plan
+ */
+class QueryCompiler {
+public:
+    explicit QueryCompiler(const std::string& text) : text(text) { advance(); }
+
+    PathQuery compile() {
+        PathQuery query;
+        plan = &query.plan;
+        parseOr();
+        if (token.kind != Token::End) {
+            fail("unexpected '" + token.text + "'");
+        }
+        return query;
+    }
+
+private:
+    struct Token {
+        enum Kind { End, Word, String, Number, Operator, LParen, RParen };
+        Kind kind{End};
+        std::string text;
+    };
+
+    using Step = PathQuery::PlanStep;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::invalid_argument("Invalid query at position " + std::to_string(tokenStart) +
+                                    ": " + message);
+    }
+
+    static bool isOperatorChar(char c) {
+        return c == '<' || c == '>' || c == '=' || c == '!' || c == '~';
+    }
+
+    void advance() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+        tokenStart = pos;
+        token = Token{};
+
+        if (pos >= text.size()) {
+            return;
+        }
+
+        char c = text[pos];
+        if (c == '(' || c == ')') {
+            token.kind = c == '(' ? Token::LParen : Token::RParen;
+            token.text = std::string(1, c);
+            ++pos;
+        } else if (c == '"') {
+            size_t close = text.find('"', pos + 1);
+            if (close == std::string::npos) {
+                fail("unterminated string");
+            }
+            token.kind = Token::String;
+            token.text = text.substr(pos + 1, close - pos - 1);
+            pos = close + 1;
+        } else if (isOperatorChar(c)) {
+            size_t end = pos + 1;
+            if (end < text.size() && text[end] == '=') {
+                ++end;
+            }
+            token.kind = Token::Operator;
+            token.text = text.substr(pos, end - pos);
+            pos = end;
+        } else {
+            size_t end = pos;
+            while (end < text.size() && !std::isspace(static_cast<unsigned char>(text[end])) &&
+                   text[end] != '(' && text[end] != ')' && text[end] != '"' &&
+                   !isOperatorChar(text[end])) {
+                ++end;
+            }
+            token.text = text.substr(pos, end - pos);
+            pos = end;
+
+            char* parsedEnd = nullptr;
+            std::strtod(token.text.c_str(), &parsedEnd);
+            token.kind = *parsedEnd == '\0' ? Token::Number : Token::Word;
+        }
+    }
+
+    bool isKeyword(const char* keyword) const {
+        if (token.kind != Token::Word || token.text.size() != std::strlen(keyword)) {
+            return false;
+        }
+        for (size_t i = 0; i < token.text.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(token.text[i])) != keyword[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void emit(Step::Kind kind) {
+        Step step;
+        step.kind = kind;
+        plan->push_back(step);
+    }
+
+    void parseOr() {
+        parseAnd();
+        while (isKeyword("or")) {
+            advance();
+            parseAnd();
+            emit(Step::Kind::Or);
+        }
+    }
+
+    void parseAnd() {
+        parseFactor();
+        while (isKeyword("and")) {
+            advance();
+            parseFactor();
+            emit(Step::Kind::And);
+        }
+    }
+
+    void parseFactor() {
+        if (isKeyword("not")) {
+            advance();
+            parseFactor();
+            emit(Step::Kind::Not);
+        } else if (token.kind == Token::LParen) {
+            advance();
+            parseOr();
+            if (token.kind != Token::RParen) {
+                fail("expected ')'");
+            }
+            advance();
+        } else {
+            parsePredicate();
+        }
+    }
+
+    std::string parseName() {
+        if (token.kind != Token::Word && token.kind != Token::String &&
+            token.kind != Token::Number) {
+            fail("expected a name");
+        }
+        std::string name = token.text;
+        advance();
+        return name;
+    }
+
+    static bool hasWildcards(const std::string& pattern) {
+        return pattern.find_first_of("*?") != std::string::npos;
+    }
+
+    CompareOp parseCompareOp() {
+        const std::string& op = token.text;
+        CompareOp result;
+        if (token.kind != Token::Operator) {
+            fail("expected a comparison operator");
+        } else if (op == "<") {
+            result = CompareOp::Less;
+        } else if (op == "<=") {
+            result = CompareOp::LessEqual;
+        } else if (op == ">") {
+            result = CompareOp::Greater;
+        } else if (op == ">=") {
+            result = CompareOp::GreaterEqual;
+        } else if (op == "==" || op == "=") {
+            result = CompareOp::Equal;
+        } else if (op == "!=") {
+            result = CompareOp::NotEqual;
+        } else {
+            fail("operator '" + op + "' cannot compare numbers");
+        }
+        advance();
+        return result;
+    }
+
+    void parsePredicate() {
+        Step step;
+
+        if (isKeyword("through")) {
+            advance();
+            step.kind = Step::Kind::Through;
+            step.pattern = parseName();
+            step.glob = hasWildcards(step.pattern);
+        } else if (isKeyword("delay") || isKeyword("worst") || isKeyword("stages")) {
+            step.kind = Step::Kind::Compare;
+            step.field = isKeyword("delay") ? PathQuery::Field::Delay
+                       : isKeyword("worst") ? PathQuery::Field::WorstStage
+                                            : PathQuery::Field::Stages;
+            advance();
+            step.op = parseCompareOp();
+            if (token.kind != Token::Number) {
+                fail("expected a number");
+            }
+            step.value = std::strtod(token.text.c_str(), nullptr);
+            if (step.field == PathQuery::Field::Stages &&
+                (step.value < 0 || step.value != std::floor(step.value) || step.value > 1e9)) {
+                fail("stage counts are non-negative integers");
+            }
+            advance();
+        } else if (isKeyword("endpoint") || isKeyword("startpoint")) {
+            step.kind = Step::Kind::Match;
+            step.field = isKeyword("endpoint") ? PathQuery::Field::Endpoint
+                                               : PathQuery::Field::Startpoint;
+            advance();
+            if (token.kind != Token::Operator ||
+                (token.text != "~" && token.text != "==" && token.text != "=" && token.text != "!=")) {
+                fail("names compare with '==', '!=' or '~'");
+            }
+            step.op = token.text == "!=" ? CompareOp::NotEqual : CompareOp::Equal;
+            bool allowGlob = token.text == "~";
+            advance();
+            step.pattern = parseName();
+            step.glob = allowGlob && hasWildcards(step.pattern);
+        } else if (token.kind == Token::End) {
+            fail("expected a predicate");
+        } else {
+            fail("unknown field '" + token.text + "'");
+        }
+
+        plan->push_back(step);
+    }
+
+    const std::string& text;
+    size_t pos{0};
+    size_t tokenStart{0};
+    Token token;
+    std::vector<Step>* plan{nullptr};
+};
+
+// ---------------------------------------------------------------------------
+// PathQuery
+// ---------------------------------------------------------------------------
+
+PathQuery PathQuery::compile(const std::string& text) {
+    return QueryCompiler(text).compile();
+}
+
+SelectionBitmap PathQuery::evaluate(const PathColumns& columns, const TimingParser& parser,
+                                    const PathIndex& index) const {
+    std::vector<SelectionBitmap> stack;
+    size_t rows = columns.size();
+
+    for (const auto& step : plan) {
+        switch (step.kind) {
+            case PlanStep::Kind::Compare: {
+                if (step.field == Field::Stages) {
+                    stack.push_back(compareColumn(columns.stageCount, step.op,
+                                                  static_cast<uint32_t>(step.value)));
+                } else {
+                    const auto& column = step.field == Field::Delay ? columns.delay
+                                                                    : columns.worstStageDelay;
+                    stack.push_back(compareColumn(column, step.op, step.value));
+                }
+                break;
+            }
+            case PlanStep::Kind::Match: {
+                const auto& column = step.field == Field::Endpoint ? columns.endId : columns.startId;
+                auto ids = resolveNames(parser, step.pattern, step.glob);
+
+                SelectionBitmap selected(rows);
+                if (ids.size() == 1) {
+                    selected = compareColumn(column, CompareOp::Equal, ids[0]);
+                } else if (!ids.empty()) {
+                    std::vector<uint8_t> idSet(parser.nodeCount() + 1, 0);
+                    for (uint32_t id : ids) {
+                        idSet[id] = 1;
+                    }
+                    selected = matchIdSet(column, idSet);
+                }
+                if (step.op == CompareOp::NotEqual) {
+                    selected.flip();
+                }
+                stack.push_back(std::move(selected));
+                break;
+            }
+            case PlanStep::Kind::Through: {
+                SelectionBitmap selected(rows);
+                for (uint32_t nodeId : resolveNames(parser, step.pattern, step.glob)) {
+                    for (uint32_t pathId : index.pathsThrough(nodeId)) {
+                        if (pathId < rows) {
+                            selected.set(pathId);
+                        }
+                    }
+                }
+                stack.push_back(std::move(selected));
+                break;
+            }
+            case PlanStep::Kind::Not:
+                stack.back().flip();
+                break;
+            case PlanStep::Kind::And:
+            case PlanStep::Kind::Or: {
+                SelectionBitmap rhs = std::move(stack.back());
+                stack.pop_back();
+                if (step.kind == PlanStep::Kind::And) {
+                    stack.back() &= rhs;
+                } else {
+                    stack.back() |= rhs;
+                }
+                break;
+            }
+        }
+    }
+
+    return stack.empty() ? SelectionBitmap(rows, true) : std::move(stack.back());
+}
+
+std::string PathQuery::explain() const {
+    std::stringstream out;
+    for (size_t i = 0; i < plan.size(); ++i) {
+        const auto& step = plan[i];
+        out << i + 1 << ". ";
+        switch (step.kind) {
+            case PlanStep::Kind::Compare:
+                out << "scan " << fieldName(step.field) << " " << compareOpName(step.op)
+                    << " " << step.value;
+                break;
+            case PlanStep::Kind::Match:
+                out << "scan " << fieldName(step.field) << " "
+                    << (step.glob ? "in ids matching" : compareOpName(step.op)) << " \""
+                    << step.pattern << "\"";
+                break;
+            case PlanStep::Kind::Through:
+                out << "index through \"" << step.pattern << "\"";
+                break;
+            case PlanStep::Kind::And: out << "and"; break;
+            case PlanStep::Kind::Or: out << "or"; break;
+            case PlanStep::Kind::Not: out << "not"; break;
+        }
+        out << "\n";
+    }
+    return out.str();
+}
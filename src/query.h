@@ -0,0 +1,146 @@
+/**
+ * @file query.h
+ * @brief Defines the PathQuery filter language and the SelectionBitmap it produces
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "parser.h"
+#include "path_columns.h"
+#include "path_index.h"
+
+/**
+ * @class SelectionBitmap
+ * @brief One bit per path marking the paths selected by a filter
+ */
+class SelectionBitmap {
+public:
+    /**
+     * @brief Create a bitmap with every bit set to the same value
+     * @param size Number of paths
+     * @param value Initial value of every bit
+     */
+    explicit SelectionBitmap(size_t size = 0, bool value = false);
+
+    size_t size() const { return bits; }
+    bool test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+    void set(size_t i) { words[i / 64] |= uint64_t{1} << (i % 64); }
+
+    /**
+     * @brief Count the selected paths
+     * @return Number of set bits
+     */
+    size_t count() const;
+
+    /**
+     * @brief Get the selected path IDs
+     * @return Ascending IDs of the set bits
+     */
+    std::vector<uint32_t> toIds() const;
+
+    SelectionBitmap& operator&=(const SelectionBitmap& other);
+    SelectionBitmap& operator|=(const SelectionBitmap& other);
+
+    /**
+     * @brief Invert every bit
+     */
+    void flip();
+
+    /**
+     * @brief Access the packed words; bit i lives in word i / 64
+     * @return Pointer to size() / 64 rounded up words
+     */
+    uint64_t* data() { return words.data(); }
+
+private:
+    // Keep the bits past size() zero so count() and toIds() can ignore them
+    void clearTail();
+
+    size_t bits;
+    std::vector<uint64_t> words;
+};
+
+/**
+ * @enum CompareOp
+ * @brief Comparison applied by a numeric or ID column filter
+ */
+enum class CompareOp { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+/**
+ * @class PathQuery
+ * @brief A compiled path filter, evaluated one column at a time
+ *
+ * Grammar (keywords are case-insensitive):
+ *
+ *   expr      := term ("or" term)*
+ *   term      := factor ("and" factor)*
+ *   factor    := "not" factor | "(" expr ")" | predicate
+ *   predicate := ("delay" | "worst" | "stages") ("<" | "<=" | ">" | ">=" | "==" | "!=") NUMBER
+ *              | ("endpoint" | "startpoint") ("==" | "!=" | "~") NAME
+ *              | "through" NAME
+ *
+ * NAME is a bare word or a double-quoted string. "~" and "through" accept
+ * glob patterns with '*' and '?'. For example:
+ *
+ *   delay > 4.5 and stages >= 6 and endpoint ~ "FF*_D" and through "BUF*"
+ *
+ * The expression compiles to a postfix plan. Each predicate scans one column
+ * into a SelectionBitmap; "and", "or" and "not" combine bitmaps word by word.
+ * Name patterns are resolved to sets of interned IDs before any column is
+ * scanned, so no string is compared per path.
+ */
+class PathQuery {
+public:
+    /**
+     * @brief Compile a filter expression
+     * @param text Expression in the grammar above
+     * @return The compiled query
+     * @throws std::invalid_argument on syntax errors
+     */
+    static PathQuery compile(const std::string& text);
+
+    /**
+     * @brief Select the paths matching the query
+     * @param columns Columns of the paths to filter
+     * @param parser Parser that interned the paths' node names
+     * @param index Node-to-path index over the same paths
+     * @return One bit per row of columns
+     */
+    SelectionBitmap evaluate(const PathColumns& columns, const TimingParser& parser,
+                             const PathIndex& index) const;
+
+    /**
+     * @brief Describe the compiled plan, one step per line
+     * @return Plan listing
+     */
+    std::string explain() const;
+
+    /**
+     * @enum Field
+     * @brief Path column a predicate reads
+     */
+    enum class Field { Delay, WorstStage, Stages, Startpoint, Endpoint };
+
+private:
+    /**
+     * @struct PlanStep
+     * @brief One step of the postfix plan
+     */
+    struct PlanStep {
+        enum class Kind { Compare, Match, Through, And, Or, Not };
+
+        Kind kind;
+        Field field{Field::Delay};
+        CompareOp op{CompareOp::Equal};
+        double value{0.0};
+        std::string pattern;      // Name or glob for Match and Through
+        bool glob{false};         // Whether pattern holds wildcards
+    };
+
+    friend class QueryCompiler;
+
+    std::vector<PlanStep> plan;
+};
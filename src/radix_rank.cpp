@@ -0,0 +1,221 @@
+/**
+ * @file radix_rank.cpp
+ * @brief Implementation of the radix-sorted full ranking and rank ranges
+ */
+
+#include "radix_rank.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+
+// Rows in the order the keys were packed
+std::vector<uint32_t> rowsOf(const std::vector<RadixRank::KeyedRow>& keyed) {
+    std::vector<uint32_t> rows(keyed.size());
+    for (size_t i = 0; i < keyed.size(); ++i) {
+        rows[i] = keyed[i].row;
+    }
+    return rows;
+}
+
+// Order pairs by key, then by row, so selection breaks ties like the sort
+bool keyThenRow(const RadixRank::KeyedRow& a, const RadixRank::KeyedRow& b) {
+    return a.key != b.key ? a.key < b.key : a.row < b.row;
+}
+
+// Packed keys of the candidates under a key, in candidate order
+std::vector<RadixRank::KeyedRow> keyRows(const PathColumns& columns,
+                                         const std::vector<uint32_t>& candidates, RankKey key) {
+    std::vector<RadixRank::KeyedRow> keyed(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        keyed[i] = {RadixRank::descendingKey(RankKeys::score(key, columns, candidates[i])),
+                    candidates[i]};
+    }
+    return keyed;
+}
+
+std::vector<RadixRank::KeyedRow> keyPaths(const std::vector<TimingPath>& paths,
+                                          const std::vector<uint32_t>& candidates) {
+    std::vector<RadixRank::KeyedRow> keyed(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        keyed[i] = {RadixRank::descendingKey(paths[candidates[i]].totalDelay), candidates[i]};
+    }
+    return keyed;
+}
+
+// Buckets of the selection histogram: the top 16 key bits, i.e. the sign,
+// the exponent and four mantissa bits of the score
+constexpr unsigned kBucketShift = 48;
+constexpr size_t kBuckets = size_t(1) << 16;
+
+} // namespace
+
+namespace RadixRank {
+
+void sort(std::vector<KeyedRow>& rows, ThreadPool& pool) {
+    size_t n = rows.size();
+    if (n < 2) {
+        return;
+    }
+
+    // Bytes where no two keys differ would leave the order unchanged
+    uint64_t differing = 0;
+    for (const auto& row : rows) {
+        differing |= row.key ^ rows[0].key;
+    }
+
+    // Each worker owns the same slice in every pass. Its counts become its
+    // write offsets: digit-major, then worker order, so the scatter is stable
+    size_t workers = std::max<size_t>(1, std::min(pool.size(), n / kMinRowsPerWorker));
+    std::vector<std::array<size_t, 256>> counts(workers);
+    std::vector<KeyedRow> buffer(n);
+    KeyedRow* source = rows.data();
+    KeyedRow* target = buffer.data();
+
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        if (((differing >> shift) & 0xFF) == 0) {
+            continue;
+        }
+
+        pool.parallelFor(workers, [&](size_t first, size_t last) {
+            for (size_t w = first; w < last; ++w) {
+                auto& count = counts[w];
+                count.fill(0);
+                for (size_t i = n * w / workers, end = n * (w + 1) / workers; i < end; ++i) {
+                    ++count[(source[i].key >> shift) & 0xFF];
+                }
+            }
+        });
+
+        size_t offset = 0;
+        for (size_t digit = 0; digit < 256; ++digit) {
+            for (auto& count : counts) {
+                size_t rowsWithDigit = count[digit];
+                count[digit] = offset;
+                offset += rowsWithDigit;
+            }
+        }
+
+        pool.parallelFor(workers, [&](size_t first, size_t last) {
+            for (size_t w = first; w < last; ++w) {
+                auto& next = counts[w];
+                for (size_t i = n * w / workers, end = n * (w + 1) / workers; i < end; ++i) {
+                    target[next[(source[i].key >> shift) & 0xFF]++] = source[i];
+                }
+            }
+        });
+        std::swap(source, target);
+    }
+
+    if (source != rows.data()) {
+        rows.swap(buffer);
+    }
+}
+
+std::vector<uint32_t> rankRows(const PathColumns& columns, const std::vector<uint32_t>& candidates,
+                               RankKey key, ThreadPool& pool) {
+    auto keyed = keyRows(columns, candidates, key);
+    sort(keyed, pool);
+    return rowsOf(keyed);
+}
+
+std::vector<uint32_t> rankPaths(const std::vector<TimingPath>& paths,
+                                const std::vector<uint32_t>& candidates, ThreadPool& pool) {
+    auto keyed = keyPaths(paths, candidates);
+    sort(keyed, pool);
+    return rowsOf(keyed);
+}
+
+std::vector<uint32_t> selectRange(const std::vector<KeyedRow>& rows, size_t first,
+                                  size_t last, ThreadPool& pool) {
+    size_t n = rows.size();
+    last = std::min(last, n);
+    if (first >= last) {
+        return {};
+    }
+
+    // Pass 1: per-worker bucket counts over fixed slices
+    size_t workers = std::max<size_t>(1, std::min(pool.size(), n / kMinRowsPerWorker));
+    std::vector<std::vector<uint32_t>> counts(workers, std::vector<uint32_t>(kBuckets));
+    pool.parallelFor(workers, [&](size_t begin, size_t end) {
+        for (size_t w = begin; w < end; ++w) {
+            auto& count = counts[w];
+            for (size_t i = n * w / workers, stop = n * (w + 1) / workers; i < stop; ++i) {
+                ++count[rows[i].key >> kBucketShift];
+            }
+        }
+    });
+
+    // Buckets holding rank first and rank last - 1, and the rows ranked
+    // ahead of the lower one
+    size_t lowBucket = 0;
+    size_t highBucket = 0;
+    size_t ahead = 0;
+    for (size_t bucket = 0, seen = 0; bucket < kBuckets; ++bucket) {
+        size_t inBucket = 0;
+        for (const auto& count : counts) {
+            inBucket += count[bucket];
+        }
+        if (seen <= first && first < seen + inBucket) {
+            lowBucket = bucket;
+            ahead = seen;
+        }
+        if (seen < last && last <= seen + inBucket) {
+            highBucket = bucket;
+            break;
+        }
+        seen += inBucket;
+    }
+
+    // Pass 2: gather the bracketed rows; each worker writes after the rows
+    // its predecessors gathered
+    std::vector<size_t> offsets(workers + 1, 0);
+    for (size_t w = 0; w < workers; ++w) {
+        size_t gathered = 0;
+        for (size_t bucket = lowBucket; bucket <= highBucket; ++bucket) {
+            gathered += counts[w][bucket];
+        }
+        offsets[w + 1] = offsets[w] + gathered;
+    }
+    std::vector<KeyedRow> bracket(offsets[workers]);
+    pool.parallelFor(workers, [&](size_t begin, size_t end) {
+        for (size_t w = begin; w < end; ++w) {
+            size_t next = offsets[w];
+            for (size_t i = n * w / workers, stop = n * (w + 1) / workers; i < stop; ++i) {
+                size_t bucket = rows[i].key >> kBucketShift;
+                if (bucket >= lowBucket && bucket <= highBucket) {
+                    bracket[next++] = rows[i];
+                }
+            }
+        }
+    });
+
+    // Introselect both ends of the range, then sort only the range
+    auto begin = bracket.begin() + static_cast<std::ptrdiff_t>(first - ahead);
+    auto end = bracket.begin() + static_cast<std::ptrdiff_t>(last - ahead);
+    std::nth_element(bracket.begin(), begin, bracket.end(), keyThenRow);
+    std::nth_element(begin, end, bracket.end(), keyThenRow);
+    std::sort(begin, end, keyThenRow);
+
+    std::vector<uint32_t> selected;
+    selected.reserve(last - first);
+    for (auto it = begin; it != end; ++it) {
+        selected.push_back(it->row);
+    }
+    return selected;
+}
+
+std::vector<uint32_t> rankRange(const PathColumns& columns, const std::vector<uint32_t>& candidates,
+                                RankKey key, size_t first, size_t last, ThreadPool& pool) {
+    auto keyed = keyRows(columns, candidates, key);
+    return selectRange(keyed, first, last, pool);
+}
+
+std::vector<uint32_t> rankRange(const std::vector<TimingPath>& paths,
+                                const std::vector<uint32_t>& candidates, size_t first,
+                                size_t last, ThreadPool& pool) {
+    auto keyed = keyPaths(paths, candidates);
+    return selectRange(keyed, first, last, pool);
+}
+
+} // namespace RadixRank
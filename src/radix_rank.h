@@ -0,0 +1,132 @@
+/**
+ * @file radix_rank.h
+ * @brief Full rankings by parallel LSD radix sort (-k all) and rank ranges
+ *        by radix-narrowed selection (--rank-range)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "parser.h"
+#include "path_columns.h"
+#include "rank_key.h"
+#include "thread_pool.h"
+
+/**
+ * @namespace RadixRank
+ * @brief Ranks every candidate instead of selecting a top K
+ *
+ * Scores are packed with their rows into a flat array of (key, row) pairs,
+ * where the key is a 64-bit integer that orders like the score, most critical
+ * first. A stable least-significant-digit radix sort then orders the pairs in
+ * eight byte-wide passes that only read and write contiguous arrays; there are
+ * no comparisons and no reads back into the paths. Passes over bytes that
+ * every key shares are skipped.
+ */
+namespace RadixRank {
+
+// Below this many rows a comparison sort is faster than eight passes
+constexpr size_t kMinRows = size_t(1) << 14;
+
+// Rows each worker sorts at least; smaller slices are not worth a thread
+constexpr size_t kMinRowsPerWorker = size_t(1) << 16;
+
+/**
+ * @struct KeyedRow
+ * @brief A row and its order-preserving sort key
+ */
+struct KeyedRow {
+    uint64_t key;
+    uint32_t row;
+};
+
+/**
+ * @brief Map a score to a key where smaller means more critical
+ * @param score Score where larger means more critical; not NaN
+ * @return Key; equal scores give equal keys, including 0.0 and -0.0
+ */
+inline uint64_t descendingKey(double score) {
+    score += 0.0;  // -0.0 becomes 0.0 so the two tie as they compare
+    uint64_t bits;
+    std::memcpy(&bits, &score, sizeof(bits));
+
+    // Negative doubles order backwards as integers, so flip all their bits;
+    // positive ones only need the sign bit set to sort above them
+    constexpr uint64_t sign = uint64_t(1) << 63;
+    uint64_t ascending = (bits & sign) ? ~bits : bits | sign;
+    return ~ascending;
+}
+
+/**
+ * @brief Stable sort by key, ascending
+ * @param rows Pairs to sort in place; equal keys keep their order
+ * @param pool Workers that histogram and scatter disjoint slices
+ */
+void sort(std::vector<KeyedRow>& rows, ThreadPool& pool);
+
+/**
+ * @brief Rank every candidate by a key
+ * @param columns Columns of the paths
+ * @param candidates Rows to rank
+ * @param key Ranking key
+ * @param pool Workers for the sort
+ * @return All candidates, most critical first; ties keep candidate order
+ */
+std::vector<uint32_t> rankRows(const PathColumns& columns, const std::vector<uint32_t>& candidates,
+                               RankKey key, ThreadPool& pool);
+
+/**
+ * @brief Rank every candidate path by total delay
+ * @param paths Parsed or scanned paths
+ * @param candidates Positions in paths to rank
+ * @param pool Workers for the sort
+ * @return All candidates, largest delay first; ties keep candidate order
+ */
+std::vector<uint32_t> rankPaths(const std::vector<TimingPath>& paths,
+                                const std::vector<uint32_t>& candidates, ThreadPool& pool);
+
+/**
+ * @brief Select the pairs ranked first .. last - 1 without sorting the rest
+ * @param rows Pairs to select from
+ * @param first Zero-based rank of the first pair to return
+ * @param last One past the rank of the last pair; clamped to rows.size()
+ * @param pool Workers that histogram and gather disjoint slices
+ * @return Rows of the selected pairs in key order; equal keys in row order
+ *
+ * One parallel pass histograms the top 16 key bits, which brackets the range
+ * between two buckets. A second pass gathers only the pairs in those
+ * buckets. Two nth_element calls then isolate the range within them, and
+ * only the range is sorted: O(n + (last - first) log(last - first)).
+ */
+std::vector<uint32_t> selectRange(const std::vector<KeyedRow>& rows, size_t first,
+                                  size_t last, ThreadPool& pool);
+
+/**
+ * @brief Select the candidates ranked first .. last - 1 by a key
+ * @param columns Columns of the paths
+ * @param candidates Rows to rank
+ * @param key Ranking key
+ * @param first Zero-based rank of the first row to return
+ * @param last One past the rank of the last row
+ * @param pool Workers for the selection
+ * @return Selected rows, most critical first; ties go to the earlier row
+ */
+std::vector<uint32_t> rankRange(const PathColumns& columns, const std::vector<uint32_t>& candidates,
+                                RankKey key, size_t first, size_t last, ThreadPool& pool);
+
+/**
+ * @brief Select the candidate paths ranked first .. last - 1 by total delay
+ * @param paths Parsed or scanned paths
+ * @param candidates Positions in paths to rank
+ * @param first Zero-based rank of the first path to return
+ * @param last One past the rank of the last path
+ * @param pool Workers for the selection
+ * @return Selected positions, largest delay first; ties go to the earlier path
+ */
+std::vector<uint32_t> rankRange(const std::vector<TimingPath>& paths,
+                                const std::vector<uint32_t>& candidates, size_t first,
+                                size_t last, ThreadPool& pool);
+
+} // namespace RadixRank
@@ -0,0 +1,60 @@
+/**
+ * @file rank_key.cpp
+ * @brief Names of the --rank-by keys
+ */
+
+#include "rank_key.h"
+#include <stdexcept>
+
+namespace RankKeys {
+
+RankKey parse(const std::string& name) {
+    if (name == "delay") {
+        return RankKey::Delay;
+    } else if (name == "slack") {
+        return RankKey::Slack;
+    } else if (name == "worst-stage") {
+        return RankKey::WorstStage;
+    } else if (name == "stages") {
+        return RankKey::Stages;
+    } else if (name == "net-share") {
+        return RankKey::NetDelayShare;
+    }
+    throw std::runtime_error("Unknown ranking key: " + name +
+                             " (expected delay, slack, worst-stage, stages or net-share)");
+}
+
+std::vector<RankKey> parseList(const std::string& names) {
+    std::vector<RankKey> keys;
+    size_t start = 0;
+    while (true) {
+        size_t comma = names.find(',', start);
+        RankKey key = parse(names.substr(start, comma == std::string::npos ? std::string::npos
+                                                                          : comma - start));
+        if (std::find(keys.begin(), keys.end(), key) == keys.end()) {
+            keys.push_back(key);
+        }
+        if (comma == std::string::npos) {
+            return keys;
+        }
+        start = comma + 1;
+    }
+}
+
+const char* name(RankKey key) {
+    switch (key) {
+        case RankKey::Delay:
+            return "delay";
+        case RankKey::Slack:
+            return "slack";
+        case RankKey::WorstStage:
+            return "worst-stage";
+        case RankKey::Stages:
+            return "stages";
+        case RankKey::NetDelayShare:
+            return "net-share";
+    }
+    return "delay";
+}
+
+} // namespace RankKeys
@@ -0,0 +1,240 @@
+/**
+ * @file rank_key.h
+ * @brief Ranking keys and the top-K selection templated over them (--rank-by)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "path_columns.h"
+
+/**
+ * @enum RankKey
+ * @brief What makes one path more critical than another
+ */
+enum class RankKey {
+    Delay,           // Largest total delay first
+    Slack,           // Least slack against the report's Clock Period first
+    WorstStage,      // Largest single stage delay first
+    Stages,          // Most stages first
+    NetDelayShare    // Largest fraction of the delay spent in nets first
+};
+
+/**
+ * @namespace RankKeys
+ * @brief Key extractors over PathColumns, one type per RankKey
+ *
+ * Each extractor maps a row to a score where larger means more critical, so
+ * every key shares one comparator. They are plain inline functions on a
+ * column, so a ranking instantiated for one key compiles to a loop over one
+ * array with no dispatch.
+ */
+namespace RankKeys {
+
+struct Delay {
+    static double score(const PathColumns& columns, uint32_t row) { return columns.delay[row]; }
+};
+
+struct Slack {
+    // Paths from reports without a Clock Period rank after all others
+    static double score(const PathColumns& columns, uint32_t row) {
+        double slack = columns.slack[row];
+        return std::isnan(slack) ? -std::numeric_limits<double>::infinity() : -slack;
+    }
+};
+
+struct WorstStage {
+    static double score(const PathColumns& columns, uint32_t row) {
+        return columns.worstStageDelay[row];
+    }
+};
+
+struct Stages {
+    static double score(const PathColumns& columns, uint32_t row) {
+        return static_cast<double>(columns.stageCount[row]);
+    }
+};
+
+struct NetDelayShare {
+    static double score(const PathColumns& columns, uint32_t row) {
+        return columns.netDelayShare[row];
+    }
+};
+
+/**
+ * @brief Score a row by a key chosen at run time
+ * @param key Key
+ * @param columns Columns of the paths
+ * @param row Row to score
+ * @return The score the key's extractor gives the row
+ */
+inline double score(RankKey key, const PathColumns& columns, uint32_t row) {
+    switch (key) {
+        case RankKey::Slack:
+            return Slack::score(columns, row);
+        case RankKey::WorstStage:
+            return WorstStage::score(columns, row);
+        case RankKey::Stages:
+            return Stages::score(columns, row);
+        case RankKey::NetDelayShare:
+            return NetDelayShare::score(columns, row);
+        case RankKey::Delay:
+            break;
+    }
+    return Delay::score(columns, row);
+}
+
+/**
+ * @brief Parse a --rank-by key name
+ * @param name One of delay, slack, worst-stage, stages, net-share
+ * @return The key
+ * @throws std::runtime_error for any other name
+ */
+RankKey parse(const std::string& name);
+
+/**
+ * @brief Name a key as --rank-by spells it
+ * @param key Key
+ * @return Key name
+ */
+const char* name(RankKey key);
+
+/**
+ * @brief Parse a comma-separated list of --rank-by key names
+ * @param names e.g. "delay,worst-stage,stages"
+ * @return The keys in order, without repeats
+ * @throws std::runtime_error for an unknown or empty name
+ */
+std::vector<RankKey> parseList(const std::string& names);
+
+} // namespace RankKeys
+
+/**
+ * @struct ScoredRow
+ * @brief A row and its score under one key
+ */
+struct ScoredRow {
+    double score;
+    uint32_t row;
+};
+
+/**
+ * @brief Order rows most critical first; ties go to the earlier row
+ * @param a First row
+ * @param b Second row
+ * @return True if a ranks before b
+ */
+inline bool moreCritical(const ScoredRow& a, const ScoredRow& b) {
+    return (a.score > b.score) | ((a.score == b.score) & (a.row < b.row));
+}
+
+/**
+ * @class TopKHeap
+ * @brief The K most critical rows offered so far, for one key
+ *
+ * A heap whose top is the least critical row kept, so a row that does not
+ * make the cut costs one comparison.
+ */
+class TopKHeap {
+public:
+    /**
+     * @brief Create an empty heap
+     * @param k Number of rows to keep
+     * @param expected Rows the caller expects to offer; space for up to K of
+     *                 them is reserved, and the heap grows past that as needed
+     */
+    explicit TopKHeap(size_t k, size_t expected = 0) : limit(k) {
+        heap.reserve(std::min(k, expected));
+    }
+
+    /**
+     * @brief Offer a row
+     * @param score Row's score under the heap's key
+     * @param row Row
+     */
+    void offer(double score, uint32_t row) {
+        ScoredRow candidate{score, row};
+        if (heap.size() < limit) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end(), moreCritical);
+        } else if (limit > 0 && moreCritical(candidate, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), moreCritical);
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end(), moreCritical);
+        }
+    }
+
+    /**
+     * @brief Take the kept rows, leaving the heap empty
+     * @return Rows, most critical first
+     */
+    std::vector<uint32_t> take() {
+        std::sort_heap(heap.begin(), heap.end(), moreCritical);
+        std::vector<uint32_t> rows(heap.size());
+        for (size_t i = 0; i < heap.size(); ++i) {
+            rows[i] = heap[i].row;
+        }
+        heap.clear();
+        return rows;
+    }
+
+    /**
+     * @brief Get the kept rows without taking them
+     * @return Rows in heap order
+     */
+    const std::vector<ScoredRow>& entries() const { return heap; }
+
+private:
+    size_t limit;
+    std::vector<ScoredRow> heap;
+};
+
+/**
+ * @brief Offer a run of rows to a heap, scored by one key
+ * @tparam Key Extractor from RankKeys
+ * @param heap Heap for the key
+ * @param columns Columns of the paths
+ * @param first First row to offer
+ * @param last One past the last row to offer
+ */
+template <typename Key>
+void offerRows(TopKHeap& heap, const PathColumns& columns, const uint32_t* first,
+               const uint32_t* last) {
+    for (; first != last; ++first) {
+        heap.offer(Key::score(columns, *first), *first);
+    }
+}
+
+/**
+ * @brief Select the top K rows by a key, most critical first
+ * @tparam Key Extractor from RankKeys
+ * @param columns Columns of the paths
+ * @param candidates Rows to rank
+ * @param topK Number of rows to keep
+ * @return Selected rows; ties keep row order
+ *
+ * Scores are read once into (score, row) pairs, so the comparator works on
+ * contiguous values instead of reaching back into the paths.
+ */
+template <typename Key>
+std::vector<uint32_t> rankRows(const PathColumns& columns, const std::vector<uint32_t>& candidates,
+                               int topK) {
+    std::vector<ScoredRow> scored(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        scored[i] = {Key::score(columns, candidates[i]), candidates[i]};
+    }
+
+    size_t count = std::min(scored.size(), static_cast<size_t>(std::max(topK, 0)));
+    std::partial_sort(scored.begin(), scored.begin() + count, scored.end(), moreCritical);
+
+    std::vector<uint32_t> ranked(count);
+    for (size_t i = 0; i < count; ++i) {
+        ranked[i] = scored[i].row;
+    }
+    return ranked;
+}
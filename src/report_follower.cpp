@@ -0,0 +1,265 @@
+/**
+ * @file report_follower.cpp
+ * @brief Implementation of the growing-report follower
+ */
+
+#include "report_follower.h"
+#include "profiler.h"
+#include "trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// How often waiting wakes up to check stop() and, without inotify, the file
+constexpr std::chrono::milliseconds kPollInterval{200};
+
+// Bytes read per pread() while catching up
+constexpr size_t kReadChunk = 256 * 1024;
+
+// Names the parser's node table may hold before it is replaced
+constexpr size_t kMaxNodeTable = size_t(1) << 16;
+
+} // namespace
+
+ReportFollower::ReportFollower(std::string filename, int topK, bool useInotify)
+    : filename(std::move(filename)),
+      topK(static_cast<size_t>(std::max(topK, 0))),
+      wantInotify(useInotify) {
+    openReport();
+}
+
+ReportFollower::~ReportFollower() {
+    closeReport();
+}
+
+bool ReportFollower::openReport() {
+    if (fd >= 0) {
+        return true;
+    }
+    fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return false;  // Not written yet
+        }
+        throw std::runtime_error("Failed to open file: " + filename + ": " + std::strerror(errno));
+    }
+
+    struct stat st {};
+    ::fstat(fd, &st);
+    inode = static_cast<uint64_t>(st.st_ino);
+
+    if (wantInotify) {
+        watchFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (watchFd >= 0 &&
+            ::inotify_add_watch(watchFd, filename.c_str(),
+                                IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB |
+                                IN_DELETE_SELF | IN_MOVE_SELF) < 0) {
+            ::close(watchFd);
+            watchFd = -1;
+        }
+    }
+    return true;
+}
+
+void ReportFollower::closeReport() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    if (watchFd >= 0) {
+        ::close(watchFd);
+        watchFd = -1;
+    }
+}
+
+void ReportFollower::restart(const char* reason) {
+    std::cerr << "Warning: " << filename << " " << reason
+              << "; following it again from the start" << std::endl;
+    closeReport();
+    best.clear();
+    pending.clear();
+    resumeScan = 0;
+    consumed = readOffset = 0;
+    parsedPaths = 0;
+    complete = false;
+    changed = true;
+}
+
+size_t ReportFollower::poll() {
+    if (!openReport()) {
+        return 0;
+    }
+
+    // A report rewritten in place or replaced by a new file starts over
+    struct stat pathStat {};
+    if (::stat(filename.c_str(), &pathStat) == 0 &&
+        static_cast<uint64_t>(pathStat.st_ino) != inode) {
+        restart("was replaced");
+    } else if (::fstat(fd, &pathStat) == 0 &&
+               static_cast<uint64_t>(pathStat.st_size) < readOffset) {
+        restart("shrank");
+    }
+    if (!openReport()) {
+        return 0;
+    }
+
+    Profiler::ScopedTimer timer(Profiler::Phase::Parse);
+    Trace::Span span("poll", "phase");
+    size_t found = 0;
+    std::string chunk(kReadChunk, '\0');
+    while (!complete) {
+        ssize_t bytes = ::pread(fd, &chunk[0], chunk.size(), static_cast<off_t>(readOffset));
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to read file: " + filename + ": " +
+                                     std::strerror(errno));
+        }
+        if (bytes == 0) {
+            break;
+        }
+        readOffset += static_cast<uint64_t>(bytes);
+        timer.addBytes(static_cast<uint64_t>(bytes));
+        pending.append(chunk, 0, static_cast<size_t>(bytes));
+        found += consumeSections();
+    }
+    timer.addItems(found);
+    return found;
+}
+
+size_t ReportFollower::consumeSections() {
+    size_t found = 0;
+    size_t pos = 0;
+    std::string line;
+
+    while (!complete) {
+        size_t newline = pending.find('\n', pos);
+        if (newline == std::string::npos) {
+            break;  // Partial line
+        }
+        if (pending.compare(pos, 5, "Path ") != 0) {
+            line.assign(pending, pos, newline - pos);
+            if (line.find("End of") != std::string::npos) {
+                complete = true;
+            }
+            pos = newline + 1;
+            continue;
+        }
+
+        // A section is complete once the line after it has been written;
+        // resume where the previous poll stopped looking
+        size_t end = (pos == 0 && resumeScan > newline) ? resumeScan : newline + 1;
+        bool closed = false;
+        for (size_t next; (next = pending.find('\n', end)) != std::string::npos; end = next + 1) {
+            line.assign(pending, end, next - end);
+            if (TimingParser::endsPathSection(line)) {
+                closed = true;
+                break;
+            }
+        }
+        if (!closed) {
+            resumeScan = end - pos;
+            break;
+        }
+        resumeScan = 0;
+
+        try {
+            // Most sections cannot make the top K; judge them by the header
+            // so their stages are never tokenized or interned
+            line.assign(pending, pos, newline - pos);
+            if (makesTopK(std::get<3>(TimingParser::parsePathHeader(line)))) {
+                offer(parser.parseSection(pending.substr(pos, end - pos)));
+            }
+            ++found;
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to parse path at byte " << consumed + pos
+                      << ": " << e.what() << std::endl;
+        }
+        pos = end;
+    }
+
+    // Everything before pos is done for good
+    pending.erase(0, pos);
+    consumed += pos;
+    parsedPaths += found;
+
+    // Names of displaced paths would otherwise stay in the table for good.
+    // Kept paths hold their own nodes, so a fresh table loses nothing
+    if (parser.nodeCount() > kMaxNodeTable) {
+        parser = TimingParser();
+    }
+    return found;
+}
+
+bool ReportFollower::makesTopK(double delay) const {
+    return topK > 0 && (best.size() < topK || delay > best.back().totalDelay);
+}
+
+void ReportFollower::offer(TimingPath&& path) {
+    if (!makesTopK(path.totalDelay)) {
+        return;
+    }
+    // After any equal delays, so ties keep report order
+    auto it = std::upper_bound(best.begin(), best.end(), path.totalDelay,
+                               [](double delay, const TimingPath& p) {
+                                   return delay > p.totalDelay;
+                               });
+    best.insert(it, std::move(path));
+    if (best.size() > topK) {
+        best.pop_back();
+    }
+    changed = true;
+}
+
+void ReportFollower::waitForChange(std::chrono::milliseconds limit) {
+    auto wait = std::max(std::chrono::milliseconds(1), std::min(limit, kPollInterval));
+    if (watchFd < 0) {
+        std::this_thread::sleep_for(wait);
+        return;
+    }
+
+    pollfd pfd{watchFd, POLLIN, 0};
+    if (::poll(&pfd, 1, static_cast<int>(wait.count())) > 0) {
+        // The events only say "look again"; drain them
+        char events[4096];
+        while (::read(watchFd, events, sizeof(events)) > 0) {
+        }
+    }
+}
+
+void ReportFollower::follow(std::chrono::milliseconds interval,
+                            const std::function<void()>& refresh) {
+    using Clock = std::chrono::steady_clock;
+    running = true;
+    auto nextRefresh = Clock::now();
+
+    while (running) {
+        poll();
+        if (complete) {
+            break;
+        }
+        auto now = Clock::now();
+        if (now >= nextRefresh) {
+            if (changed) {
+                refresh();
+                changed = false;
+            }
+            nextRefresh = now + interval;
+        }
+        waitForChange(std::chrono::duration_cast<std::chrono::milliseconds>(nextRefresh - now));
+    }
+
+    refresh();
+    changed = false;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file report_follower.h
+ * @brief Incremental top-K over a report that is still being written
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "parser.h"
+
+/**
+ * @class ReportFollower
+ * @brief Tails a growing report and keeps the top K of its completed paths
+ *
+ * poll() reads whatever was appended since the last call and handles every
+ * path section whose end has been written: the blank line, next header or
+ * trailer after it. A section whose header delay cannot enter the top K is
+ * skipped without parsing its stages; the rest are parsed and offered. Bytes
+ * before the first incomplete section are dropped and the checkpoint advances
+ * past them, so nothing is parsed twice. The parser's node table is replaced
+ * once it holds 65536 names; kept paths own their nodes, so memory
+ * stays bounded by the top K, that table and one partial section.
+ *
+ * Between polls, waitForChange() blocks on inotify, or sleeps when inotify is
+ * unavailable. A report that shrinks or is replaced is followed again from
+ * its start.
+ */
+class ReportFollower {
+public:
+    /**
+     * @brief Start following a report
+     * @param filename Report file; it may not exist yet
+     * @param topK Number of paths to keep
+     * @param useInotify Wait with inotify when it is available; false always polls
+     */
+    ReportFollower(std::string filename, int topK, bool useInotify = true);
+    ~ReportFollower();
+
+    ReportFollower(const ReportFollower&) = delete;
+    ReportFollower& operator=(const ReportFollower&) = delete;
+
+    /**
+     * @brief Read and parse everything appended since the last call
+     * @return Number of newly completed paths
+     * @throws std::runtime_error if the report exists but cannot be read
+     */
+    size_t poll();
+
+    /**
+     * @brief Block until the report may have changed
+     * @param limit Longest time to wait
+     */
+    void waitForChange(std::chrono::milliseconds limit);
+
+    /**
+     * @brief Poll until the report's trailer is read or stop() is called
+     * @param interval Shortest time between refreshes
+     * @param refresh Called when the top K changed, at most once per interval,
+     *                and once more before returning
+     */
+    void follow(std::chrono::milliseconds interval, const std::function<void()>& refresh);
+
+    /**
+     * @brief Ask follow() to return; safe to call from a signal handler
+     */
+    void stop() { running = false; }
+
+    /**
+     * @brief Check whether the report's "End of" trailer has been read
+     * @return True once the report is complete
+     */
+    bool finished() const { return complete; }
+
+    /**
+     * @brief Get the top K paths so far
+     * @return Paths by descending delay; ties keep report order. Node IDs may
+     *         refer to a replaced node table, so use the names
+     */
+    const std::vector<TimingPath>& topPaths() const { return best; }
+
+    /**
+     * @brief Get the number of completed paths parsed so far
+     * @return Path count
+     */
+    size_t pathCount() const { return parsedPaths; }
+
+    /**
+     * @brief Get the number of names in the parser's node table
+     * @return Names interned since the table was last replaced
+     */
+    size_t internedNames() const { return parser.nodeCount(); }
+
+    /**
+     * @brief Get the byte offset just past the last consumed section
+     * @return Checkpoint offset; later polls never read before it
+     */
+    uint64_t checkpoint() const { return consumed; }
+
+    /**
+     * @brief Check whether inotify is being used
+     * @return False when waiting falls back to polling
+     */
+    bool usingInotify() const { return watchFd >= 0; }
+
+private:
+    /**
+     * @brief Consume the complete sections at the front of the pending bytes
+     * @return Number of paths parsed
+     */
+    size_t consumeSections();
+
+    /**
+     * @brief Check whether a path with this delay would enter the top K
+     * @param delay Path delay
+     * @return False if the top K is full of paths at least as slow
+     */
+    bool makesTopK(double delay) const;
+
+    /**
+     * @brief Offer a parsed path to the top K
+     * @param path Newly completed path
+     */
+    void offer(TimingPath&& path);
+
+    /**
+     * @brief Open the report and its watch, or reopen it after a restart
+     * @return True if the report is open
+     */
+    bool openReport();
+
+    /**
+     * @brief Drop all state and follow the report again from its start
+     * @param reason Warning text
+     */
+    void restart(const char* reason);
+
+    void closeReport();
+
+    std::string filename;
+    size_t topK;
+    bool wantInotify;
+    TimingParser parser;
+    std::vector<TimingPath> best;     // Top K by descending delay
+    std::string pending;              // Bytes from the checkpoint to readOffset
+    size_t resumeScan{0};             // Where to resume looking for the end of the first section
+    uint64_t consumed{0};
+    uint64_t readOffset{0};
+    size_t parsedPaths{0};
+    bool complete{false};
+    bool changed{false};
+    int fd{-1};
+    uint64_t inode{0};
+    int watchFd{-1};                  // inotify descriptor, or -1 when polling
+    std::atomic<bool> running{false};
+};
@@ -0,0 +1,431 @@
+/**
+ * @file report_generator.cpp
+ * @brief Implementation of ReportGenerator
+ */
+
+#include "report_generator.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Flush threshold; comfortably larger than any single line
+constexpr size_t kBufferSize = 4 << 20;
+constexpr size_t kMaxLine = 512;
+constexpr double kTwoPi = 6.283185307179586;
+
+/**
+ * @class Xoshiro256
+ * @brief xoshiro256** generator seeded through splitmix64
+ */
+class Xoshiro256 {
+public:
+    explicit Xoshiro256(uint64_t seed) {
+        for (auto& word : state) {
+            seed += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1)
+    double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    // Uniform in [0, n)
+    uint64_t below(uint64_t n) { return next() % n; }
+
+    bool chance(double probability) { return probability > 0.0 && uniform() < probability; }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t state[4];
+};
+
+/**
+ * @class ZipfSampler
+ * @brief Zipf-distributed ranks in [0, n) by rejection-inversion
+ *
+ * Constant memory and expected O(1) time per sample regardless of n
+ * (W. Hormann and G. Derflinger, "Rejection-inversion to generate variates
+ * from monotone discrete distributions", 1996). An exponent of 0 is uniform.
+ */
+class ZipfSampler {
+public:
+    ZipfSampler(uint64_t n, double exponent) : n(n), exponent(exponent) {
+        if (exponent > 0.0) {
+            hIntegralX1 = hIntegral(1.5) - 1.0;
+            hIntegralN = hIntegral(static_cast<double>(n) + 0.5);
+            s = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+        }
+    }
+
+    uint64_t sample(Xoshiro256& rng) const {
+        if (exponent <= 0.0) {
+            return rng.below(n);
+        }
+        while (true) {
+            double u = hIntegralN + rng.uniform() * (hIntegralX1 - hIntegralN);
+            double x = hIntegralInverse(u);
+            double k = std::clamp(std::floor(x + 0.5), 1.0, static_cast<double>(n));
+            if (k - x <= s || u >= hIntegral(k + 0.5) - h(k)) {
+                return static_cast<uint64_t>(k) - 1;
+            }
+        }
+    }
+
+private:
+    double h(double x) const { return std::exp(-exponent * std::log(x)); }
+
+    double hIntegral(double x) const {
+        double logX = std::log(x);
+        return helper2((1.0 - exponent) * logX) * logX;
+    }
+
+    double hIntegralInverse(double x) const {
+        double t = std::max(x * (1.0 - exponent), -1.0);
+        return std::exp(helper1(t) * x);
+    }
+
+    // log1p(x) / x and expm1(x) / x, accurate near zero
+    static double helper1(double x) {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+    static double helper2(double x) {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+    }
+
+    uint64_t n;
+    double exponent;
+    double hIntegralX1{0.0};
+    double hIntegralN{0.0};
+    double s{0.0};
+};
+
+/**
+ * @class LineBuffer
+ * @brief Formats report text into a large buffer flushed to a sink
+ */
+class LineBuffer {
+public:
+    explicit LineBuffer(const ReportGenerator::Sink& sink) : sink(sink), buffer(kBufferSize) {}
+
+    void text(const char* s, size_t size) {
+        std::copy(s, s + size, buffer.data() + used);
+        used += size;
+    }
+
+    template <size_t N>
+    void literal(const char (&s)[N]) {
+        text(s, N - 1);
+    }
+
+    void number(uint64_t value) {
+        auto result = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value);
+        used = static_cast<size_t>(result.ptr - buffer.data());
+    }
+
+    // A name such as "NET42" from a prefix and index
+    void name(const char* prefix, uint64_t index, const char* suffix = "") {
+        while (*prefix) buffer[used++] = *prefix++;
+        number(index);
+        while (*suffix) buffer[used++] = *suffix++;
+    }
+
+    // Thousandths as a fixed-point value with three decimals
+    void milli(uint64_t value) {
+        number(value / 1000);
+        uint64_t fraction = value % 1000;
+        buffer[used++] = '.';
+        buffer[used++] = static_cast<char>('0' + fraction / 100);
+        buffer[used++] = static_cast<char>('0' + fraction / 10 % 10);
+        buffer[used++] = static_cast<char>('0' + fraction % 10);
+    }
+
+    void pad(size_t columnStart, size_t width) {
+        do {
+            buffer[used++] = ' ';
+        } while (used - columnStart < width);
+    }
+
+    void newline() {
+        buffer[used++] = '\n';
+        if (used > kBufferSize - kMaxLine) {
+            flush();
+        }
+    }
+
+    size_t position() const { return used; }
+
+    void flush() {
+        if (used > 0) {
+            sink(buffer.data(), used);
+            written += used;
+            used = 0;
+        }
+    }
+
+    uint64_t bytesWritten() const { return written + used; }
+
+private:
+    const ReportGenerator::Sink& sink;
+    std::vector<char> buffer;
+    size_t used{0};
+    uint64_t written{0};
+};
+
+// Cell names cycle through these prefixes so the parser's type guesses vary
+const char* const kCellKinds[] = {"INV", "BUF", "NAND", "NOR", "AOI", "XOR"};
+
+} // namespace
+
+ReportGenerator::ReportGenerator(GeneratorOptions options) : options(options) {
+    if (options.minStages < 1 || options.minStages > options.maxStages) {
+        throw std::invalid_argument("stage counts must satisfy 1 <= min <= max");
+    }
+    if (options.nodeCount < 2) {
+        throw std::invalid_argument("node count must be at least 2");
+    }
+    if (options.minDelay < 0.0 || options.minDelay > options.maxDelay) {
+        throw std::invalid_argument("delays must satisfy 0 <= min <= max");
+    }
+    if (options.meanDelay <= 0.0 || options.delaySigma < 0.0) {
+        throw std::invalid_argument("delay mean must be positive and sigma non-negative");
+    }
+    if (options.fanoutSkew < 0.0) {
+        throw std::invalid_argument("fan-out skew must be non-negative");
+    }
+    if (options.malformedRate < 0.0 || options.malformedRate > 1.0) {
+        throw std::invalid_argument("malformed rate must be between 0 and 1");
+    }
+    if (options.clockPeriod <= 0.0) {
+        throw std::invalid_argument("clock period must be positive");
+    }
+}
+
+GeneratorStats ReportGenerator::generate(const Sink& sink) const {
+    const GeneratorOptions& o = options;
+    Xoshiro256 rng(o.seed);
+    LineBuffer out(sink);
+    GeneratorStats stats;
+
+    // Stages alternate between nets and cells drawn from two halves of the pool
+    uint64_t netCount = o.nodeCount / 2;
+    uint64_t cellCount = o.nodeCount - netCount;
+    uint64_t flopCount = std::max<uint64_t>(1, o.nodeCount / 16);
+    ZipfSampler nets(netCount, o.fanoutSkew);
+    ZipfSampler cells(cellCount, o.fanoutSkew);
+
+    auto drawStages = [&]() -> uint32_t {
+        uint32_t span = o.maxStages - o.minStages;
+        if (o.stageDistribution == GeneratorOptions::StageDistribution::Uniform) {
+            return o.minStages + static_cast<uint32_t>(rng.below(uint64_t{span} + 1));
+        }
+        double extraMean = o.meanStages - o.minStages;
+        if (extraMean <= 0.0) {
+            return o.minStages;
+        }
+        // Failures before the first success with mean extraMean
+        double extra = std::floor(std::log1p(-rng.uniform()) / std::log1p(-1.0 / (1.0 + extraMean)));
+        return o.minStages + static_cast<uint32_t>(std::min(extra, static_cast<double>(span)));
+    };
+
+    auto drawDelay = [&]() -> uint64_t {
+        double delay;
+        switch (o.delayDistribution) {
+            case GeneratorOptions::DelayDistribution::Exponential:
+                delay = -o.meanDelay * std::log1p(-rng.uniform());
+                break;
+            case GeneratorOptions::DelayDistribution::LogNormal: {
+                // Box-Muller normal scaled so the distribution mean is meanDelay
+                double z = std::sqrt(-2.0 * std::log1p(-rng.uniform())) *
+                           std::cos(kTwoPi * rng.uniform());
+                double mu = std::log(o.meanDelay) - 0.5 * o.delaySigma * o.delaySigma;
+                delay = std::exp(mu + o.delaySigma * z);
+                break;
+            }
+            default:
+                delay = o.minDelay + rng.uniform() * (o.maxDelay - o.minDelay);
+                break;
+        }
+        return static_cast<uint64_t>(std::llround(std::clamp(delay, o.minDelay, o.maxDelay) * 1000.0));
+    };
+
+    // Corrupt the tail of a line: drop its delay column, make the delay
+    // non-numeric, or put a garbage line in front of it
+    enum class Corruption { None, MissingDelay, BadDelay, GarbageLine };
+    auto drawCorruption = [&]() {
+        if (!rng.chance(o.malformedRate)) {
+            return Corruption::None;
+        }
+        ++stats.malformedLines;
+        return static_cast<Corruption>(1 + rng.below(3));
+    };
+    auto writeDelay = [&](Corruption corruption, uint64_t delay) {
+        if (corruption == Corruption::BadDelay) {
+            out.literal("n/a");
+        } else if (corruption != Corruption::MissingDelay) {
+            out.milli(delay);
+        }
+        out.newline();
+    };
+
+    out.literal("Timing Report for Design: synthetic\n");
+    out.literal("Generator: gen_timing_report seed=");
+    out.number(o.seed);
+    out.literal("\nClock Period: ");
+    out.milli(static_cast<uint64_t>(std::llround(o.clockPeriod * 1000.0)));
+    out.literal(" ns\n");
+
+    struct Node {
+        const char* prefix;
+        uint64_t index;
+        const char* suffix;
+    };
+    std::vector<Node> nodes;
+    std::vector<uint64_t> delays;
+
+    for (uint64_t p = 1; p <= o.pathCount; ++p) {
+        uint32_t stageCount = drawStages();
+
+        // nodes[0] is the startpoint; nodes[i] is the "to" node of stage i
+        nodes.clear();
+        bool fromFlop = rng.chance(0.75);
+        nodes.push_back({fromFlop ? "FF" : "PI", rng.below(flopCount), fromFlop ? "_Q" : ""});
+        for (uint32_t s = 1; s < stageCount; ++s) {
+            if (s % 2 == 1) {
+                nodes.push_back({"NET", nets.sample(rng), ""});
+            } else {
+                uint64_t cell = netCount + cells.sample(rng);
+                nodes.push_back({kCellKinds[cell % 6], cell, ""});
+            }
+        }
+        bool toFlop = rng.chance(0.75);
+        nodes.push_back({toFlop ? "FF" : "PO", rng.below(flopCount), toFlop ? "_D" : ""});
+
+        delays.clear();
+        uint64_t total = 0;
+        for (uint32_t s = 0; s < stageCount; ++s) {
+            delays.push_back(drawDelay());
+            total += delays.back();
+        }
+
+        // Header: "Path P1     FF_D        PI          2.345"
+        out.literal("\n");
+        Corruption headerCorruption = drawCorruption();
+        if (headerCorruption == Corruption::GarbageLine) {
+            out.literal("#### corrupted line ####");
+            out.newline();
+        }
+        size_t column = out.position();
+        out.literal("Path ");
+        out.name("P", p);
+        out.pad(column, 12);
+        column = out.position();
+        out.name(nodes.back().prefix, nodes.back().index, nodes.back().suffix);
+        out.pad(column, 12);
+        column = out.position();
+        out.name(nodes.front().prefix, nodes.front().index, nodes.front().suffix);
+        out.pad(column, 12);
+        writeDelay(headerCorruption, total);
+
+        ++stats.paths;
+        bool validHeader = headerCorruption == Corruption::None ||
+                           headerCorruption == Corruption::GarbageLine;
+        if (validHeader) {
+            ++stats.validPaths;
+        }
+
+        // Stages: "P1.1   NET1        PI          0.123"
+        for (uint32_t s = 1; s <= stageCount; ++s) {
+            Corruption corruption = drawCorruption();
+            if (corruption == Corruption::GarbageLine) {
+                out.literal("#### corrupted line ####");
+                out.newline();
+            }
+            const Node& to = nodes[s];
+            const Node& from = nodes[s - 1];
+            column = out.position();
+            out.name("P", p);
+            out.literal(".");
+            out.number(s);
+            out.pad(column, 7);
+            column = out.position();
+            out.name(to.prefix, to.index, to.suffix);
+            out.pad(column, 12);
+            column = out.position();
+            out.name(from.prefix, from.index, from.suffix);
+            out.pad(column, 12);
+            writeDelay(corruption, delays[s - 1]);
+
+            if (validHeader && (corruption == Corruption::None ||
+                                corruption == Corruption::GarbageLine)) {
+                ++stats.stages;
+            }
+        }
+    }
+
+    out.literal("\nEnd of Timing Report\n");
+    stats.bytes = out.bytesWritten();
+    out.flush();
+    return stats;
+}
+
+GeneratorStats ReportGenerator::write(std::FILE* out) const {
+    GeneratorStats stats = generate([out](const char* data, size_t size) {
+        if (std::fwrite(data, 1, size, out) != size) {
+            throw std::runtime_error("Failed to write timing report");
+        }
+    });
+    if (std::fflush(out) != 0) {
+        throw std::runtime_error("Failed to write timing report");
+    }
+    return stats;
+}
+
+GeneratorStats ReportGenerator::writeFile(const std::string& path) const {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    GeneratorStats stats;
+    try {
+        stats = write(file);
+    } catch (...) {
+        std::fclose(file);
+        throw;
+    }
+    if (std::fclose(file) != 0) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+    return stats;
+}
+
+std::string ReportGenerator::toString(GeneratorStats* stats) const {
+    std::string report;
+    GeneratorStats result = generate([&report](const char* data, size_t size) {
+        report.append(data, size);
+    });
+    if (stats) {
+        *stats = result;
+    }
+    return report;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file report_generator.h
+ * @brief Defines ReportGenerator, which writes synthetic timing reports
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+/**
+ * @struct GeneratorOptions
+ * @brief Shape of a synthetic timing report
+ */
+struct GeneratorOptions {
+    enum class StageDistribution { Uniform, Geometric };
+    enum class DelayDistribution { Uniform, Exponential, LogNormal };
+
+    uint64_t pathCount{1000};
+    uint32_t minStages{2};
+    uint32_t maxStages{12};
+    StageDistribution stageDistribution{StageDistribution::Uniform};
+    double meanStages{6.0};             // Geometric only; clamped to [minStages, maxStages]
+
+    uint64_t nodeCount{100000};         // Distinct cell and net names stages draw from
+    double fanoutSkew{0.0};             // Zipf exponent over nodes; 0 is uniform
+
+    DelayDistribution delayDistribution{DelayDistribution::Uniform};
+    double minDelay{0.010};             // Every stage delay is clamped to [minDelay, maxDelay]
+    double maxDelay{1.500};
+    double meanDelay{0.400};            // Exponential and log-normal
+    double delaySigma{0.5};             // Log-normal shape
+
+    double malformedRate{0.0};          // Probability that a line is corrupted
+    double clockPeriod{10.0};           // Written to the "Clock Period:" preamble line
+    uint64_t seed{1};
+};
+
+/**
+ * @struct GeneratorStats
+ * @brief What a generator run wrote
+ */
+struct GeneratorStats {
+    uint64_t paths{0};              // Path sections written, including corrupted ones
+    uint64_t validPaths{0};         // Paths whose header parses
+    uint64_t stages{0};             // Well-formed stage lines of valid paths
+    uint64_t malformedLines{0};
+    uint64_t bytes{0};
+};
+
+/**
+ * @class ReportGenerator
+ * @brief Writes reports in the format TimingParser accepts
+ *
+ * Output depends only on the options: random numbers come from a seeded
+ * xoshiro256** generator and hand-written distributions rather than the
+ * implementation-defined std:: distributions, so the same seed produces the
+ * same bytes on every platform. Lines are formatted without stdio into a
+ * large buffer that is flushed in one write per few megabytes.
+ */
+class ReportGenerator {
+public:
+    using Sink = std::function<void(const char* data, size_t size)>;
+
+    /**
+     * @brief Create a generator
+     * @param options Report shape
+     * @throws std::invalid_argument if the options are inconsistent
+     */
+    explicit ReportGenerator(GeneratorOptions options);
+
+    /**
+     * @brief Generate the report into a sink
+     * @param sink Called with consecutive chunks of the report
+     * @return Counts of what was written
+     */
+    GeneratorStats generate(const Sink& sink) const;
+
+    /**
+     * @brief Generate the report into a stdio stream
+     * @param out Stream to write to
+     * @return Counts of what was written
+     * @throws std::runtime_error on write errors
+     */
+    GeneratorStats write(std::FILE* out) const;
+
+    /**
+     * @brief Generate the report into a file
+     * @param path File to create or truncate
+     * @return Counts of what was written
+     * @throws std::runtime_error if the file cannot be written
+     */
+    GeneratorStats writeFile(const std::string& path) const;
+
+    /**
+     * @brief Generate the report into memory
+     * @param stats Optional counts of what was written
+     * @return The report text
+     */
+    std::string toString(GeneratorStats* stats = nullptr) const;
+
+private:
+    GeneratorOptions options;
+};
@@ -0,0 +1,129 @@
+/**
+ * @file result_cache.cpp
+ * @brief Implementation of the per-report top-K result cache
+ */
+
+#include "result_cache.h"
+#include "content_hash.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <unistd.h>
+
+// Filesystem include based on compiler support
+#if defined(HAVE_STD_FILESYSTEM)
+  #include <filesystem>
+  namespace fs = std::filesystem;
+#elif defined(HAVE_STD_EXPERIMENTAL_FILESYSTEM)
+  #include <experimental/filesystem>
+  namespace fs = std::experimental::filesystem;
+#else
+  #error "No filesystem support available"
+#endif
+
+#ifndef TIMING_TOOL_VERSION
+#define TIMING_TOOL_VERSION "unknown"
+#endif
+
+ResultCache::ResultCache(std::string cacheDirectory, const std::string& settings)
+    : directory(std::move(cacheDirectory)) {
+    stamp = "# timing_analysis " TIMING_TOOL_VERSION " result cache v" +
+            std::to_string(kFormatVersion) + " " + settings;
+
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (!fs::is_directory(directory)) {
+        throw std::runtime_error("Failed to create cache directory: " + directory);
+    }
+}
+
+ResultCache::Entry ResultCache::lookup(const std::string& reportFile, ThreadPool& pool) {
+    uint64_t contentHash = ContentHash::hashFile(reportFile, pool);
+    std::error_code error;
+    uint64_t reportBytes = static_cast<uint64_t>(fs::file_size(reportFile, error));
+    return find(contentHash, error ? 0 : reportBytes);
+}
+
+ResultCache::Entry ResultCache::lookup(const char* data, size_t size, ThreadPool& pool) {
+    return find(ContentHash::hashBuffer(data, size, pool), size);
+}
+
+ResultCache::Entry ResultCache::find(uint64_t contentHash, uint64_t reportBytes) {
+    Entry entry;
+    entry.contentHash = contentHash;
+
+    // The settings hash in the name keeps entries for other options apart;
+    // the stamp line inside guards against collisions and foreign files
+    uint64_t settingsHash = ContentHash::xxh64(stamp.data(), stamp.size());
+    entry.path = (fs::path(directory) / (ContentHash::toHex(entry.contentHash) + "-" +
+                                         ContentHash::toHex(settingsHash) + ".top")).string();
+
+    std::ifstream file(entry.path);
+    std::string firstLine;
+    entry.hit = file && std::getline(file, firstLine) && firstLine == stamp;
+    if (entry.hit) {
+        ++hitCount;
+        hitBytes += reportBytes;
+    } else {
+        ++missCount;
+    }
+    return entry;
+}
+
+void ResultCache::store(const Entry& entry, const std::string& reportFile,
+                        const std::vector<PathExtent>& extents, std::vector<uint32_t> keep) {
+    std::sort(keep.begin(), keep.end());
+    std::string tempPath = entry.path + ".tmp" + std::to_string(::getpid());
+
+    bool written = false;
+    {
+        std::ifstream in(reportFile, std::ios::binary);
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (in && out) {
+            out << stamp << '\n';
+
+            // The preamble carries the Clock Period that --min-slack needs
+            std::string line;
+            while (std::getline(in, line) && line.find("Path ") != 0) {
+                out << line << '\n';
+            }
+
+            // Sections in report order, so ties still go to the earlier path
+            std::string buffer;
+            for (uint32_t position : keep) {
+                const PathExtent& extent = extents[position];
+                buffer.resize(extent.headerLength + extent.length);
+                in.clear();
+                in.seekg(static_cast<std::streamoff>(extent.offset - extent.headerLength));
+                in.read(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+                buffer.resize(static_cast<size_t>(in.gcount()));
+                if (buffer.empty() || buffer.back() != '\n') {
+                    buffer += '\n';  // Last section of a report without a final newline
+                }
+                out << buffer;
+            }
+            written = static_cast<bool>(out.flush());
+        }
+    }
+
+    if (!written || std::rename(tempPath.c_str(), entry.path.c_str()) != 0) {
+        std::cerr << "Warning: Failed to write cache entry for " << reportFile << std::endl;
+        std::remove(tempPath.c_str());
+    }
+}
+
+std::string ResultCache::summary() const {
+    std::ostringstream text;
+    text << "Cache: " << hitCount << (hitCount == 1 ? " hit, " : " hits, ")
+         << missCount << (missCount == 1 ? " miss" : " misses");
+    if (hitCount > 0) {
+        text << " (" << std::fixed << std::setprecision(1)
+             << static_cast<double>(hitBytes) / (1024.0 * 1024.0)
+             << " MB of reports not rescanned)";
+    }
+    return text.str();
+}
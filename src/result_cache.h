@@ -0,0 +1,110 @@
+/**
+ * @file result_cache.h
+ * @brief On-disk cache of each report's top-K path sections
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "parser.h"
+
+class ThreadPool;
+
+/**
+ * @class ResultCache
+ * @brief Lets unchanged reports skip the header scan of a top-K run
+ *
+ * Entries are keyed by the report's content hash and by a stamp naming the
+ * tool version, the cache format and every option that changes which paths a
+ * report contributes (top-K, --min-delay, --min-slack). An entry is itself a
+ * small report: the stamp line, the report's preamble and the sections of the
+ * report's own top K paths in report order. The global top K of several
+ * reports is always drawn from their per-report top K, so scanning entries
+ * instead of reports gives the same result.
+ */
+class ResultCache {
+public:
+    // Bump when the entry layout or the meaning of its contents changes
+    static constexpr int kFormatVersion = 1;
+
+    /**
+     * @struct Entry
+     * @brief Result of looking up one report
+     */
+    struct Entry {
+        uint64_t contentHash{0};
+        std::string path;  // Entry file, whether or not it exists yet
+        bool hit{false};
+    };
+
+    /**
+     * @brief Open a cache directory, creating it if needed
+     * @param cacheDirectory Cache directory
+     * @param settings Options that change a report's cached paths
+     * @throws std::runtime_error if the directory cannot be created
+     */
+    ResultCache(std::string cacheDirectory, const std::string& settings);
+
+    /**
+     * @brief Hash a report and look for its entry
+     * @param reportFile Report file path
+     * @param pool Workers for the chunked content hash
+     * @return The entry; hit is set when a complete entry with a matching stamp exists
+     * @throws std::runtime_error if the report cannot be read
+     */
+    Entry lookup(const std::string& reportFile, ThreadPool& pool);
+
+    /**
+     * @brief lookup() for a report whose contents are already in memory
+     * @param data Report contents
+     * @param size Bytes of report contents
+     * @param pool Workers for the chunked content hash
+     * @return The entry, as lookup() of the file would return it
+     */
+    Entry lookup(const char* data, size_t size, ThreadPool& pool);
+
+    /**
+     * @brief Write the entry for a report that missed
+     * @param entry Entry returned by lookup()
+     * @param reportFile Report file path
+     * @param extents Extents of the report's scanned paths
+     * @param keep Positions in extents of the paths to cache
+     *
+     * The entry is written to a temporary file and renamed into place, so a
+     * reader never sees a partial entry. Failures are reported as warnings;
+     * the run goes on without caching the report.
+     */
+    void store(const Entry& entry, const std::string& reportFile,
+               const std::vector<PathExtent>& extents, std::vector<uint32_t> keep);
+
+    /**
+     * @brief Get the number of reports found in the cache
+     * @return Hit count
+     */
+    size_t hits() const { return hitCount; }
+
+    /**
+     * @brief Get the number of reports that had to be scanned
+     * @return Miss count
+     */
+    size_t misses() const { return missCount; }
+
+    /**
+     * @brief Summarize hits and misses
+     * @return e.g. "Cache: 3 hits, 1 miss (42.0 MB of reports not rescanned)"
+     */
+    std::string summary() const;
+
+private:
+    // Name and check the entry for a report's content hash
+    Entry find(uint64_t contentHash, uint64_t reportBytes);
+
+    std::string directory;
+    std::string stamp;  // First line of every entry
+    size_t hitCount{0};
+    size_t missCount{0};
+    uint64_t hitBytes{0};
+};
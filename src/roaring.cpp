@@ -0,0 +1,284 @@
+/**
+ * @file roaring.cpp
+ * @brief Implementation of RoaringBitmap
+ */
+
+#include "roaring.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+using Container = RoaringBitmap::Container;
+
+// Containers with more values than this are stored as bitsets
+constexpr uint32_t kArrayMax = 4096;
+constexpr size_t kBitsetWords = 65536 / 64;
+
+uint32_t popcount(const std::vector<uint64_t>& words) {
+    uint32_t total = 0;
+    for (uint64_t word : words) {
+        total += static_cast<uint32_t>(__builtin_popcountll(word));
+    }
+    return total;
+}
+
+// Pick the cheaper representation for a container's current contents
+void normalize(Container& c) {
+    if (c.isBitset()) {
+        c.cardinality = popcount(c.bitset);
+        if (c.cardinality <= kArrayMax) {
+            c.array.clear();
+            c.array.reserve(c.cardinality);
+            for (size_t w = 0; w < kBitsetWords; ++w) {
+                uint64_t word = c.bitset[w];
+                while (word) {
+                    c.array.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+            c.bitset.clear();
+            c.bitset.shrink_to_fit();
+        }
+    } else {
+        c.cardinality = static_cast<uint32_t>(c.array.size());
+        if (c.cardinality > kArrayMax) {
+            c.bitset.assign(kBitsetWords, 0);
+            for (uint16_t v : c.array) {
+                c.bitset[v / 64] |= uint64_t{1} << (v % 64);
+            }
+            c.array.clear();
+            c.array.shrink_to_fit();
+        }
+    }
+}
+
+bool testBit(const std::vector<uint64_t>& bitset, uint16_t v) {
+    return (bitset[v / 64] >> (v % 64)) & 1;
+}
+
+Container intersect(const Container& a, const Container& b) {
+    Container out;
+    if (a.isBitset() && b.isBitset()) {
+        out.bitset.resize(kBitsetWords);
+        for (size_t w = 0; w < kBitsetWords; ++w) {
+            out.bitset[w] = a.bitset[w] & b.bitset[w];
+        }
+    } else if (a.isBitset() || b.isBitset()) {
+        const Container& sparse = a.isBitset() ? b : a;
+        const Container& dense = a.isBitset() ? a : b;
+        for (uint16_t v : sparse.array) {
+            if (testBit(dense.bitset, v)) {
+                out.array.push_back(v);
+            }
+        }
+    } else {
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                              std::back_inserter(out.array));
+    }
+    normalize(out);
+    return out;
+}
+
+Container unite(const Container& a, const Container& b) {
+    Container out;
+    if (a.isBitset() || b.isBitset()) {
+        out.bitset = a.isBitset() ? a.bitset : b.bitset;
+        const Container& other = a.isBitset() ? b : a;
+        if (other.isBitset()) {
+            for (size_t w = 0; w < kBitsetWords; ++w) {
+                out.bitset[w] |= other.bitset[w];
+            }
+        } else {
+            for (uint16_t v : other.array) {
+                out.bitset[v / 64] |= uint64_t{1} << (v % 64);
+            }
+        }
+    } else {
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                       std::back_inserter(out.array));
+    }
+    normalize(out);
+    return out;
+}
+
+Container subtract(const Container& a, const Container& b) {
+    Container out;
+    if (a.isBitset()) {
+        out.bitset = a.bitset;
+        if (b.isBitset()) {
+            for (size_t w = 0; w < kBitsetWords; ++w) {
+                out.bitset[w] &= ~b.bitset[w];
+            }
+        } else {
+            for (uint16_t v : b.array) {
+                out.bitset[v / 64] &= ~(uint64_t{1} << (v % 64));
+            }
+        }
+    } else if (b.isBitset()) {
+        for (uint16_t v : a.array) {
+            if (!testBit(b.bitset, v)) {
+                out.array.push_back(v);
+            }
+        }
+    } else {
+        std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                            std::back_inserter(out.array));
+    }
+    normalize(out);
+    return out;
+}
+
+} // namespace
+
+RoaringBitmap RoaringBitmap::fromSorted(const std::vector<uint32_t>& ids) {
+    RoaringBitmap bitmap;
+    for (uint32_t id : ids) {
+        uint16_t key = static_cast<uint16_t>(id >> 16);
+        if (bitmap.keys.empty() || bitmap.keys.back() != key) {
+            if (!bitmap.containers.empty()) {
+                normalize(bitmap.containers.back());
+            }
+            bitmap.keys.push_back(key);
+            bitmap.containers.emplace_back();
+        }
+        bitmap.containers.back().array.push_back(static_cast<uint16_t>(id & 0xffff));
+    }
+    if (!bitmap.containers.empty()) {
+        normalize(bitmap.containers.back());
+    }
+    return bitmap;
+}
+
+RoaringBitmap RoaringBitmap::range(uint32_t count) {
+    RoaringBitmap bitmap;
+    for (uint64_t start = 0; start < count; start += 65536) {
+        uint32_t inChunk = static_cast<uint32_t>(std::min<uint64_t>(65536, count - start));
+        Container c;
+        c.bitset.assign(kBitsetWords, 0);
+        for (uint32_t w = 0; w < inChunk / 64; ++w) {
+            c.bitset[w] = ~uint64_t{0};
+        }
+        if (inChunk % 64) {
+            c.bitset[inChunk / 64] = (uint64_t{1} << (inChunk % 64)) - 1;
+        }
+        normalize(c);
+        bitmap.keys.push_back(static_cast<uint16_t>(start >> 16));
+        bitmap.containers.push_back(std::move(c));
+    }
+    return bitmap;
+}
+
+bool RoaringBitmap::contains(uint32_t id) const {
+    uint16_t key = static_cast<uint16_t>(id >> 16);
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key) {
+        return false;
+    }
+
+    const Container& c = containers[static_cast<size_t>(it - keys.begin())];
+    uint16_t low = static_cast<uint16_t>(id & 0xffff);
+    if (c.isBitset()) {
+        return testBit(c.bitset, low);
+    }
+    return std::binary_search(c.array.begin(), c.array.end(), low);
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (const auto& c : containers) {
+        total += c.cardinality;
+    }
+    return total;
+}
+
+std::vector<uint32_t> RoaringBitmap::toIds() const {
+    std::vector<uint32_t> ids;
+    ids.reserve(cardinality());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        uint32_t high = static_cast<uint32_t>(keys[i]) << 16;
+        const Container& c = containers[i];
+        if (c.isBitset()) {
+            for (size_t w = 0; w < kBitsetWords; ++w) {
+                uint64_t word = c.bitset[w];
+                while (word) {
+                    ids.push_back(high | static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (uint16_t v : c.array) {
+                ids.push_back(high | v);
+            }
+        }
+    }
+    return ids;
+}
+
+size_t RoaringBitmap::sizeInBytes() const {
+    size_t bytes = keys.capacity() * sizeof(uint16_t) + containers.capacity() * sizeof(Container);
+    for (const auto& c : containers) {
+        bytes += c.array.capacity() * sizeof(uint16_t) + c.bitset.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap out;
+    size_t i = 0, j = 0;
+    while (i < a.keys.size() && j < b.keys.size()) {
+        if (a.keys[i] < b.keys[j]) {
+            ++i;
+        } else if (a.keys[i] > b.keys[j]) {
+            ++j;
+        } else {
+            Container c = intersect(a.containers[i], b.containers[j]);
+            if (c.cardinality > 0) {
+                out.keys.push_back(a.keys[i]);
+                out.containers.push_back(std::move(c));
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return out;
+}
+
+RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap out;
+    size_t i = 0, j = 0;
+    while (i < a.keys.size() || j < b.keys.size()) {
+        if (j == b.keys.size() || (i < a.keys.size() && a.keys[i] < b.keys[j])) {
+            out.keys.push_back(a.keys[i]);
+            out.containers.push_back(a.containers[i++]);
+        } else if (i == a.keys.size() || a.keys[i] > b.keys[j]) {
+            out.keys.push_back(b.keys[j]);
+            out.containers.push_back(b.containers[j++]);
+        } else {
+            out.keys.push_back(a.keys[i]);
+            out.containers.push_back(unite(a.containers[i++], b.containers[j++]));
+        }
+    }
+    return out;
+}
+
+RoaringBitmap andNot(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap out;
+    size_t j = 0;
+    for (size_t i = 0; i < a.keys.size(); ++i) {
+        while (j < b.keys.size() && b.keys[j] < a.keys[i]) {
+            ++j;
+        }
+        if (j < b.keys.size() && b.keys[j] == a.keys[i]) {
+            Container c = subtract(a.containers[i], b.containers[j]);
+            if (c.cardinality > 0) {
+                out.keys.push_back(a.keys[i]);
+                out.containers.push_back(std::move(c));
+            }
+        } else {
+            out.keys.push_back(a.keys[i]);
+            out.containers.push_back(a.containers[i]);
+        }
+    }
+    return out;
+}
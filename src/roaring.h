@@ -0,0 +1,93 @@
+/**
+ * @file roaring.h
+ * @brief Defines RoaringBitmap, a compressed bitmap over 32-bit path IDs
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class RoaringBitmap
+ * @brief Compressed set of 32-bit IDs with fast AND / OR / ANDNOT
+ *
+ * IDs are split by their high 16 bits into chunks of 65536. Each non-empty
+ * chunk is stored in a container that is either a sorted array of low 16-bit
+ * values (up to 4096 entries) or a 65536-bit bitset, whichever is smaller.
+ * Set operations work container by container and only touch chunks present
+ * in both operands where possible.
+ */
+class RoaringBitmap {
+public:
+    RoaringBitmap() = default;
+
+    /**
+     * @brief Build a bitmap from ascending IDs
+     * @param ids Sorted, duplicate-free IDs
+     * @return The bitmap
+     */
+    static RoaringBitmap fromSorted(const std::vector<uint32_t>& ids);
+
+    /**
+     * @brief Build a bitmap holding every ID in [0, count)
+     * @param count Number of IDs
+     * @return The bitmap
+     */
+    static RoaringBitmap range(uint32_t count);
+
+    /**
+     * @brief Check whether an ID is in the set
+     * @param id ID to test
+     * @return True if present
+     */
+    bool contains(uint32_t id) const;
+
+    /**
+     * @brief Count the IDs in the set
+     * @return Cardinality
+     */
+    uint64_t cardinality() const;
+
+    bool empty() const { return keys.empty(); }
+
+    /**
+     * @brief List the IDs in the set
+     * @return Ascending IDs
+     */
+    std::vector<uint32_t> toIds() const;
+
+    /**
+     * @brief Estimate the heap memory held by the bitmap
+     * @return Bytes used by keys and containers
+     */
+    size_t sizeInBytes() const;
+
+    friend RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b);
+    friend RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b);
+
+    /**
+     * @brief Set difference
+     * @param a Minuend
+     * @param b Subtrahend
+     * @return IDs in a that are not in b
+     */
+    friend RoaringBitmap andNot(const RoaringBitmap& a, const RoaringBitmap& b);
+
+    /**
+     * @struct Container
+     * @brief Low 16 bits of the IDs in one 65536-ID chunk
+     */
+    struct Container {
+        std::vector<uint16_t> array;    // Sorted values while sparse
+        std::vector<uint64_t> bitset;   // 1024 words once dense; empty otherwise
+        uint32_t cardinality{0};
+
+        bool isBitset() const { return !bitset.empty(); }
+    };
+
+private:
+    std::vector<uint16_t> keys;          // High 16 bits, ascending
+    std::vector<Container> containers;   // Parallel to keys
+};
@@ -0,0 +1,349 @@
+/**
+ * @file server.cpp
+ * @brief Implementation of the TimingServer class
+ */
+
+#include "server.h"
+#include "radix_rank.h"
+#include "utils.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// How often the accept loop wakes up to check for stop()
+constexpr int kAcceptPollMs = 200;
+
+// Longest request line; a client that sends more without '\n' is cut off
+constexpr size_t kMaxRequestBytes = 64 * 1024;
+
+// Write the whole buffer, retrying on short writes
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+#ifdef MSG_NOSIGNAL
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+#else
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, 0);
+#endif
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+std::string errorResponse(const std::string& message) {
+    return "ERR " + message + "\n";
+}
+
+} // namespace
+
+TimingServer::TimingServer(std::string source, int defaultTopK)
+    : defaultTopK(defaultTopK) {
+    reload(source);
+}
+
+void TimingServer::reload(const std::string& source) {
+    std::string target = source;
+    if (target.empty()) {
+        auto current = snapshot();
+        if (!current) {
+            throw std::runtime_error("No timing report to load");
+        }
+        target = current->source;
+    }
+
+    // Parse outside the lock so queries keep running against the old database
+    auto loaded = loadDatabase(target);
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    database = std::move(loaded);
+}
+
+std::shared_ptr<const TimingDatabase> TimingServer::loadDatabase(const std::string& source) {
+    auto db = std::make_shared<TimingDatabase>();
+    db->source = source;
+
+    for (const auto& file : Utils::collectReportFiles(source)) {
+        auto paths = db->parser.parseFile(file);
+        db->paths.insert(db->paths.end(),
+                         std::make_move_iterator(paths.begin()),
+                         std::make_move_iterator(paths.end()));
+    }
+
+    // Rank once; every query answers from this order
+    std::vector<uint32_t> positions(db->paths.size());
+    std::iota(positions.begin(), positions.end(), 0u);
+    ThreadPool pool;
+    auto ranked = RadixRank::rankPaths(db->paths, positions, pool);
+    db->rankOrder.assign(ranked.begin(), ranked.end());
+
+    for (size_t index : db->rankOrder) {
+        db->endpointPaths[db->paths[index].endpoint].push_back(index);
+    }
+
+    db->pathIndex = PathIndex::build(db->paths, db->parser.nodeCount());
+
+    db->bitmapIndex = BitmapIndex::build(db->pathIndex, BitmapIndex::kDefaultMinPaths, pool);
+
+    return db;
+}
+
+std::shared_ptr<const TimingDatabase> TimingServer::snapshot() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return database;
+}
+
+std::string TimingServer::handleRequest(const std::string& request) {
+    std::istringstream in(request);
+    std::string command;
+    in >> command;
+    std::transform(command.begin(), command.end(), command.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    std::vector<std::string> args;
+    std::string arg;
+    while (in >> arg) {
+        args.push_back(arg);
+    }
+
+    // Parse an optional K argument at the given position
+    auto topKArg = [&](size_t position) {
+        if (args.size() <= position) {
+            return defaultTopK;
+        }
+        const std::string& text = args[position];
+        if (text.find_first_not_of("0123456789") != std::string::npos) {
+            throw std::invalid_argument("K must be a non-negative integer: " + text);
+        }
+        // Ten digits always fit an unsigned long, so stoul cannot throw here
+        if (text.size() > 10 ||
+            std::stoul(text) > static_cast<unsigned long>(std::numeric_limits<int>::max())) {
+            throw std::invalid_argument("K is too large: " + text);
+        }
+        return static_cast<int>(std::stoul(text));
+    };
+
+    try {
+        if (command.empty()) {
+            return errorResponse("empty request");
+        } else if (command == "PING") {
+            return "OK 1\nPONG\n";
+        } else if (command == "TOPK") {
+            auto db = snapshot();
+            size_t k = std::min(static_cast<size_t>(topKArg(0)), db->rankOrder.size());
+            std::vector<size_t> selected(db->rankOrder.begin(), db->rankOrder.begin() + k);
+            return formatPaths(*db, selected);
+        } else if (command == "THROUGH") {
+            // THROUGH A [B ...] [!C ...] [K]: a trailing number is K, '!' excludes a node.
+            // Node names may start with digits, so only an all-digit token is K
+            int k = defaultTopK;
+            if (!args.empty() && args.back().find_first_not_of("0123456789") == std::string::npos) {
+                k = topKArg(args.size() - 1);
+                args.pop_back();
+            }
+            auto db = snapshot();
+            std::vector<uint32_t> include, exclude;
+            for (const auto& name : args) {
+                if (name.size() > 1 && name[0] == '!') {
+                    exclude.push_back(db->parser.findNodeId(name.substr(1)));
+                } else {
+                    include.push_back(db->parser.findNodeId(name));
+                }
+            }
+            if (include.empty()) {
+                return errorResponse("usage: THROUGH NODE [NODE ...] [!NODE ...] [K]");
+            }
+
+            TimingAnalyzer analyzer;
+            if (include.size() == 1 && exclude.empty()) {
+                return formatAnalyses(analyzer.findPathsThrough(
+                    db->paths, db->pathIndex, include[0], k));
+            }
+            auto selected = db->bitmapIndex.select(db->pathIndex, include, exclude,
+                                                   static_cast<uint32_t>(db->paths.size()));
+            return formatAnalyses(analyzer.findCriticalPaths(db->paths, selected.toIds(), k));
+        } else if (command == "ENDPOINT") {
+            if (args.empty()) {
+                return errorResponse("usage: ENDPOINT NAME [K]");
+            }
+            auto db = snapshot();
+            size_t k = static_cast<size_t>(topKArg(1));
+            std::vector<size_t> selected;
+            auto it = db->endpointPaths.find(args[0]);
+            if (it != db->endpointPaths.end()) {
+                size_t count = std::min(k, it->second.size());
+                selected.assign(it->second.begin(), it->second.begin() + count);
+            }
+            return formatPaths(*db, selected);
+        } else if (command == "RELOAD") {
+            reload(args.empty() ? "" : args[0]);
+            auto db = snapshot();
+            return "OK 1\nloaded " + std::to_string(db->paths.size()) +
+                   " paths from " + db->source + "\n";
+        } else if (command == "STATS") {
+            auto db = snapshot();
+            std::stringstream response;
+            response << "OK 3\n"
+                     << "source " << db->source << "\n"
+                     << "paths " << db->paths.size() << "\n"
+                     << "endpoints " << db->endpointPaths.size() << "\n";
+            return response.str();
+        }
+    } catch (const std::exception& e) {
+        return errorResponse(e.what());
+    }
+
+    return errorResponse("unknown command: " + command);
+}
+
+std::string TimingServer::formatPaths(const TimingDatabase& db,
+                                      const std::vector<size_t>& pathIndices) {
+    TimingAnalyzer analyzer;
+    std::vector<TimingPathAnalysis> analyses;
+    for (size_t index : pathIndices) {
+        analyses.push_back(analyzer.analyzePath(db.paths[index]));
+    }
+
+    return formatAnalyses(analyses);
+}
+
+std::string TimingServer::formatAnalyses(const std::vector<TimingPathAnalysis>& analyses) {
+    std::stringstream response;
+
+    response << "OK " << analyses.size() << "\n";
+    for (size_t i = 0; i < analyses.size(); ++i) {
+        response << Utils::formatPathResult(static_cast<int>(i + 1), analyses[i]) << "\n";
+    }
+
+    return response.str();
+}
+
+void TimingServer::serve(const std::string& socketPath) {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + socketPath);
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        throw std::runtime_error("Failed to create socket: " + std::string(std::strerror(errno)));
+    }
+
+    // A stale socket from a previous run would make bind() fail
+    ::unlink(socketPath.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listenFd, SOMAXCONN) < 0) {
+        std::string reason = std::strerror(errno);
+        ::close(listenFd);
+        throw std::runtime_error("Failed to listen on " + socketPath + ": " + reason);
+    }
+
+    // Clients that disconnect mid-response must not kill the server
+    std::signal(SIGPIPE, SIG_IGN);
+
+    running = true;
+    while (running) {
+        pollfd pfd{listenFd, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, kAcceptPollMs);
+        reapClients();
+        if (ready <= 0) {
+            continue;
+        }
+
+        int clientFd = ::accept(listenFd, nullptr, nullptr);
+        if (clientFd < 0) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(clientMutex);
+        clientFds.insert(clientFd);
+        clientThreads.emplace_back(&TimingServer::handleClient, this, clientFd);
+    }
+
+    ::close(listenFd);
+    ::unlink(socketPath.c_str());
+
+    // Wake up clients blocked in recv() and wait for them to finish
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(clientMutex);
+        for (int fd : clientFds) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+        threads.swap(clientThreads);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void TimingServer::handleClient(int clientFd) {
+    std::string pending;
+    char buffer[4096];
+
+    while (true) {
+        ssize_t n = ::recv(clientFd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+
+        pending.append(buffer, static_cast<size_t>(n));
+
+        // Answer every complete line received so far
+        size_t lineStart = 0;
+        size_t newline;
+        bool ok = true;
+        while (ok && (newline = pending.find('\n', lineStart)) != std::string::npos) {
+            std::string request = pending.substr(lineStart, newline - lineStart);
+            if (!request.empty() && request.back() == '\r') {
+                request.pop_back();
+            }
+            lineStart = newline + 1;
+            ok = sendAll(clientFd, handleRequest(request));
+        }
+        pending.erase(0, lineStart);
+
+        if (ok && pending.size() > kMaxRequestBytes) {
+            sendAll(clientFd, errorResponse("request line longer than " +
+                                            std::to_string(kMaxRequestBytes) + " bytes"));
+            break;
+        }
+        if (!ok) break;
+    }
+
+    std::lock_guard<std::mutex> lock(clientMutex);
+    clientFds.erase(clientFd);
+    ::close(clientFd);
+    finishedClients.push_back(std::this_thread::get_id());
+}
+
+void TimingServer::reapClients() {
+    std::lock_guard<std::mutex> lock(clientMutex);
+    for (auto id : finishedClients) {
+        auto it = std::find_if(clientThreads.begin(), clientThreads.end(),
+                               [id](const std::thread& t) { return t.get_id() == id; });
+        if (it != clientThreads.end()) {
+            it->join();
+            clientThreads.erase(it);
+        }
+    }
+    finishedClients.clear();
+}
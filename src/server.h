@@ -0,0 +1,139 @@
+/**
+ * @file server.h
+ * @brief Defines the TimingServer class for answering queries over a Unix domain socket
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "analyzer.h"
+#include "bitmap_index.h"
+#include "parser.h"
+#include "path_index.h"
+
+/**
+ * @struct TimingDatabase
+ * @brief Parsed timing paths kept resident by the server
+ *
+ * Paths are ranked once at load time so that top-K and filter queries only
+ * walk the paths they return.
+ */
+struct TimingDatabase {
+    std::string source;                  // File or directory the paths came from
+    TimingParser parser;                 // Owns the interned node table
+    std::vector<TimingPath> paths;
+    std::vector<size_t> rankOrder;       // Path indices by descending total delay
+    PathIndex pathIndex;                 // Node ID -> paths through it
+    BitmapIndex bitmapIndex;             // Bitmaps for nodes on many paths
+
+    // Endpoint name -> path indices, in rank order
+    std::unordered_map<std::string, std::vector<size_t>> endpointPaths;
+};
+
+/**
+ * @class TimingServer
+ * @brief Keeps a parsed timing database resident and answers line-protocol requests
+ *
+ * Each request is a single line; each response starts with "OK <n>" followed by
+ * n result lines, or is a single "ERR <message>" line. Supported requests:
+ *
+ *   TOPK [K]             Top K critical paths
+ *   THROUGH NODE... [K]  Top K paths through every NODE; "!NODE" excludes a node
+ *   ENDPOINT NAME [K]    Top K paths ending at NAME
+ *   RELOAD [PATH]        Reparse the current source, or switch to PATH
+ *   STATS                Database summary
+ *   PING                 Liveness check
+ */
+class TimingServer {
+public:
+    /**
+     * @brief Create a server for a timing report file or directory of reports
+     * @param source Report file or directory path
+     * @param defaultTopK Number of paths returned when a request omits K
+     */
+    explicit TimingServer(std::string source, int defaultTopK = 10);
+
+    /**
+     * @brief Parse the source and replace the resident database
+     * @param source Report file or directory; empty to reparse the current source
+     * @throws std::runtime_error if the source cannot be parsed
+     */
+    void reload(const std::string& source = "");
+
+    /**
+     * @brief Answer a single protocol request
+     * @param request Request line without the trailing newline
+     * @return Response text, newline-terminated
+     */
+    std::string handleRequest(const std::string& request);
+
+    /**
+     * @brief Listen on a Unix domain socket until stop() is called
+     * @param socketPath Filesystem path of the socket to create
+     * @throws std::runtime_error if the socket cannot be created
+     */
+    void serve(const std::string& socketPath);
+
+    /**
+     * @brief Ask serve() to return; safe to call from a signal handler
+     */
+    void stop() { running = false; }
+
+private:
+    /**
+     * @brief Parse and rank a source into a new database
+     * @param source Report file or directory path
+     * @return The loaded database
+     */
+    static std::shared_ptr<const TimingDatabase> loadDatabase(const std::string& source);
+
+    /**
+     * @brief Get the current database; the snapshot stays valid across reloads
+     * @return Shared pointer to the current database
+     */
+    std::shared_ptr<const TimingDatabase> snapshot() const;
+
+    /**
+     * @brief Serve requests from one connected client until it disconnects
+     * @param clientFd Connected socket descriptor
+     */
+    void handleClient(int clientFd);
+
+    /**
+     * @brief Format a list of paths as an "OK" response
+     * @param db Database the path indices refer to
+     * @param pathIndices Indices of the paths to report, in rank order
+     * @return Response text
+     */
+    std::string formatPaths(const TimingDatabase& db, const std::vector<size_t>& pathIndices);
+
+    /**
+     * @brief Format analyzed paths as an "OK" response
+     * @param analyses Path analyses in rank order
+     * @return Response text
+     */
+    std::string formatAnalyses(const std::vector<TimingPathAnalysis>& analyses);
+
+    /**
+     * @brief Join client threads that have disconnected
+     */
+    void reapClients();
+
+    int defaultTopK;
+
+    mutable std::mutex stateMutex;
+    std::shared_ptr<const TimingDatabase> database;
+
+    std::atomic<bool> running{false};
+    std::mutex clientMutex;
+    std::unordered_set<int> clientFds;
+    std::vector<std::thread> clientThreads;
+    std::vector<std::thread::id> finishedClients;
+};
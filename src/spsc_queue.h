@@ -0,0 +1,144 @@
+/**
+ * @file spsc_queue.h
+ * @brief Bounded lock-free single-producer single-consumer queue
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+
+/**
+ * @class SpscQueue
+ * @brief Fixed-capacity ring buffer for handing work from one thread to another
+ *
+ * Exactly one thread may push and exactly one thread may pop. The producer
+ * owns the tail index and the consumer the head index; each only reads the
+ * other's index, so no locks are needed. A full queue makes push() wait,
+ * which is the backpressure that bounds a pipeline's memory. close() tells
+ * the consumer that nothing more will arrive. A side that keeps waiting
+ * spins, then yields, then sleeps in naps of up to a millisecond, so stages
+ * idled by a slow one do not hold a core each.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * @brief Create an empty queue
+     * @param capacity Most items held at once, rounded up to a power of two
+     */
+    explicit SpscQueue(size_t capacity) {
+        size_t slots = 2;
+        while (slots < capacity) {
+            slots <<= 1;
+        }
+        mask = slots - 1;
+        ring = std::make_unique<std::optional<T>[]>(slots);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Add an item unless the queue is full
+     * @param item Item to move in
+     * @return False if the queue was full; item is left untouched
+     */
+    bool tryPush(T& item) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) > mask) {
+            return false;
+        }
+        ring[tail & mask].emplace(std::move(item));
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest item if there is one
+     * @param item Receives the item
+     * @return False if the queue was empty
+     */
+    bool tryPop(T& item) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        auto& slot = ring[head & mask];
+        item = std::move(*slot);
+        slot.reset();
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Add an item, waiting while the queue is full
+     * @param item Item to move in
+     * @param cancelled Gives up waiting once this is set
+     * @return False if cancelled before the item fit
+     */
+    bool push(T item, const std::atomic<bool>& cancelled) {
+        for (unsigned spins = 0; !tryPush(item); ++spins) {
+            if (cancelled.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            backoff(spins);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest item, waiting while the queue is empty
+     * @param item Receives the item
+     * @param cancelled Gives up waiting once this is set
+     * @return False once the queue is closed and drained, or when cancelled
+     */
+    bool pop(T& item, const std::atomic<bool>& cancelled) {
+        for (unsigned spins = 0; !tryPop(item); ++spins) {
+            // Items pushed before close() are still delivered
+            if (closed.load(std::memory_order_acquire)) {
+                return tryPop(item);
+            }
+            if (cancelled.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            backoff(spins);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Mark the end of the stream; called by the producer
+     */
+    void close() { closed.store(true, std::memory_order_release); }
+
+private:
+    // Spin briefly, then give the CPU to the other stages, then sleep; yield()
+    // alone returns at once when no other thread wants the core
+    static void backoff(unsigned spins) {
+        constexpr unsigned kSpins = 64;
+        constexpr unsigned kYields = 256;
+        if (spins < kSpins) {
+            return;
+        }
+        if (spins < kSpins + kYields) {
+            std::this_thread::yield();
+            return;
+        }
+        unsigned naps = std::min(spins - kSpins - kYields, 5u);
+        std::this_thread::sleep_for(std::chrono::microseconds(std::min(50u << naps, 1000u)));
+    }
+
+    // Indices grow without wrapping; the slot is index & mask
+    alignas(64) std::atomic<size_t> headIndex{0};
+    alignas(64) std::atomic<size_t> tailIndex{0};
+    alignas(64) std::atomic<bool> closed{false};
+    size_t mask{0};
+    std::unique_ptr<std::optional<T>[]> ring;
+};
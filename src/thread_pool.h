@@ -0,0 +1,94 @@
+/**
+ * @file thread_pool.h
+ * @brief Defines a fixed-size ThreadPool for parallel build and parse work
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "trace.h"
+
+/**
+ * @class ThreadPool
+ * @brief Runs submitted tasks on a fixed set of worker threads
+ *
+ * wait() blocks until every task submitted so far has finished and rethrows
+ * the first exception a task raised.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Start the worker threads
+     * @param threads Number of workers; 0 picks one per hardware thread
+     */
+    explicit ThreadPool(size_t threads = 0);
+
+    /**
+     * @brief Finish queued tasks and join the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task for execution
+     * @param task Callable to run on a worker
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Wait for all submitted tasks to finish
+     * @throws Any exception thrown by a task
+     */
+    void wait();
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Worker count
+     */
+    size_t size() const { return workers.size(); }
+
+    /**
+     * @brief Run fn(begin, end) over [0, count) split into one chunk per worker
+     * @param count Number of items
+     * @param fn Callable taking the half-open item range of a chunk
+     */
+    template <typename Fn>
+    void parallelFor(size_t count, Fn fn) {
+        size_t chunks = std::min(count, size());
+        for (size_t c = 0; c < chunks; ++c) {
+            size_t begin = count * c / chunks;
+            size_t end = count * (c + 1) / chunks;
+            submit([fn, begin, end] {
+                Trace::Span span("chunk", "pool");
+                span.setRange(begin, end);
+                fn(begin, end);
+            });
+        }
+        wait();
+    }
+
+private:
+    /**
+     * @brief Worker loop: run tasks until the pool shuts down
+     */
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    std::condition_variable allDone;
+    size_t pending{0};           // Queued plus running tasks
+    bool stopping{false};
+    std::exception_ptr firstError;
+};
@@ -0,0 +1,234 @@
+/**
+ * @file timing_c.cpp
+ * @brief Implementation of the libtiming C API over TimingParser and TimingAnalyzer
+ */
+
+#include "timing_c.h"
+#include "analyzer.h"
+#include "parser.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct timing_report {
+    TimingParser parser;  // Owns the node table the paths' edges point into
+    std::vector<TimingPath> paths;
+    std::unordered_map<std::string, size_t> byId;
+};
+
+struct timing_topk {
+    const timing_report* report;
+    std::vector<uint32_t> ranked;
+    size_t next{0};
+};
+
+namespace {
+
+// Copy a string the way snprintf would, reporting whether it fit
+timing_status copyString(const std::string& text, char* buffer, size_t size, size_t* length) {
+    if (length) {
+        *length = text.size();
+    }
+    if (!buffer || size == 0) {
+        return text.empty() ? TIMING_OK : TIMING_ERROR_BUFFER_TOO_SMALL;
+    }
+    size_t copied = std::min(text.size(), size - 1);
+    std::memcpy(buffer, text.data(), copied);
+    buffer[copied] = '\0';
+    return copied == text.size() ? TIMING_OK : TIMING_ERROR_BUFFER_TOO_SMALL;
+}
+
+void fillInfo(const timing_report& report, size_t index, timing_path_info& info) {
+    const TimingPath& path = report.paths[index];
+    info.index = index;
+    info.total_delay = path.totalDelay;
+    info.worst_stage_delay = path.getWorstStage().first;
+    info.stage_count = path.edges.size();
+}
+
+bool validPath(const timing_report* report, size_t index) {
+    return report && index < report->paths.size();
+}
+
+} // namespace
+
+extern "C" {
+
+int timing_api_version(void) {
+    return TIMING_C_API_VERSION;
+}
+
+const char* timing_status_string(timing_status status) {
+    switch (status) {
+        case TIMING_OK:
+            return "ok";
+        case TIMING_ERROR_INVALID_ARGUMENT:
+            return "invalid argument";
+        case TIMING_ERROR_IO:
+            return "report could not be read";
+        case TIMING_ERROR_NOT_FOUND:
+            return "path not found";
+        case TIMING_ERROR_BUFFER_TOO_SMALL:
+            return "buffer too small";
+        default:
+            return "internal error";
+    }
+}
+
+timing_status timing_report_open(const char* filename, timing_report** report,
+                                 char* error, size_t error_size) {
+    if (report) {
+        *report = nullptr;
+    }
+    if (!filename || !report) {
+        copyString("filename and report must not be NULL", error, error_size, nullptr);
+        return TIMING_ERROR_INVALID_ARGUMENT;
+    }
+    // Tell an unreadable file apart from failures while parsing it
+    if (!std::ifstream(filename)) {
+        copyString(std::string("Failed to open file: ") + filename, error, error_size, nullptr);
+        return TIMING_ERROR_IO;
+    }
+
+    try {
+        auto opened = std::make_unique<timing_report>();
+        opened->paths = opened->parser.parseFile(filename);
+        opened->byId.reserve(opened->paths.size());
+        for (size_t i = 0; i < opened->paths.size(); ++i) {
+            // The first of duplicate IDs wins, as with --path
+            opened->byId.emplace(opened->paths[i].id, i);
+        }
+        *report = opened.release();
+        return TIMING_OK;
+    } catch (const std::exception& e) {
+        copyString(e.what(), error, error_size, nullptr);
+        return TIMING_ERROR_INTERNAL;
+    } catch (...) {
+        copyString("unknown error", error, error_size, nullptr);
+        return TIMING_ERROR_INTERNAL;
+    }
+}
+
+void timing_report_free(timing_report* report) {
+    delete report;
+}
+
+size_t timing_report_path_count(const timing_report* report) {
+    return report ? report->paths.size() : 0;
+}
+
+timing_status timing_topk_begin(const timing_report* report, size_t k, timing_topk** topk) {
+    if (topk) {
+        *topk = nullptr;
+    }
+    if (!report || !topk) {
+        return TIMING_ERROR_INVALID_ARGUMENT;
+    }
+    try {
+        auto iterator = std::make_unique<timing_topk>();
+        iterator->report = report;
+        std::vector<uint32_t> positions(report->paths.size());
+        std::iota(positions.begin(), positions.end(), 0u);
+        int limit = static_cast<int>(std::min<size_t>(k, report->paths.size()));
+        iterator->ranked = TimingAnalyzer().rankPaths(report->paths, std::move(positions), limit);
+        *topk = iterator.release();
+        return TIMING_OK;
+    } catch (...) {
+        return TIMING_ERROR_INTERNAL;
+    }
+}
+
+int timing_topk_next(timing_topk* topk, timing_path_info* info) {
+    if (!topk || !info || topk->next >= topk->ranked.size()) {
+        return 0;
+    }
+    fillInfo(*topk->report, topk->ranked[topk->next++], *info);
+    return 1;
+}
+
+void timing_topk_free(timing_topk* topk) {
+    delete topk;
+}
+
+timing_status timing_path_find(const timing_report* report, const char* path_id, size_t* index) {
+    if (!report || !path_id || !index) {
+        return TIMING_ERROR_INVALID_ARGUMENT;
+    }
+    try {
+        auto it = report->byId.find(path_id);
+        if (it == report->byId.end()) {
+            return TIMING_ERROR_NOT_FOUND;
+        }
+        *index = it->second;
+        return TIMING_OK;
+    } catch (...) {
+        return TIMING_ERROR_INTERNAL;
+    }
+}
+
+timing_status timing_path_get_info(const timing_report* report, size_t index,
+                                   timing_path_info* info) {
+    if (!validPath(report, index) || !info) {
+        return TIMING_ERROR_INVALID_ARGUMENT;
+    }
+    fillInfo(*report, index, *info);
+    return TIMING_OK;
+}
+
+timing_status timing_path_get_string(const timing_report* report, size_t index,
+                                     timing_path_field field, char* buffer, size_t size,
+                                     size_t* length) {
+    if (!validPath(report, index)) {
+        return TIMING_ERROR_INVALID_ARGUMENT;
+    }
+    try {
+        const TimingPath& path = report->paths[index];
+        switch (field) {
+            case TIMING_FIELD_ID:
+                return copyString(path.id, buffer, size, length);
+            case TIMING_FIELD_STARTPOINT:
+                return copyString(path.startpoint, buffer, size, length);
+            case TIMING_FIELD_ENDPOINT:
+                return copyString(path.endpoint, buffer, size, length);
+            case TIMING_FIELD_WORST_STAGE: {
+                auto worst = path.getWorstStage().second;
+                return copyString(worst && worst->from ? worst->from->name : std::string(),
+                                  buffer, size, length);
+            }
+            case TIMING_FIELD_SUGGESTION:
+                return copyString(TimingAnalyzer().analyzePath(path).optimizationSuggestion,
+                                  buffer, size, length);
+        }
+        return TIMING_ERROR_INVALID_ARGUMENT;
+    } catch (...) {
+        return TIMING_ERROR_INTERNAL;
+    }
+}
+
+timing_status timing_path_get_stage(const timing_report* report, size_t index, size_t stage,
+                                    double* delay, char* from, size_t from_size, char* to,
+                                    size_t to_size) {
+    if (!validPath(report, index) || stage >= report->paths[index].edges.size()) {
+        return TIMING_ERROR_INVALID_ARGUMENT;
+    }
+    const TimingEdge& edge = *report->paths[index].edges[stage];
+    if (delay) {
+        *delay = edge.delay;
+    }
+    timing_status status = TIMING_OK;
+    if (from && copyString(edge.from->name, from, from_size, nullptr) != TIMING_OK) {
+        status = TIMING_ERROR_BUFFER_TOO_SMALL;
+    }
+    if (to && copyString(edge.to->name, to, to_size, nullptr) != TIMING_OK) {
+        status = TIMING_ERROR_BUFFER_TOO_SMALL;
+    }
+    return status;
+}
+
+} // extern "C"
@@ -0,0 +1,183 @@
+/**
+ * @file timing_c.h
+ * @brief C API of libtiming for analyzing reports in-process
+ *
+ * Reports and top-K iterators are opaque handles that must be released with
+ * their free function. Strings are copied into caller-provided buffers, so no
+ * memory allocated by the library is ever handed to the caller. Functions
+ * never throw or abort; they return a timing_status instead.
+ *
+ * Handles are not thread-safe: use one handle per thread, or lock around
+ * calls. Different handles may be used from different threads at once.
+ *
+ * The API is versioned by TIMING_C_API_VERSION. Existing functions, enum
+ * values and struct layouts keep their meaning within a version; additions
+ * bump it.
+ */
+
+#ifndef TIMING_C_H
+#define TIMING_C_H
+
+#include <stddef.h>
+
+#if defined(TIMING_BUILDING_LIBRARY) && defined(__GNUC__)
+#define TIMING_API __attribute__((visibility("default")))
+#else
+#define TIMING_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIMING_C_API_VERSION 1
+
+/** @brief A parsed report */
+typedef struct timing_report timing_report;
+
+/** @brief Iterator over the most critical paths of a report */
+typedef struct timing_topk timing_topk;
+
+/** @brief Result of every call that can fail */
+typedef enum timing_status {
+    TIMING_OK = 0,
+    TIMING_ERROR_INVALID_ARGUMENT = 1,  /* Null handle or pointer, index out of range */
+    TIMING_ERROR_IO = 2,                /* Report could not be read */
+    TIMING_ERROR_NOT_FOUND = 3,         /* No path with that ID */
+    TIMING_ERROR_BUFFER_TOO_SMALL = 4,  /* String truncated; see the length argument */
+    TIMING_ERROR_INTERNAL = 5           /* Any other failure, e.g. out of memory */
+} timing_status;
+
+/** @brief String attributes of a path */
+typedef enum timing_path_field {
+    TIMING_FIELD_ID = 0,
+    TIMING_FIELD_STARTPOINT = 1,
+    TIMING_FIELD_ENDPOINT = 2,
+    TIMING_FIELD_WORST_STAGE = 3,  /* Driving node of the slowest stage; empty without stages */
+    TIMING_FIELD_SUGGESTION = 4    /* Optimization suggestion, as the tool prints it */
+} timing_path_field;
+
+/** @brief Numeric attributes of a path */
+typedef struct timing_path_info {
+    size_t index;              /* Position in report order; the path's handle in this API */
+    double total_delay;        /* ns */
+    double worst_stage_delay;  /* ns */
+    size_t stage_count;
+} timing_path_info;
+
+/**
+ * @brief Get the API version the library was built with
+ * @return TIMING_C_API_VERSION of the library
+ */
+TIMING_API int timing_api_version(void);
+
+/**
+ * @brief Name a status code
+ * @param status Status
+ * @return Static, NUL-terminated description
+ */
+TIMING_API const char* timing_status_string(timing_status status);
+
+/**
+ * @brief Parse a report
+ * @param filename Report file path
+ * @param report Receives the report handle, or NULL on failure
+ * @param error Buffer for an error message; may be NULL
+ * @param error_size Size of error in bytes
+ * @return TIMING_OK, TIMING_ERROR_IO or TIMING_ERROR_INVALID_ARGUMENT
+ */
+TIMING_API timing_status timing_report_open(const char* filename, timing_report** report,
+                                            char* error, size_t error_size);
+
+/**
+ * @brief Release a report; NULL is ignored
+ * @param report Report handle
+ */
+TIMING_API void timing_report_free(timing_report* report);
+
+/**
+ * @brief Get the number of paths in a report
+ * @param report Report handle
+ * @return Path count, 0 for NULL
+ */
+TIMING_API size_t timing_report_path_count(const timing_report* report);
+
+/**
+ * @brief Start iterating the most critical paths, worst first
+ * @param report Report handle; must outlive the iterator
+ * @param k Most paths to return
+ * @param topk Receives the iterator handle
+ * @return TIMING_OK or an error
+ */
+TIMING_API timing_status timing_topk_begin(const timing_report* report, size_t k,
+                                           timing_topk** topk);
+
+/**
+ * @brief Get the next path of a top-K iteration
+ * @param topk Iterator handle
+ * @param info Receives the path
+ * @return 1 if info was filled, 0 at the end or on a NULL argument
+ */
+TIMING_API int timing_topk_next(timing_topk* topk, timing_path_info* info);
+
+/**
+ * @brief Release a top-K iterator; NULL is ignored
+ * @param topk Iterator handle
+ */
+TIMING_API void timing_topk_free(timing_topk* topk);
+
+/**
+ * @brief Find a path by its report ID
+ * @param report Report handle
+ * @param path_id Path ID such as "P12"
+ * @param index Receives the path index
+ * @return TIMING_OK, TIMING_ERROR_NOT_FOUND or TIMING_ERROR_INVALID_ARGUMENT
+ */
+TIMING_API timing_status timing_path_find(const timing_report* report, const char* path_id,
+                                          size_t* index);
+
+/**
+ * @brief Get the numeric attributes of a path
+ * @param report Report handle
+ * @param index Path index
+ * @param info Receives the attributes
+ * @return TIMING_OK or TIMING_ERROR_INVALID_ARGUMENT
+ */
+TIMING_API timing_status timing_path_get_info(const timing_report* report, size_t index,
+                                              timing_path_info* info);
+
+/**
+ * @brief Copy a string attribute of a path
+ * @param report Report handle
+ * @param index Path index
+ * @param field Attribute to copy
+ * @param buffer Receives the NUL-terminated string, truncated if it does not fit
+ * @param size Size of buffer in bytes
+ * @param length Receives the full string length without the NUL; may be NULL
+ * @return TIMING_OK, TIMING_ERROR_BUFFER_TOO_SMALL or TIMING_ERROR_INVALID_ARGUMENT
+ */
+TIMING_API timing_status timing_path_get_string(const timing_report* report, size_t index,
+                                                timing_path_field field, char* buffer,
+                                                size_t size, size_t* length);
+
+/**
+ * @brief Get one stage of a path
+ * @param report Report handle
+ * @param index Path index
+ * @param stage Stage index, from the startpoint
+ * @param delay Receives the stage delay in ns; may be NULL
+ * @param from Receives the driving node name; may be NULL
+ * @param from_size Size of from in bytes
+ * @param to Receives the driven node name; may be NULL
+ * @param to_size Size of to in bytes
+ * @return TIMING_OK, TIMING_ERROR_BUFFER_TOO_SMALL or TIMING_ERROR_INVALID_ARGUMENT
+ */
+TIMING_API timing_status timing_path_get_stage(const timing_report* report, size_t index,
+                                               size_t stage, double* delay, char* from,
+                                               size_t from_size, char* to, size_t to_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMING_C_H */
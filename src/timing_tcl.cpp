@@ -0,0 +1,324 @@
+/**
+ * @file timing_tcl.cpp
+ * @brief Loadable Tcl extension: "package require timing"
+ *
+ * Reports are parsed once into the same in-memory model the tool uses and
+ * kept in the interpreter under a handle, so any number of queries against
+ * one report cost no process start and no reparse:
+ *
+ *   set rpt [timing::load ?-min-delay NS? ?-min-slack NS? file]
+ *   timing::topk $rpt ?K?
+ *   timing::paths_through $rpt node ?K?
+ *   timing::path $rpt id
+ *   timing::summary $rpt
+ *   timing::free $rpt
+ *
+ * Paths come back as dicts (id, delay, startpoint, endpoint,
+ * worst_stage_delay, worst_stage, suggestion); timing::path adds a stages
+ * list of {from to delay} dicts.
+ */
+
+#include <tcl.h>
+#include "analyzer.h"
+#include "parser.h"
+#include "path_index.h"
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// One loaded report
+struct LoadedReport {
+    std::string file;
+    TimingParser parser;  // Owns the node table the paths' edges point into
+    std::vector<TimingPath> paths;
+    std::unique_ptr<PathIndex> index;  // Built by the first timing::paths_through
+};
+
+// Per-interpreter state, freed with the interpreter
+struct ExtensionState {
+    std::map<std::string, std::unique_ptr<LoadedReport>> reports;
+    unsigned nextHandle{0};
+};
+
+Tcl_Obj* newString(const std::string& text) {
+    return Tcl_NewStringObj(text.data(), static_cast<int>(text.size()));
+}
+
+void putString(Tcl_Obj* dict, const char* key, const std::string& value) {
+    Tcl_DictObjPut(nullptr, dict, Tcl_NewStringObj(key, -1), newString(value));
+}
+
+void putDouble(Tcl_Obj* dict, const char* key, double value) {
+    Tcl_DictObjPut(nullptr, dict, Tcl_NewStringObj(key, -1), Tcl_NewDoubleObj(value));
+}
+
+void putInt(Tcl_Obj* dict, const char* key, size_t value) {
+    Tcl_DictObjPut(nullptr, dict, Tcl_NewStringObj(key, -1),
+                   Tcl_NewWideIntObj(static_cast<Tcl_WideInt>(value)));
+}
+
+// The analysis of a path as a dict, as timing::topk returns it
+Tcl_Obj* analysisDict(const TimingPathAnalysis& analysis) {
+    Tcl_Obj* dict = Tcl_NewDictObj();
+    putString(dict, "id", analysis.path->id);
+    putDouble(dict, "delay", analysis.path->totalDelay);
+    putString(dict, "startpoint", analysis.path->startpoint);
+    putString(dict, "endpoint", analysis.path->endpoint);
+    putDouble(dict, "worst_stage_delay", analysis.worstStageDelay);
+    putString(dict, "worst_stage",
+              analysis.worstStage && analysis.worstStage->from ? analysis.worstStage->from->name
+                                                               : std::string());
+    putString(dict, "suggestion", analysis.optimizationSuggestion);
+    return dict;
+}
+
+Tcl_Obj* analysisList(const std::vector<TimingPathAnalysis>& analyses) {
+    Tcl_Obj* list = Tcl_NewListObj(0, nullptr);
+    for (const auto& analysis : analyses) {
+        Tcl_ListObjAppendElement(nullptr, list, analysisDict(analysis));
+    }
+    return list;
+}
+
+int fail(Tcl_Interp* interp, const std::string& message) {
+    Tcl_SetObjResult(interp, newString(message));
+    return TCL_ERROR;
+}
+
+// Resolve a handle argument
+LoadedReport* findReport(Tcl_Interp* interp, ExtensionState* state, Tcl_Obj* handle) {
+    auto it = state->reports.find(Tcl_GetString(handle));
+    if (it == state->reports.end()) {
+        fail(interp, std::string("unknown timing report \"") + Tcl_GetString(handle) + "\"");
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+// Read an optional K argument, 10 when absent
+bool topKArgument(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[], int position, int& topK) {
+    topK = 10;
+    if (objc > position && Tcl_GetIntFromObj(interp, objv[position], &topK) != TCL_OK) {
+        return false;
+    }
+    if (topK < 0) {
+        fail(interp, "K must not be negative");
+        return false;
+    }
+    return true;
+}
+
+// timing::load ?-min-delay NS? ?-min-slack NS? file
+int loadCommand(ClientData data, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    auto* state = static_cast<ExtensionState*>(data);
+    if (objc < 2 || objc % 2 != 0) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?-min-delay ns? ?-min-slack ns? file");
+        return TCL_ERROR;
+    }
+    try {
+        auto report = std::make_unique<LoadedReport>();
+        report->parser.setParseThreads(std::max(1u, std::thread::hardware_concurrency()));
+        for (int i = 1; i + 1 < objc; i += 2) {
+            std::string option = Tcl_GetString(objv[i]);
+            double value = 0.0;
+            if (option != "-min-delay" && option != "-min-slack") {
+                return fail(interp, "bad option \"" + option +
+                                    "\": must be -min-delay or -min-slack");
+            }
+            if (Tcl_GetDoubleFromObj(interp, objv[i + 1], &value) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (option == "-min-delay") {
+                report->parser.setMinDelay(value);
+            } else {
+                report->parser.setMinSlack(value);
+            }
+        }
+        report->file = Tcl_GetString(objv[objc - 1]);
+        report->paths = report->parser.parseFile(report->file);
+
+        std::string handle = "timing" + std::to_string(state->nextHandle++);
+        state->reports[handle] = std::move(report);
+        Tcl_SetObjResult(interp, newString(handle));
+        return TCL_OK;
+    } catch (const std::exception& e) {
+        return fail(interp, e.what());
+    }
+}
+
+// timing::topk report ?K?
+int topkCommand(ClientData data, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    auto* state = static_cast<ExtensionState*>(data);
+    if (objc < 2 || objc > 3) {
+        Tcl_WrongNumArgs(interp, 1, objv, "report ?k?");
+        return TCL_ERROR;
+    }
+    LoadedReport* report = findReport(interp, state, objv[1]);
+    int topK = 0;
+    if (!report || !topKArgument(interp, objc, objv, 2, topK)) {
+        return TCL_ERROR;
+    }
+    try {
+        TimingAnalyzer analyzer;
+        Tcl_SetObjResult(interp, analysisList(analyzer.findCriticalPaths(report->paths, topK)));
+        return TCL_OK;
+    } catch (const std::exception& e) {
+        return fail(interp, e.what());
+    }
+}
+
+// timing::paths_through report node ?K?
+int pathsThroughCommand(ClientData data, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    auto* state = static_cast<ExtensionState*>(data);
+    if (objc < 3 || objc > 4) {
+        Tcl_WrongNumArgs(interp, 1, objv, "report node ?k?");
+        return TCL_ERROR;
+    }
+    LoadedReport* report = findReport(interp, state, objv[1]);
+    int topK = 0;
+    if (!report || !topKArgument(interp, objc, objv, 3, topK)) {
+        return TCL_ERROR;
+    }
+    try {
+        if (!report->index) {
+            report->index = std::make_unique<PathIndex>(
+                PathIndex::build(report->paths, report->parser.nodeCount()));
+        }
+        // An unknown node has no paths, as with --through
+        uint32_t nodeId = report->parser.findNodeId(Tcl_GetString(objv[2]));
+        TimingAnalyzer analyzer;
+        Tcl_SetObjResult(interp, analysisList(analyzer.findPathsThrough(
+                                     report->paths, *report->index, nodeId, topK)));
+        return TCL_OK;
+    } catch (const std::exception& e) {
+        return fail(interp, e.what());
+    }
+}
+
+// timing::path report id
+int pathCommand(ClientData data, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    auto* state = static_cast<ExtensionState*>(data);
+    if (objc != 3) {
+        Tcl_WrongNumArgs(interp, 1, objv, "report id");
+        return TCL_ERROR;
+    }
+    LoadedReport* report = findReport(interp, state, objv[1]);
+    if (!report) {
+        return TCL_ERROR;
+    }
+    std::string id = Tcl_GetString(objv[2]);
+    auto it = std::find_if(report->paths.begin(), report->paths.end(),
+                           [&id](const TimingPath& path) { return path.id == id; });
+    if (it == report->paths.end()) {
+        return fail(interp, "no path \"" + id + "\" in " + report->file);
+    }
+    try {
+        TimingAnalyzer analyzer;
+        Tcl_Obj* dict = analysisDict(analyzer.analyzePath(*it));
+        Tcl_Obj* stages = Tcl_NewListObj(0, nullptr);
+        for (const auto& edge : it->edges) {
+            Tcl_Obj* stage = Tcl_NewDictObj();
+            putString(stage, "from", edge->from->name);
+            putString(stage, "to", edge->to->name);
+            putDouble(stage, "delay", edge->delay);
+            Tcl_ListObjAppendElement(nullptr, stages, stage);
+        }
+        Tcl_DictObjPut(nullptr, dict, Tcl_NewStringObj("stages", -1), stages);
+        Tcl_SetObjResult(interp, dict);
+        return TCL_OK;
+    } catch (const std::exception& e) {
+        return fail(interp, e.what());
+    }
+}
+
+// timing::summary report
+int summaryCommand(ClientData data, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    auto* state = static_cast<ExtensionState*>(data);
+    if (objc != 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "report");
+        return TCL_ERROR;
+    }
+    LoadedReport* report = findReport(interp, state, objv[1]);
+    if (!report) {
+        return TCL_ERROR;
+    }
+    double worst = 0.0;
+    double total = 0.0;
+    std::vector<bool> endpoints(report->parser.nodeCount());
+    size_t endpointCount = 0;
+    for (const auto& path : report->paths) {
+        worst = std::max(worst, path.totalDelay);
+        total += path.totalDelay;
+        if (path.endpointId < endpoints.size() && !endpoints[path.endpointId]) {
+            endpoints[path.endpointId] = true;
+            ++endpointCount;
+        }
+    }
+    Tcl_Obj* dict = Tcl_NewDictObj();
+    putString(dict, "file", report->file);
+    putInt(dict, "paths", report->paths.size());
+    putInt(dict, "nodes", report->parser.nodeCount());
+    putInt(dict, "endpoints", endpointCount);
+    putInt(dict, "rejected", report->parser.rejectedPaths());
+    putDouble(dict, "worst_delay", worst);
+    putDouble(dict, "mean_delay", report->paths.empty() ? 0.0 : total / report->paths.size());
+    Tcl_SetObjResult(interp, dict);
+    return TCL_OK;
+}
+
+// timing::free report
+int freeCommand(ClientData data, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    auto* state = static_cast<ExtensionState*>(data);
+    if (objc != 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "report");
+        return TCL_ERROR;
+    }
+    if (!findReport(interp, state, objv[1])) {
+        return TCL_ERROR;
+    }
+    state->reports.erase(Tcl_GetString(objv[1]));
+    return TCL_OK;
+}
+
+void deleteState(ClientData data, Tcl_Interp*) {
+    delete static_cast<ExtensionState*>(data);
+}
+
+} // namespace
+
+/**
+ * @brief Entry point called by "load" / "package require timing"
+ * @param interp Interpreter to add the timing:: commands to
+ * @return TCL_OK, or TCL_ERROR if the interpreter is older than Tcl 8.6
+ */
+extern "C" DLLEXPORT int Timing_Init(Tcl_Interp* interp) {
+    if (!Tcl_InitStubs(interp, "8.6", 0)) {
+        return TCL_ERROR;
+    }
+    auto* state = new ExtensionState();
+    Tcl_CallWhenDeleted(interp, deleteState, state);
+
+    struct Command {
+        const char* name;
+        Tcl_ObjCmdProc* proc;
+    };
+    const Command commands[] = {
+        {"::timing::load", loadCommand},
+        {"::timing::topk", topkCommand},
+        {"::timing::paths_through", pathsThroughCommand},
+        {"::timing::path", pathCommand},
+        {"::timing::summary", summaryCommand},
+        {"::timing::free", freeCommand},
+    };
+    Tcl_CreateNamespace(interp, "::timing", nullptr, nullptr);
+    for (const auto& command : commands) {
+        Tcl_CreateObjCommand(interp, command.name, command.proc, state, nullptr);
+    }
+    return Tcl_PkgProvide(interp, "timing", TIMING_TOOL_VERSION);
+}
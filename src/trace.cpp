@@ -0,0 +1,214 @@
+/**
+ * @file trace.cpp
+ * @brief Implementation of the per-thread span rings and the JSON writer
+ */
+
+#include "trace.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace Trace {
+
+namespace {
+
+constexpr size_t kRingSize = 1 << 16;  // Spans kept per thread
+
+struct Event {
+    const char* name;
+    const char* category;
+    uint64_t beginNs;
+    uint64_t endNs;
+    uint64_t range[2];
+    std::string detail;     // Reused with the slot, so details wrap with the ring
+    bool hasDetail;
+    bool hasRange;
+};
+
+// Written only by its thread; read by toJson() once that thread is idle
+struct ThreadBuffer {
+    explicit ThreadBuffer(uint32_t tid) : tid(tid), events(kRingSize) {}
+
+    uint32_t tid;
+    std::vector<Event> events;
+    std::atomic<uint64_t> head{0};      // Spans ever recorded
+};
+
+// Buffers outlive their threads so pool workers can exit before the write
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+std::atomic<uint64_t> epochNs{0};
+const ThreadBuffer* startingBuffer = nullptr;  // Named "main"; guarded by registryMutex
+
+thread_local ThreadBuffer* localBuffer = nullptr;
+
+ThreadBuffer& threadBuffer() {
+    if (!localBuffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(registry.size() + 1)));
+        localBuffer = registry.back().get();
+    }
+    return *localBuffer;
+}
+
+void appendEscaped(std::string& out, const char* text) {
+    for (const char* p = text; *p; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+}
+
+// Trace Event timestamps are microseconds
+void appendMicros(std::string& out, uint64_t ns) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", static_cast<double>(ns) / 1000.0);
+    out += text;
+}
+
+} // namespace
+
+namespace detail {
+
+std::atomic<bool> enabled{false};
+
+uint64_t now() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(
+        duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+void record(const char* name, const char* category, uint64_t beginNs, uint64_t endNs,
+            const std::string* detail, const uint64_t* range) {
+    ThreadBuffer& buffer = threadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+
+    Event& event = buffer.events[head % kRingSize];
+    event.name = name;
+    event.category = category;
+    event.beginNs = beginNs;
+    event.endNs = endNs;
+    event.hasDetail = detail != nullptr;
+    if (detail) {
+        event.detail.assign(*detail);
+    }
+    event.hasRange = range != nullptr;
+    if (range) {
+        event.range[0] = range[0];
+        event.range[1] = range[1];
+    }
+
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+void start() {
+    // Register the starting thread now; registering on the first finished span
+    // would number threads by who finishes first, not name the one that traces
+    ThreadBuffer& starting = threadBuffer();
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto& buffer : registry) {
+            buffer->head.store(0, std::memory_order_relaxed);
+        }
+        startingBuffer = &starting;
+    }
+    epochNs = detail::now();
+    detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop() {
+    detail::enabled.store(false, std::memory_order_relaxed);
+}
+
+std::string toJson() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t epoch = epochNs.load();
+    uint64_t dropped = 0;
+
+    std::string out = "{\"traceEvents\":[\n";
+    bool first = true;
+    auto separate = [&] {
+        out += first ? "" : ",\n";
+        first = false;
+    };
+
+    separate();
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+           "\"args\":{\"name\":\"timing_analysis\"}}";
+
+    for (const auto& buffer : registry) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        if (head == 0) {
+            continue;
+        }
+        std::string tid = std::to_string(buffer->tid);
+
+        separate();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid +
+               ",\"args\":{\"name\":\"" + (buffer.get() == startingBuffer ? "main" : "thread " + tid) + "\"}}";
+
+        uint64_t oldest = head > kRingSize ? head - kRingSize : 0;
+        dropped += oldest;
+        for (uint64_t i = oldest; i < head; ++i) {
+            const Event& event = buffer->events[i % kRingSize];
+            separate();
+            out += "{\"name\":\"";
+            appendEscaped(out, event.name);
+            out += "\",\"cat\":\"";
+            appendEscaped(out, event.category);
+            out += "\",\"ph\":\"X\",\"ts\":";
+            appendMicros(out, event.beginNs > epoch ? event.beginNs - epoch : 0);
+            out += ",\"dur\":";
+            appendMicros(out, event.endNs - event.beginNs);
+            out += ",\"pid\":1,\"tid\":" + tid;
+
+            if (event.hasDetail || event.hasRange) {
+                out += ",\"args\":{";
+                if (event.hasDetail) {
+                    out += "\"detail\":\"";
+                    appendEscaped(out, event.detail.c_str());
+                    out += "\"";
+                }
+                if (event.hasRange) {
+                    out += event.hasDetail ? "," : "";
+                    out += "\"first\":" + std::to_string(event.range[0]) +
+                           ",\"last\":" + std::to_string(event.range[1]);
+                }
+                out += "}";
+            }
+            out += "}";
+        }
+    }
+
+    out += "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedSpans\":" +
+           std::to_string(dropped) + "}}\n";
+    return out;
+}
+
+void writeFile(const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file) {
+        throw std::runtime_error("Failed to open trace file: " + filename);
+    }
+    file << toJson();
+    if (!file) {
+        throw std::runtime_error("Failed to write trace file: " + filename);
+    }
+}
+
+} // namespace Trace
@@ -0,0 +1,132 @@
+/**
+ * @file trace.h
+ * @brief Span recording behind the --trace option
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @namespace Trace
+ * @brief Begin/end spans per file, phase, chunk and thread-pool task
+ *
+ * Each thread records into its own fixed-size ring buffer, so recording takes
+ * no locks; when a ring is full the oldest spans are overwritten and counted
+ * as dropped. The collected spans are written in the Chrome Trace Event
+ * format, which chrome://tracing and Perfetto open directly. While tracing is
+ * off a Span costs one load and one predictable branch in its constructor and
+ * destructor.
+ */
+namespace Trace {
+
+namespace detail {
+
+extern std::atomic<bool> enabled;
+
+uint64_t now();
+
+/**
+ * @brief Append a finished span to the calling thread's ring
+ */
+void record(const char* name, const char* category, uint64_t beginNs, uint64_t endNs,
+            const std::string* detail, const uint64_t* range);
+
+} // namespace detail
+
+/**
+ * @brief Check whether tracing is on
+ * @return True if spans record
+ */
+inline bool enabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Clear previously recorded spans and start tracing
+ *
+ * Call before starting the work to trace; threads that are recording while
+ * tracing restarts may keep spans from the previous run. The calling thread
+ * is the one labelled main in the output.
+ */
+void start();
+
+/**
+ * @brief Stop recording spans; recorded spans are kept
+ */
+void stop();
+
+/**
+ * @brief Format the recorded spans as a Chrome Trace Event JSON document
+ * @return JSON text
+ *
+ * Call once the traced threads are idle or joined.
+ */
+std::string toJson();
+
+/**
+ * @brief Write toJson() to a file
+ * @param filename Output path
+ * @throws std::runtime_error if the file cannot be written
+ */
+void writeFile(const std::string& filename);
+
+/**
+ * @class Span
+ * @brief Records its own lifetime as a complete event
+ *
+ * name and category must be string literals or otherwise outlive the trace.
+ */
+class Span {
+public:
+    Span(const char* name, const char* category)
+        : name(name), category(category), active(enabled()) {
+        if (active) {
+            beginNs = detail::now();
+        }
+    }
+
+    ~Span() {
+        if (active) {
+            detail::record(name, category, beginNs, detail::now(),
+                           text.empty() ? nullptr : &text, hasRange ? range : nullptr);
+        }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    /**
+     * @brief Attach a description such as a file name; ignored while tracing is off
+     * @param detail Text shown in the span's arguments
+     */
+    void setDetail(const std::string& detail) {
+        if (active) {
+            text = detail;
+        }
+    }
+
+    /**
+     * @brief Attach the item range a chunk covers
+     * @param first First item
+     * @param last One past the last item
+     */
+    void setRange(uint64_t first, uint64_t last) {
+        range[0] = first;
+        range[1] = last;
+        hasRange = true;
+    }
+
+private:
+    const char* name;
+    const char* category;
+    bool active;
+    bool hasRange{false};
+    uint64_t beginNs{0};
+    uint64_t range[2]{0, 0};
+    std::string text;
+};
+
+} // namespace Trace
@@ -4,26 +4,65 @@
  */
 
 #include "utils.h"
+#include "mem_stats.h"
+#include "profiler.h"
+#include "trace.h"
 #include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <chrono>
+#include <algorithm>
+
+// Filesystem include based on compiler support
+#if defined(HAVE_STD_FILESYSTEM)
+  #include <filesystem>
+  namespace fs = std::filesystem;
+#elif defined(HAVE_STD_EXPERIMENTAL_FILESYSTEM)
+  #include <experimental/filesystem>
+  namespace fs = std::experimental::filesystem;
+#else
+  #error "No filesystem support available"
+#endif
 
 namespace Utils {
 
-void printResults(const std::vector<TimingPathAnalysis>& criticalPaths, 
-                  const std::string& outputFile) {
-    
-    std::stringstream output;
-    
+namespace {
+
+// Append one ranking under its "Top N Critical Paths" header, or its
+// "Critical Paths Ranked A-B" header when it does not start at rank 1
+void formatSection(std::stringstream& output, const std::vector<TimingPathAnalysis>& criticalPaths,
+                   const std::string& rankedBy, const std::string& grouping = "",
+                   size_t firstRank = 1) {
     // Format header
-    output << "Top " << criticalPaths.size() << " Critical Paths:\n";
+    if (firstRank == 1) {
+        output << "Top " << criticalPaths.size() << " Critical Paths";
+    } else if (criticalPaths.empty()) {
+        output << "No Critical Paths Ranked " << firstRank << " or Lower";
+    } else {
+        output << "Critical Paths Ranked " << firstRank << "-"
+               << firstRank + criticalPaths.size() - 1;
+    }
+    if (!rankedBy.empty()) {
+        output << " by " << rankedBy;
+    }
+    if (!grouping.empty()) {
+        output << ", " << grouping;
+    }
+    output << ":\n";
     
     // Format each critical path
     for (size_t i = 0; i < criticalPaths.size(); ++i) {
-        output << formatPathResult(i + 1, criticalPaths[i]) << "\n";
+        output << formatPathResult(static_cast<int>(firstRank + i), criticalPaths[i]) << "\n";
     }
+}
+
+void writeOutput(std::stringstream& output, size_t paths, const std::string& outputFile,
+                 Profiler::ScopedTimer& timer) {
+    timer.addItems(paths);
+    timer.addBytes(static_cast<uint64_t>(output.tellp()));
+    MemoryStats::Charge outputBuffer(MemoryStats::Category::Output);
+    outputBuffer.add(static_cast<uint64_t>(output.tellp()), paths);
     
     // Print to console
     std::cout << output.str();
@@ -40,6 +79,34 @@ void printResults(const std::vector<TimingPathAnalysis>& criticalPaths,
     }
 }
 
+} // namespace
+
+void printResults(const std::vector<TimingPathAnalysis>& criticalPaths, 
+                  const std::string& outputFile, const std::string& rankedBy) {
+    
+    Profiler::ScopedTimer timer(Profiler::Phase::Output);
+    Trace::Span span("output", "phase");
+    std::stringstream output;
+    formatSection(output, criticalPaths, rankedBy);
+    writeOutput(output, criticalPaths.size(), outputFile, timer);
+}
+
+void printResults(const std::vector<ResultSection>& sections, const std::string& outputFile) {
+    Profiler::ScopedTimer timer(Profiler::Phase::Output);
+    Trace::Span span("output", "phase");
+    std::stringstream output;
+    size_t paths = 0;
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (i > 0) {
+            output << "\n";
+        }
+        formatSection(output, sections[i].criticalPaths, sections[i].rankedBy,
+                      sections[i].grouping, sections[i].firstRank);
+        paths += sections[i].criticalPaths.size();
+    }
+    writeOutput(output, paths, outputFile, timer);
+}
+
 std::string formatPathResult(int index, const TimingPathAnalysis& analysis) {
     std::stringstream result;
     
@@ -84,4 +151,22 @@ std::string formatTime(double seconds) {
     return result.str();
 }
 
+std::vector<std::string> collectReportFiles(const std::string& path) {
+    std::vector<std::string> files;
+    
+    if (!fs::is_directory(path)) {
+        files.push_back(path);
+        return files;
+    }
+    
+    for (const auto& entry : fs::directory_iterator(path)) {
+        if (fs::is_regular_file(entry.path()) && entry.path().extension() == ".rpt") {
+            files.push_back(entry.path().string());
+        }
+    }
+    
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
 } // namespace Utils 
\ No newline at end of file
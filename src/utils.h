@@ -19,9 +19,29 @@ namespace Utils {
  * @brief Print the analysis results to console or file
  * @param criticalPaths Vector of critical path analyses
  * @param outputFile Optional file path to write results to
+ * @param rankedBy Ranking key named in the header; empty for total delay
  */
 void printResults(const std::vector<TimingPathAnalysis>& criticalPaths, 
-                  const std::string& outputFile = "");
+                  const std::string& outputFile = "",
+                  const std::string& rankedBy = "");
+
+/**
+ * @struct ResultSection
+ * @brief Critical paths ranked by one key, printed under their own header
+ */
+struct ResultSection {
+    std::string rankedBy;  // Key named in the header; empty for total delay
+    std::vector<TimingPathAnalysis> criticalPaths;
+    std::string grouping;  // e.g. "at most 2 per endpoint"; empty when ungrouped
+    size_t firstRank{1};   // Rank of the first path; above 1 for --rank-range
+};
+
+/**
+ * @brief Print several rankings to console or file, one section each
+ * @param sections Sections in print order
+ * @param outputFile Optional file path to write all sections to
+ */
+void printResults(const std::vector<ResultSection>& sections, const std::string& outputFile = "");
 
 /**
  * @brief Format a timing path analysis result as a string
@@ -38,4 +58,11 @@ std::string formatPathResult(int index, const TimingPathAnalysis& analysis);
  */
 std::string formatTime(double seconds);
 
+/**
+ * @brief Collect the timing reports named by a path
+ * @param path A report file, or a directory searched for *.rpt files
+ * @return Report file paths, sorted for a stable processing order
+ */
+std::vector<std::string> collectReportFiles(const std::string& path);
+
 } // namespace Utils 
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "analyzer.h"
+#include <limits>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 // Helper function to create a test TimingPath
@@ -111,6 +113,83 @@ TEST_F(AnalyzerTest, SuggestsFanoutOptimization) {
                 analysis.optimizationSuggestion.find("balance") != std::string::npos);
 }
 
+// Test that each ranking key orders the paths by its own column
+TEST_F(AnalyzerTest, RanksByKey) {
+    auto columns = PathColumns::build(testPaths);
+    std::vector<uint32_t> all = {0, 1, 2};
+    
+    EXPECT_EQ(analyzer.rankPaths(columns, all, 3, RankKey::Delay),
+              (std::vector<uint32_t>{2, 0, 1}));
+    // P2's 2.5 ns stage beats the two 2.0 ns stages, which keep report order
+    EXPECT_EQ(analyzer.rankPaths(columns, all, 3, RankKey::WorstStage),
+              (std::vector<uint32_t>{1, 0, 2}));
+    EXPECT_EQ(analyzer.rankPaths(columns, all, 3, RankKey::Stages),
+              (std::vector<uint32_t>{0, 1, 2}));
+    // Net shares: P1 1.7/5, P2 2.5/4, P3 3/6
+    EXPECT_EQ(analyzer.rankPaths(columns, all, 2, RankKey::NetDelayShare),
+              (std::vector<uint32_t>{1, 2}));
+    EXPECT_EQ(analyzer.rankPaths(columns, {0, 2}, 5, RankKey::NetDelayShare),
+              (std::vector<uint32_t>{2, 0}));
+}
+
+// Test that slack uses each path's clock period and ranks unknown slack last
+TEST_F(AnalyzerTest, RanksBySlack) {
+    double unknown = std::numeric_limits<double>::quiet_NaN();
+    auto columns = PathColumns::build(testPaths, {10.0, unknown, 6.0});
+    EXPECT_DOUBLE_EQ(columns.slack[0], 5.0);
+    EXPECT_EQ(analyzer.rankPaths(columns, {0, 1, 2}, 3, RankKey::Slack),
+              (std::vector<uint32_t>{2, 0, 1}));
+    
+    // The ranked rows analyze in ranked order
+    auto analyses = analyzer.analyzePaths(testPaths, {2, 0});
+    ASSERT_EQ(analyses.size(), 2u);
+    EXPECT_EQ(analyses[0].path->id, "P3");
+    EXPECT_EQ(analyses[1].path->id, "P1");
+}
+
+// Test that one pass with several keys matches ranking by each key alone
+TEST_F(AnalyzerTest, RanksBySeveralKeysInOnePass) {
+    auto columns = PathColumns::build(testPaths, {10.0, 9.0, 8.0});
+    std::vector<uint32_t> all = {0, 1, 2};
+    std::vector<RankKey> keys = {RankKey::Delay, RankKey::Slack, RankKey::WorstStage,
+                                 RankKey::Stages, RankKey::NetDelayShare};
+    
+    // A K far beyond the rows must not size the heaps by K
+    for (int topK : {0, 2, 3, 10, 2000000000}) {
+        auto ranked = analyzer.rankPaths(columns, all, topK, keys);
+        ASSERT_EQ(ranked.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            EXPECT_EQ(ranked[i], analyzer.rankPaths(columns, all, topK, keys[i]))
+                << RankKeys::name(keys[i]) << " with K=" << topK;
+        }
+    }
+}
+
+// Test that the bounded heap keeps the K most critical rows, ties to earlier rows
+TEST(RankKeyTest, KeepsTopKInHeap) {
+    TopKHeap heap(3);
+    double scores[] = {1.0, 4.0, 2.0, 4.0, 0.5, 3.0, 4.0};
+    for (uint32_t row = 0; row < 7; ++row) {
+        heap.offer(scores[row], row);
+    }
+    EXPECT_EQ(heap.take(), (std::vector<uint32_t>{1, 3, 6}));
+    EXPECT_TRUE(heap.take().empty());
+}
+
+// Test that key names round-trip and unknown names are rejected
+TEST(RankKeyTest, ParsesNames) {
+    for (RankKey key : {RankKey::Delay, RankKey::Slack, RankKey::WorstStage, RankKey::Stages,
+                        RankKey::NetDelayShare}) {
+        EXPECT_EQ(RankKeys::parse(RankKeys::name(key)), key);
+    }
+    EXPECT_THROW(RankKeys::parse("fanout"), std::runtime_error);
+    
+    // Lists keep their order and drop repeats
+    EXPECT_EQ(RankKeys::parseList("stages,delay,stages"),
+              (std::vector<RankKey>{RankKey::Stages, RankKey::Delay}));
+    EXPECT_THROW(RankKeys::parseList("delay,"), std::runtime_error);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "batch_reader.h"
+#include "parser.h"
+#include "report_generator.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class BatchReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Empty, smaller than a chunk, and many chunks with a partial last one
+        std::vector<size_t> sizes = {0, 100, 4096, 50000, 7, 123457};
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            std::string text(sizes[i], '\0');
+            for (size_t b = 0; b < text.size(); ++b) {
+                text[b] = static_cast<char>('a' + (b * 7 + i) % 26);
+            }
+            std::string path = "temp_batch_" + std::to_string(i) + ".rpt";
+            std::ofstream(path, std::ios::binary) << text;
+            files.push_back(path);
+            contents.push_back(text);
+        }
+    }
+
+    void TearDown() override {
+        for (const auto& path : files) {
+            std::remove(path.c_str());
+        }
+    }
+
+    std::vector<BatchReader::Backend> backends() const {
+        std::vector<BatchReader::Backend> result = {BatchReader::Backend::Pread};
+        if (BatchReader::ioUringAvailable()) {
+            result.push_back(BatchReader::Backend::IoUring);
+        }
+        return result;
+    }
+
+    std::vector<std::string> files;
+    std::vector<std::string> contents;
+};
+
+// Test that every backend returns each file whole and in list order
+TEST_F(BatchReaderTest, DeliversFilesInOrder) {
+    for (auto backend : backends()) {
+        BatchReader::Options options;
+        options.backend = backend;
+        options.queueDepth = 3;
+        options.chunkBytes = 4096;
+        options.maxBufferedBytes = 60000;  // Forces read-ahead to pause
+        BatchReader reader(files, options);
+        EXPECT_EQ(reader.backend(), backend);
+
+        BatchReader::File file;
+        size_t total = 0;
+        for (size_t i = 0; i < files.size(); ++i) {
+            ASSERT_TRUE(reader.next(file)) << BatchReader::backendName(backend);
+            EXPECT_EQ(file.path, files[i]);
+            ASSERT_EQ(std::string(file.data.get(), file.size), contents[i])
+                << BatchReader::backendName(backend) << " file " << i;
+            total += file.size;
+        }
+        EXPECT_FALSE(reader.next(file));
+        EXPECT_EQ(reader.bytesRead(), total);
+    }
+}
+
+// Test that a missing file fails at its turn without stopping the others
+TEST_F(BatchReaderTest, ReportsMissingFileInOrder) {
+    for (auto backend : backends()) {
+        BatchReader::Options options;
+        options.backend = backend;
+        BatchReader reader({files[1], "does_not_exist.rpt", files[3]}, options);
+
+        BatchReader::File file;
+        ASSERT_TRUE(reader.next(file));
+        EXPECT_EQ(file.path, files[1]);
+        EXPECT_THROW(reader.next(file), std::runtime_error);
+        ASSERT_TRUE(reader.next(file));
+        EXPECT_EQ(std::string(file.data.get(), file.size), contents[3]);
+        EXPECT_FALSE(reader.next(file));
+    }
+}
+
+// Test that parsing a report from memory matches parsing it from disk
+TEST_F(BatchReaderTest, ParsedBufferMatchesParsedFile) {
+    GeneratorOptions generator;
+    generator.pathCount = 300;
+    generator.seed = 3;
+    ReportGenerator(generator).writeFile(files[0]);
+
+    BatchReader reader({files[0]});
+    BatchReader::File file;
+    ASSERT_TRUE(reader.next(file));
+
+    TimingParser fromDisk;
+    TimingParser fromMemory;
+    auto expected = fromDisk.parseFile(files[0]);
+    auto actual = fromMemory.parseBuffer(file.path, file.data.get(), file.size);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].id, expected[i].id);
+        EXPECT_EQ(actual[i].edges.size(), expected[i].edges.size());
+    }
+
+    // Scanned extents point into the file, so its stages load from disk
+    std::vector<PathExtent> extents;
+    auto scanned = fromMemory.scanBuffer(file.path, file.data.get(), file.size, extents);
+    ASSERT_EQ(scanned.size(), expected.size());
+    fromMemory.loadStages(scanned, extents, {0, static_cast<uint32_t>(scanned.size() - 1)});
+    EXPECT_EQ(scanned.back().edges.size(), expected.back().edges.size());
+}
+
+// Test the --io-backend spellings
+TEST(BatchReaderBackendTest, ParsesBackendNames) {
+    for (auto backend : {BatchReader::Backend::Auto, BatchReader::Backend::IoUring,
+                         BatchReader::Backend::Pread}) {
+        EXPECT_EQ(BatchReader::parseBackend(BatchReader::backendName(backend)), backend);
+    }
+    EXPECT_THROW(BatchReader::parseBackend("aio"), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
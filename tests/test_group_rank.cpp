@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "group_rank.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Helper to build columns with only the attributes grouping reads
+PathColumns createColumns(const std::vector<double>& delays, const std::vector<uint32_t>& ends,
+                          const std::vector<uint32_t>& starts) {
+    PathColumns columns;
+    columns.delay = delays;
+    columns.endId = ends;
+    columns.startId = starts;
+    columns.worstStageDelay.assign(delays.size(), 0.0);
+    columns.stageCount.assign(delays.size(), 0);
+    columns.netDelayShare.assign(delays.size(), 0.0);
+    columns.slack.assign(delays.size(), 0.0);
+    return columns;
+}
+
+// Reference: walk every row most critical first, skipping full groups
+std::vector<uint32_t> bruteForce(const PathColumns& columns, const PathGrouping& grouping,
+                                 size_t topK, size_t perGroup) {
+    std::vector<ScoredRow> rows;
+    for (uint32_t row = 0; row < columns.size(); ++row) {
+        rows.push_back({columns.delay[row], row});
+    }
+    std::sort(rows.begin(), rows.end(), moreCritical);
+    std::map<uint32_t, size_t> taken;
+    std::vector<uint32_t> selected;
+    for (const auto& row : rows) {
+        if (selected.size() == topK) {
+            break;
+        }
+        if (taken[grouping.groupOf(columns, row.row)]++ < perGroup) {
+            selected.push_back(row.row);
+        }
+    }
+    return selected;
+}
+
+// Test that no group contributes more than its limit and ties keep row order
+TEST(GroupRankTest, LimitsPathsPerGroup) {
+    auto columns = createColumns({5.0, 4.0, 6.0, 3.0, 6.0, 1.0},
+                                 {0, 0, 0, 1, 1, 2},
+                                 {7, 8, 7, 7, 8, 8});
+    std::vector<uint32_t> all(columns.size());
+    std::iota(all.begin(), all.end(), 0u);
+    ThreadPool pool(1);
+
+    auto byEndpoint = PathGrouping::parse("endpoint");
+    EXPECT_EQ(byEndpoint.selectTop(columns, all, 10, RankKey::Delay, 1, pool),
+              (std::vector<uint32_t>{2, 4, 5}));
+    EXPECT_EQ(byEndpoint.lastGroupCount(), 3u);
+    EXPECT_EQ(byEndpoint.selectTop(columns, all, 4, RankKey::Delay, 2, pool),
+              (std::vector<uint32_t>{2, 4, 0, 3}));
+
+    // A limit far beyond the rows allocates for the rows, not the limit
+    EXPECT_EQ(byEndpoint.selectTop(columns, all, 10, RankKey::Delay, 2000000000, pool),
+              (std::vector<uint32_t>{2, 4, 0, 1, 3, 5}));
+
+    auto byStartpoint = PathGrouping::parse("startpoint");
+    EXPECT_EQ(byStartpoint.selectTop(columns, {0, 1, 3, 5}, 10, RankKey::Delay, 1, pool),
+              (std::vector<uint32_t>{0, 1}));
+}
+
+// Test that prefix groups share the first N levels of the endpoint name
+TEST(GroupRankTest, GroupsByHierarchyPrefix) {
+    std::string report =
+        "Path P1     u_core/u_alu/r1/D   PI   3.000\n"
+        "P1.1   u_core/u_alu/r1/D   PI   3.000\n"
+        "\n"
+        "Path P2     u_core/u_alu/r2/D   PI   2.000\n"
+        "P2.1   u_core/u_alu/r2/D   PI   2.000\n"
+        "\n"
+        "Path P3     u_core/u_lsu/r3/D   PI   1.000\n"
+        "P3.1   u_core/u_lsu/r3/D   PI   1.000\n"
+        "\n"
+        "Path P4     top_out             PI   0.500\n"
+        "P4.1   top_out             PI   0.500\n";
+    TimingParser parser;
+    auto paths = parser.parseBuffer("prefix.rpt", report.data(), report.size());
+    ASSERT_EQ(paths.size(), 4u);
+    auto columns = PathColumns::build(paths);
+    std::vector<uint32_t> all = {0, 1, 2, 3};
+    ThreadPool pool(1);
+
+    auto byBlock = PathGrouping::parse("prefix:2");
+    EXPECT_EQ(byBlock.describe(), "prefix:2");
+    byBlock.resolve(parser);
+    EXPECT_EQ(byBlock.selectTop(columns, all, 10, RankKey::Delay, 1, pool),
+              (std::vector<uint32_t>{0, 2, 3}));
+
+    auto byTop = PathGrouping::parse("prefix:1");
+    byTop.resolve(parser);
+    EXPECT_EQ(byTop.selectTop(columns, all, 10, RankKey::Delay, 2, pool),
+              (std::vector<uint32_t>{0, 1, 3}));
+}
+
+// Test that thread-local grouping merges to the serial result
+TEST(GroupRankTest, MergesWorkerTablesExactly) {
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> delayTenths(0, 500);
+    std::uniform_int_distribution<uint32_t> endpoint(0, 4999);
+    std::vector<double> delays;
+    std::vector<uint32_t> ends;
+    for (int i = 0; i < 300000; ++i) {
+        delays.push_back(delayTenths(random) / 10.0);  // Many ties
+        ends.push_back(endpoint(random));
+    }
+    auto columns = createColumns(delays, ends, std::vector<uint32_t>(delays.size(), 0));
+    std::vector<uint32_t> all(columns.size());
+    std::iota(all.begin(), all.end(), 0u);
+
+    auto grouping = PathGrouping::parse("endpoint");
+    ThreadPool serial(1);
+    ThreadPool parallel(4);
+    auto expected = bruteForce(columns, grouping, 200, 3);
+    EXPECT_EQ(grouping.selectTop(columns, all, 200, RankKey::Delay, 3, serial), expected);
+    EXPECT_EQ(grouping.selectTop(columns, all, 200, RankKey::Delay, 3, parallel), expected);
+    EXPECT_EQ(grouping.lastGroupCount(), 5000u);
+}
+
+// Test that malformed groupings are rejected
+TEST(GroupRankTest, RejectsUnknownGroupings) {
+    EXPECT_EQ(PathGrouping::parse("startpoint").describe(), "startpoint");
+    EXPECT_THROW(PathGrouping::parse("net"), std::runtime_error);
+    EXPECT_THROW(PathGrouping::parse("prefix:"), std::runtime_error);
+    EXPECT_THROW(PathGrouping::parse("prefix:0"), std::runtime_error);
+    EXPECT_THROW(PathGrouping::parse("prefix:-1"), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
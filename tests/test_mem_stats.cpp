@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "analyzer.h"
+#include "mem_stats.h"
+#include "parser.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using MemoryStats::Category;
+
+// Helper function to create a temporary test file
+std::string createTempTimingReport() {
+    const std::string tempFilePath = "temp_mem_stats_timing.rpt";
+    std::ofstream tempFile(tempFilePath);
+
+    tempFile << "Path P1     FF_Q        PI          2.345\n";
+    tempFile << "P1.1   NET1        PI          0.123\n";
+    tempFile << "P1.2   INV1        NET1        0.456\n";
+    tempFile << "Path P2     FF2_Q       PI          1.500\n";
+    tempFile << "P2.1   NET1        PI          0.200\n";
+
+    tempFile.close();
+    return tempFilePath;
+}
+
+class MemStatsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempFilePath = createTempTimingReport();
+    }
+
+    void TearDown() override {
+        std::remove(tempFilePath.c_str());
+    }
+
+    std::string tempFilePath;
+};
+
+// Test that structures charge their categories and give the memory back
+TEST_F(MemStatsTest, TracksLiveStructures) {
+    auto pathsBefore = MemoryStats::usage(Category::Paths);
+    auto edgesBefore = MemoryStats::usage(Category::Edges);
+    auto nodesBefore = MemoryStats::usage(Category::NodeTable);
+
+    {
+        TimingParser parser;
+        auto paths = parser.parseFile(tempFilePath);
+        ASSERT_EQ(paths.size(), 2);
+
+        EXPECT_EQ(MemoryStats::usage(Category::Paths).objects - pathsBefore.objects, 2);
+        EXPECT_EQ(MemoryStats::usage(Category::Edges).objects - edgesBefore.objects, 3);
+        EXPECT_EQ(MemoryStats::usage(Category::NodeTable).objects - nodesBefore.objects, 3);
+        EXPECT_GT(MemoryStats::usage(Category::NodeTable).bytes, nodesBefore.bytes);
+
+        // Lines are only held while the file is parsed
+        EXPECT_EQ(MemoryStats::usage(Category::Lines).bytes, 0);
+        EXPECT_GT(MemoryStats::usage(Category::Lines).peakBytes, 0);
+
+        TimingAnalyzer analyzer;
+        auto critical = analyzer.findCriticalPaths(paths, 1);
+        EXPECT_EQ(MemoryStats::usage(Category::Analyses).objects, 1);
+    }
+
+    EXPECT_EQ(MemoryStats::usage(Category::Paths).objects, pathsBefore.objects);
+    EXPECT_EQ(MemoryStats::usage(Category::Paths).bytes, pathsBefore.bytes);
+    EXPECT_EQ(MemoryStats::usage(Category::Edges).bytes, edgesBefore.bytes);
+    EXPECT_EQ(MemoryStats::usage(Category::NodeTable).bytes, nodesBefore.bytes);
+    EXPECT_EQ(MemoryStats::usage(Category::Analyses).objects, 0);
+}
+
+// Test that a Charge releases exactly what it added
+TEST_F(MemStatsTest, ChargeReleasesOnDestruction) {
+    auto before = MemoryStats::usage(Category::Output);
+    {
+        MemoryStats::Charge charge(Category::Output);
+        charge.add(1000, 4);
+        EXPECT_EQ(MemoryStats::usage(Category::Output).bytes, before.bytes + 1000);
+        EXPECT_EQ(MemoryStats::usage(Category::Output).objects, before.objects + 4);
+    }
+    EXPECT_EQ(MemoryStats::usage(Category::Output).bytes, before.bytes);
+    EXPECT_GE(MemoryStats::usage(Category::Output).peakBytes, before.bytes + 1000);
+}
+
+// Test that the report lists every structure and the process peak
+TEST_F(MemStatsTest, ReportsStructuresAndPeakRss) {
+    EXPECT_GT(MemoryStats::processStatusBytes("VmHWM"), 0);
+    EXPECT_EQ(MemoryStats::processStatusBytes("NoSuchField"), 0);
+
+    std::string report = MemoryStats::report(2);
+    for (const char* row : {"\nline storage ", "\nnode table ", "\nedges ", "\npaths ",
+                            "\nanalyses ", "\noutput buffer ", "\npeak RSS "}) {
+        EXPECT_NE(report.find(row), std::string::npos) << row;
+    }
+    EXPECT_NE(report.find("paths parsed: 2"), std::string::npos);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
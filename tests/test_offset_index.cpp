@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "offset_index.h"
+#include "parser.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utime.h>
+
+// Helper function to create a temporary test file
+std::string createTempTimingReport() {
+    const std::string tempFilePath = "temp_offset_index.rpt";
+    std::ofstream tempFile(tempFilePath);
+
+    tempFile << "Timing Report for Design: test\n";
+    tempFile << "Clock Period: 10.000 ns\n";
+    tempFile << "Path P1     FF_Q        PI          2.345\n";
+    tempFile << "P1.1   NET1        PI          0.123\n";
+    tempFile << "P1.2   INV1        NET1        0.456\n";
+    tempFile << "\n";
+    tempFile << "Path P2     NAND1_Y     PI2         3.210\n";
+    tempFile << "P2.1   NET3        PI2         0.210\n";
+    tempFile << "Path P10    BUF1_Y      PI3         1.000\n";
+    tempFile << "P10.1  NET4        PI3         0.500\n";
+    tempFile << "End of Timing Report\n";
+
+    tempFile.close();
+    return tempFilePath;
+}
+
+class OffsetIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempFilePath = createTempTimingReport();
+    }
+
+    void TearDown() override {
+        std::remove(tempFilePath.c_str());
+        std::remove(OffsetIndex::sidecarPath(tempFilePath).c_str());
+    }
+
+    std::string tempFilePath;
+};
+
+// Test that every path can be found and parsed on its own
+TEST_F(OffsetIndexTest, FindsSectionsById) {
+    ASSERT_EQ(OffsetIndex::build(tempFilePath), 3);
+    auto index = OffsetIndex::open(tempFilePath);
+    ASSERT_EQ(index.size(), 3);
+
+    auto p2 = index.find("P2");
+    ASSERT_TRUE(p2.has_value());
+    EXPECT_EQ(std::string(*p2), "Path P2     NAND1_Y     PI2         3.210\n"
+                                "P2.1   NET3        PI2         0.210\n");
+
+    // P1's section ends at the blank line, P10's at the trailer
+    TimingParser parser;
+    auto p1 = parser.parseSection(std::string(*index.find("P1")));
+    EXPECT_EQ(p1.id, "P1");
+    EXPECT_EQ(p1.edges.size(), 2);
+    auto p10 = parser.parseSection(std::string(*index.find("P10")));
+    EXPECT_EQ(p10.edges.size(), 1);
+    EXPECT_NEAR(p10.totalDelay, 1.0, 0.001);
+
+    EXPECT_FALSE(index.find("P3").has_value());
+    EXPECT_FALSE(index.find("P1.1").has_value());
+}
+
+// Test that lookups refuse a missing or out-of-date index
+TEST_F(OffsetIndexTest, RejectsMissingOrStaleIndex) {
+    EXPECT_THROW(OffsetIndex::open(tempFilePath), std::runtime_error);
+
+    OffsetIndex::build(tempFilePath);
+    EXPECT_NO_THROW(OffsetIndex::open(tempFilePath));
+
+    // Same size, different modification time
+    utimbuf times{1000000, 1000000};
+    ASSERT_EQ(utime(tempFilePath.c_str(), &times), 0);
+    EXPECT_THROW(OffsetIndex::open(tempFilePath), std::runtime_error);
+
+    OffsetIndex::build(tempFilePath);
+    std::ofstream(tempFilePath, std::ios::app) << "Path P11 X Y 1.0\n";
+    EXPECT_THROW(OffsetIndex::open(tempFilePath), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
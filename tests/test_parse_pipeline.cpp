@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "parse_pipeline.h"
+#include "parser.h"
+#include "profiler.h"
+#include "report_generator.h"
+#include "spsc_queue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ParsePipelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Large enough for many batches, with some corrupted lines
+        GeneratorOptions options;
+        options.pathCount = 5000;
+        options.nodeCount = 2000;
+        options.malformedRate = 0.002;
+        options.seed = 7;
+        ReportGenerator(options).writeFile(tempFilePath);
+    }
+
+    void TearDown() override {
+        std::remove(tempFilePath.c_str());
+    }
+
+    // Parse with warnings captured
+    std::vector<TimingPath> parse(TimingParser& parser, std::string& warnings) {
+        std::ostringstream captured;
+        auto* saved = std::cerr.rdbuf(captured.rdbuf());
+        auto paths = parser.parseFile(tempFilePath);
+        std::cerr.rdbuf(saved);
+        warnings = captured.str();
+        return paths;
+    }
+
+    const std::string tempFilePath = "temp_parse_pipeline.rpt";
+};
+
+// Test that items arrive in order and close() ends the stream
+TEST(SpscQueueTest, DeliversInOrderUnderBackpressure) {
+    SpscQueue<int> queue(4);
+    std::atomic<bool> cancelled{false};
+    std::thread producer([&] {
+        for (int i = 0; i < 10000; ++i) {
+            queue.push(i, cancelled);
+        }
+        queue.close();
+    });
+
+    int expected = 0;
+    int item = -1;
+    while (queue.pop(item, cancelled)) {
+        ASSERT_EQ(item, expected++);
+    }
+    producer.join();
+    EXPECT_EQ(expected, 10000);
+}
+
+// Test that a consumer left waiting sleeps instead of spinning on a core
+TEST(SpscQueueTest, WaitingConsumerSleeps) {
+    SpscQueue<int> queue(4);
+    std::atomic<bool> cancelled{false};
+    double cpuSeconds = 0.0;
+    std::thread consumer([&] {
+        int item = 0;
+        while (queue.pop(item, cancelled)) {
+        }
+        timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        cpuSeconds = static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    queue.push(1, cancelled);
+    queue.close();
+    consumer.join();
+    EXPECT_LT(cpuSeconds, 0.1);
+}
+
+// Test that a waiting producer gives up when cancelled
+TEST(SpscQueueTest, PushStopsWhenCancelled) {
+    SpscQueue<int> queue(2);
+    std::atomic<bool> cancelled{false};
+    EXPECT_TRUE(queue.push(1, cancelled));
+    EXPECT_TRUE(queue.push(2, cancelled));
+    cancelled = true;
+    EXPECT_FALSE(queue.push(3, cancelled));
+}
+
+// Test that the pipeline builds exactly what a serial parse builds
+TEST_F(ParsePipelineTest, MatchesSerialParse) {
+    for (size_t threads : {1, 3}) {
+        TimingParser serial;
+        TimingParser piped;
+        piped.setParseThreads(threads);
+        serial.setMinDelay(2.0);
+        piped.setMinDelay(2.0);
+
+        std::string serialWarnings, pipedWarnings;
+        auto expected = parse(serial, serialWarnings);
+        auto actual = parse(piped, pipedWarnings);
+
+        EXPECT_FALSE(serialWarnings.empty());
+        EXPECT_EQ(pipedWarnings, serialWarnings);
+        EXPECT_EQ(piped.rejectedPaths(), serial.rejectedPaths());
+        ASSERT_EQ(piped.nodeCount(), serial.nodeCount());
+        for (uint32_t id = 0; id < serial.nodeCount(); ++id) {
+            ASSERT_EQ(piped.nodeName(id), serial.nodeName(id));
+        }
+
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(actual[i].id, expected[i].id);
+            EXPECT_EQ(actual[i].totalDelay, expected[i].totalDelay);
+            EXPECT_EQ(actual[i].startpointId, expected[i].startpointId);
+            ASSERT_EQ(actual[i].edges.size(), expected[i].edges.size());
+            for (size_t e = 0; e < expected[i].edges.size(); ++e) {
+                EXPECT_EQ(actual[i].edges[e]->from->id, expected[i].edges[e]->from->id);
+                EXPECT_EQ(actual[i].edges[e]->to->id, expected[i].edges[e]->to->id);
+                EXPECT_EQ(actual[i].edges[e]->delay, expected[i].edges[e]->delay);
+            }
+        }
+    }
+}
+
+// Test that concurrent tokenizers are charged to parse once, not once per batch
+TEST_F(ParsePipelineTest, TimesParseOnce) {
+    TimingParser parser;
+    parser.setParseThreads(4);
+    std::string warnings;
+    Profiler::setEnabled(true);
+    auto paths = parse(parser, warnings);
+    std::string report = Profiler::report();
+    Profiler::setEnabled(false);
+
+    // Columns: phase (12), wall (12), CPU (12), calls (10), items (12)
+    auto parseLine = report.substr(report.find("\nparse ") + 1);
+    EXPECT_EQ(std::stoul(parseLine.substr(36, 10)), 1u);
+    EXPECT_GE(std::stoul(parseLine.substr(46, 12)), paths.size());
+}
+
+// Test that a missing file is reported before any thread starts
+TEST_F(ParsePipelineTest, ThrowsOnMissingFile) {
+    TimingParser parser;
+    EXPECT_THROW(ParsePipeline(parser, 2).run("does_not_exist.rpt"), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
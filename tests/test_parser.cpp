@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "parser.h"
 #include <fstream>
+#include <iostream>
+#include <sstream>
 #include <string>
 #include <memory>
 
@@ -11,11 +13,11 @@ std::string createTempTimingReport() {
     
     tempFile << "Path   Endpoint   Startpoint   Delay\n";
     tempFile << "------------------------------------------------\n";
-    tempFile << "P1     FF_Q        PI          2.345\n";
+    tempFile << "Path P1     FF_Q        PI          2.345\n";
     tempFile << "P1.1   NET1        PI          0.123\n";
     tempFile << "P1.2   INV1        NET1        0.456\n";
     
-    tempFile << "P2     NAND1_Y     PI2         3.210\n";
+    tempFile << "Path P2     NAND1_Y     PI2         3.210\n";
     tempFile << "P2.1   NET3        PI2         0.210\n";
     tempFile << "P2.2   BUF1        NET3        0.450\n";
     
@@ -111,6 +113,233 @@ TEST_F(ParserTest, HandlesNodeTypes) {
     }
 }
 
+// Test that nodes are interned once with dense IDs
+TEST_F(ParserTest, InternsNodeIds) {
+    TimingParser parser;
+    auto paths = parser.parseFile(tempFilePath);
+    
+    uint32_t net1 = parser.findNodeId("NET1");
+    ASSERT_NE(net1, kInvalidNodeId);
+    ASSERT_LT(net1, parser.nodeCount());
+    
+    // The same node object is shared by every stage that references it
+    ASSERT_EQ(paths[0].edges[0]->to, paths[0].edges[1]->from);
+    ASSERT_EQ(paths[0].edges[0]->to->id, net1);
+    ASSERT_EQ(parser.getNode(net1)->name, "NET1");
+    
+    ASSERT_EQ(parser.findNodeId("NO_SUCH_NODE"), kInvalidNodeId);
+}
+
+// Test that a header scan records paths without parsing their stages
+TEST_F(ParserTest, ScansHeadersOnly) {
+    TimingParser parser;
+    std::vector<PathExtent> extents;
+    auto paths = parser.scanFile(tempFilePath, extents);
+    
+    ASSERT_EQ(paths.size(), 2);
+    ASSERT_EQ(extents.size(), 2);
+    ASSERT_EQ(paths[1].id, "P2");
+    ASSERT_EQ(paths[1].endpoint, "NAND1_Y");
+    ASSERT_NEAR(paths[1].totalDelay, 3.210, 0.001);
+    ASSERT_TRUE(paths[0].edges.empty());
+    ASSERT_EQ(extents[0].headerLine, 2);
+    ASSERT_EQ(extents[0].lineCount, 2);
+    
+    // Stage nodes are only interned once their stages are loaded
+    ASSERT_EQ(parser.findNodeId("NET1"), kInvalidNodeId);
+}
+
+// Test that loading stages for selected paths matches a full parse
+TEST_F(ParserTest, LoadsStagesOfSelectedPaths) {
+    TimingParser fullParser;
+    auto expected = fullParser.parseFile(tempFilePath);
+    
+    TimingParser parser;
+    std::vector<PathExtent> extents;
+    auto paths = parser.scanFile(tempFilePath, extents);
+    parser.loadStages(paths, extents, {1});
+    
+    ASSERT_TRUE(paths[0].edges.empty());
+    ASSERT_EQ(paths[1].edges.size(), expected[1].edges.size());
+    for (size_t i = 0; i < expected[1].edges.size(); ++i) {
+        ASSERT_EQ(paths[1].edges[i]->from->name, expected[1].edges[i]->from->name);
+        ASSERT_EQ(paths[1].edges[i]->to->name, expected[1].edges[i]->to->name);
+        ASSERT_DOUBLE_EQ(paths[1].edges[i]->delay, expected[1].edges[i]->delay);
+    }
+    ASSERT_NE(parser.findNodeId("BUF1"), kInvalidNodeId);
+    ASSERT_EQ(parser.findNodeId("INV1"), kInvalidNodeId);
+}
+
+// Test that a report whose last line has no newline scans and loads in full
+TEST_F(ParserTest, LoadsStagesWithoutFinalNewline) {
+    const std::string noEolPath = "temp_noeol_timing.rpt";
+    std::ofstream(noEolPath) << "Path P1     FF_Q        PI          2.345\n"
+                                "P1.1   NET1        PI          0.123\n"
+                                "P1.2   INV1        NET1        0.456";
+    
+    TimingParser fullParser;
+    auto expected = fullParser.parseFile(noEolPath);
+    TimingParser parser;
+    std::vector<PathExtent> extents;
+    auto paths = parser.scanFile(noEolPath, extents);
+    ASSERT_EQ(paths.size(), 1);
+    parser.loadStages(paths, extents, {0});
+    std::remove(noEolPath.c_str());
+    
+    ASSERT_EQ(expected[0].edges.size(), 2);
+    ASSERT_EQ(paths[0].edges.size(), 2);
+    EXPECT_EQ(paths[0].edges[1]->from->name, expected[0].edges[1]->from->name);
+    EXPECT_DOUBLE_EQ(paths[0].edges[1]->delay, 0.456);
+}
+
+// Test that paths below the delay threshold are skipped before interning
+TEST_F(ParserTest, RejectsPathsBelowMinDelay) {
+    TimingParser parser;
+    parser.setMinDelay(3.0);
+    auto paths = parser.parseFile(tempFilePath);
+    
+    ASSERT_EQ(paths.size(), 1);
+    ASSERT_EQ(paths[0].id, "P2");
+    ASSERT_EQ(paths[0].edges.size(), 2);
+    ASSERT_EQ(parser.rejectedPaths(), 1);
+    ASSERT_EQ(parser.findNodeId("FF_Q"), kInvalidNodeId);
+    ASSERT_EQ(parser.findNodeId("INV1"), kInvalidNodeId);
+}
+
+// Test that the slack threshold is taken against the file's clock period
+TEST_F(ParserTest, RejectsPathsAboveMinSlack) {
+    const std::string slackFile = "temp_test_slack.rpt";
+    {
+        std::ofstream out(slackFile);
+        out << "Clock Period: 3.000 ns\n";
+        out << "Path P1     FF_Q        PI          2.345\n";
+        out << "P1.1   NET1        PI          0.123\n";
+        out << "Path P2     NAND1_Y     PI2         3.210\n";
+        out << "P2.1   NET3        PI2         0.210\n";
+    }
+    
+    // Slack is 0.655 for P1 and -0.210 for P2
+    TimingParser parser;
+    parser.setMinSlack(0.5);
+    std::vector<PathExtent> extents;
+    auto paths = parser.scanFile(slackFile, extents);
+    removeTempFile(slackFile);
+    
+    ASSERT_EQ(paths.size(), 1);
+    ASSERT_EQ(paths[0].id, "P2");
+    ASSERT_EQ(extents.size(), 1);
+    ASSERT_EQ(extents[0].headerLine, 3);
+}
+
+// Test that the running K-th best delay raises the threshold
+TEST_F(ParserTest, TopKCutoffKeepsCandidatesOnly) {
+    const std::string rankFile = "temp_test_cutoff.rpt";
+    {
+        std::ofstream out(rankFile);
+        const double delays[] = {5.0, 4.0, 1.0, 6.0, 4.0, 2.0, 7.0};
+        for (size_t i = 0; i < 7; ++i) {
+            out << "Path P" << i + 1 << "  END" << i << "  START  " << delays[i] << "\n";
+            out << "P" << i + 1 << ".1   NET" << i << "   START   0.100\n";
+        }
+    }
+    
+    TimingParser parser;
+    parser.setTopKCutoff(2);
+    auto paths = parser.parseFile(rankFile);
+    removeTempFile(rankFile);
+    
+    // P3, P5 (ties the 2nd best) and P6 cannot reach the top 2 when read
+    std::vector<std::string> ids;
+    for (const auto& path : paths) {
+        ids.push_back(path.id);
+    }
+    ASSERT_EQ(ids, (std::vector<std::string>{"P1", "P2", "P4", "P7"}));
+    ASSERT_EQ(parser.rejectedPaths(), 3);
+}
+
+// Test that only the worst path to each endpoint survives, however it is parsed
+TEST_F(ParserTest, KeepsWorstPathPerEndpoint) {
+    const std::string uniqueFile = "temp_test_unique.rpt";
+    const std::string laterFile = "temp_test_unique_later.rpt";
+    {
+        std::ofstream out(uniqueFile);
+        const char* ends[] = {"E1", "E2", "E1", "E1", "E2", "E3"};
+        const double delays[] = {2.0, 1.0, 3.0, 3.0, 0.5, 4.0};
+        for (size_t i = 0; i < 6; ++i) {
+            out << "Path P" << i + 1 << "  " << ends[i] << "  START  " << delays[i] << "\n";
+            out << "P" << i + 1 << ".1   NET" << i << "   START   0.100\n\n";
+        }
+        std::ofstream later(laterFile);
+        later << "Path Q1  E2  START  1.5\nQ1.1   NETQ   START   0.100\n";
+    }
+    
+    // P3 replaces P1 in place; P4 ties P3 and P5 loses to P2 at the header
+    for (size_t threads : {0, 2}) {
+        TimingParser parser;
+        parser.setUniqueEndpoints(true);
+        parser.setParseThreads(threads);
+        auto paths = parser.parseFile(uniqueFile);
+        std::vector<std::string> ids;
+        for (const auto& path : paths) {
+            ids.push_back(path.id);
+        }
+        EXPECT_EQ(ids, (std::vector<std::string>{"P3", "P2", "P6"}));
+        EXPECT_EQ(paths[0].edges.size(), 1);
+        EXPECT_EQ(parser.rejectedPaths(), 2);
+        EXPECT_EQ(parser.findNodeId("NET3"), kInvalidNodeId);
+    }
+    
+    TimingParser parser;
+    parser.setUniqueEndpoints(true);
+    std::vector<PathExtent> extents;
+    auto paths = parser.scanFile(uniqueFile, extents);
+    ASSERT_EQ(paths.size(), 3);
+    ASSERT_EQ(extents.size(), 3);
+    EXPECT_EQ(paths[0].id, "P3");
+    EXPECT_EQ(extents[0].headerLine, 6);
+    
+    // A later file beats P2, which only the caller can drop
+    auto later = parser.scanFile(laterFile, extents);
+    removeTempFile(uniqueFile);
+    removeTempFile(laterFile);
+    ASSERT_EQ(later.size(), 1);
+    EXPECT_FALSE(parser.isWorstForEndpoint(paths[1]));
+    EXPECT_TRUE(parser.isWorstForEndpoint(paths[0]));
+    EXPECT_TRUE(parser.isWorstForEndpoint(later[0]));
+}
+
+// Test that the header check reads delays and rejects headers exactly as the
+// header parser does
+TEST_F(ParserTest, ScreensHeadersWithTheParsersGrammar) {
+    const std::string gramFile = "temp_test_grammar.rpt";
+    {
+        std::ofstream out(gramFile);
+        out << "Path P1  E1  START  1.5e3\nP1.1   NET1   START   0.100\n\n";  // 1.5, not 1500
+        out << "Path P2  E1  START  2.0\nP2.1   NET2   START   0.100\n\n";
+        out << "Path P3  E2  9.0\n\n";                                        // No startpoint
+        out << "Path P4  E3  START  1.8\nP4.1   NET4   START   0.100\n";
+    }
+    
+    for (size_t threads : {0, 2}) {
+        TimingParser parser;
+        parser.setUniqueEndpoints(true);
+        parser.setTopKCutoff(2);
+        parser.setParseThreads(threads);
+        std::ostringstream warnings;
+        auto* saved = std::cerr.rdbuf(warnings.rdbuf());
+        auto paths = parser.parseFile(gramFile);
+        std::cerr.rdbuf(saved);
+        
+        // P2 beats P1's 1.5; the malformed P3 neither enters nor raises the cutoff
+        ASSERT_EQ(paths.size(), 2);
+        EXPECT_EQ(paths[0].id, "P2");
+        EXPECT_TRUE(parser.isWorstForEndpoint(paths[0]));
+        EXPECT_EQ(paths[1].id, "P4");
+        EXPECT_NE(warnings.str().find("Invalid path header"), std::string::npos);
+    }
+    removeTempFile(gramFile);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
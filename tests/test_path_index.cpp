@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "analyzer.h"
+#include "path_index.h"
+#include <memory>
+#include <vector>
+
+// Helper to create a path whose stages run through the given node IDs
+TimingPath createTestPath(const std::vector<std::shared_ptr<TimingNode>>& nodes,
+                          const std::vector<uint32_t>& route, double delay) {
+    TimingPath path;
+    path.id = "P";
+    path.totalDelay = delay;
+    for (size_t i = 0; i + 1 < route.size(); ++i) {
+        path.edges.push_back(std::make_shared<TimingEdge>(nodes[route[i]], nodes[route[i + 1]], 0.1));
+    }
+    return path;
+}
+
+class PathIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (uint32_t id = 0; id < 4; ++id) {
+            nodes.push_back(std::make_shared<TimingNode>("N" + std::to_string(id), "cell"));
+            nodes.back()->id = id;
+        }
+    }
+
+    std::vector<std::shared_ptr<TimingNode>> nodes;
+};
+
+// Test that posting lists hold exactly the paths through each node
+TEST_F(PathIndexTest, ListsPathsThroughNode) {
+    std::vector<TimingPath> paths = {
+        createTestPath(nodes, {0, 1, 2}, 1.0),
+        createTestPath(nodes, {0, 2}, 2.0),
+        createTestPath(nodes, {1, 2, 1}, 3.0),
+    };
+    auto index = PathIndex::build(paths, nodes.size());
+
+    EXPECT_EQ(index.pathsThrough(0), (std::vector<uint32_t>{0, 1}));
+    EXPECT_EQ(index.pathsThrough(1), (std::vector<uint32_t>{0, 2}));
+    EXPECT_EQ(index.pathsThrough(2), (std::vector<uint32_t>{0, 1, 2}));
+    EXPECT_TRUE(index.pathsThrough(3).empty());
+    EXPECT_EQ(index.pathCount(2), 3u);
+}
+
+// Test that unknown node IDs yield no paths
+TEST_F(PathIndexTest, HandlesUnknownNodes) {
+    std::vector<TimingPath> paths = {createTestPath(nodes, {0, 1}, 1.0)};
+    auto index = PathIndex::build(paths, nodes.size());
+
+    EXPECT_TRUE(index.pathsThrough(kInvalidNodeId).empty());
+    EXPECT_EQ(index.pathCount(99), 0u);
+}
+
+// Test that large gaps between path IDs survive delta encoding
+TEST_F(PathIndexTest, DecodesLargeGaps) {
+    std::vector<TimingPath> paths;
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < 40000; ++i) {
+        bool hit = i == 0 || i == 127 || i == 128 || i == 20000 || i == 39999;
+        paths.push_back(createTestPath(nodes, hit ? std::vector<uint32_t>{0, 3}
+                                                  : std::vector<uint32_t>{0, 1}, 1.0));
+        if (hit) expected.push_back(i);
+    }
+    auto index = PathIndex::build(paths, nodes.size());
+
+    EXPECT_EQ(index.pathsThrough(3), expected);
+    EXPECT_EQ(index.pathsThrough(0).size(), paths.size());
+}
+
+// Test that the analyzer ranks only the matching paths
+TEST_F(PathIndexTest, AnalyzerFindsPathsThroughNode) {
+    std::vector<TimingPath> paths = {
+        createTestPath(nodes, {0, 1}, 1.0),
+        createTestPath(nodes, {2, 3}, 9.0),
+        createTestPath(nodes, {1, 2}, 3.0),
+        createTestPath(nodes, {0, 1, 3}, 2.0),
+    };
+    paths[0].id = "P1";
+    paths[2].id = "P3";
+    paths[3].id = "P4";
+    auto index = PathIndex::build(paths, nodes.size());
+
+    TimingAnalyzer analyzer;
+    auto results = analyzer.findPathsThrough(paths, index, 1, 2);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].path->id, "P3");
+    EXPECT_EQ(results[1].path->id, "P4");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include "analyzer.h"
+#include "parser.h"
+#include "report_generator.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+
+// Every operator new in this binary goes through these counters
+static std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+// Baselines and budgets from tests/perf_baseline.txt, as "key value" lines
+class Baseline {
+public:
+    static const Baseline& get() {
+        static Baseline baseline(PERF_BASELINE_FILE);
+        return baseline;
+    }
+
+    double value(const std::string& key) const {
+        auto it = values.find(key);
+        if (it == values.end()) {
+            throw std::runtime_error("Missing perf baseline: " + key);
+        }
+        return it->second;
+    }
+
+    // Lowest acceptable throughput for a recorded baseline
+    double floor(const std::string& key) const {
+        double tolerance = value("tolerance");
+        if (const char* env = std::getenv("TIMING_PERF_TOLERANCE")) {
+            tolerance = std::stod(env);
+        }
+        return value(key) * (1.0 - tolerance);
+    }
+
+private:
+    explicit Baseline(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file) {
+            throw std::runtime_error("Failed to open perf baseline: " + filename);
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            std::string key;
+            double number;
+            if (fields >> key >> number) {
+                values[key] = number;
+            }
+        }
+    }
+
+    std::map<std::string, double> values;
+};
+
+// CPU time of the calling thread; unlike wall time it does not count time
+// other processes held the CPU
+double threadSeconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+// Best rate of the measured code divided by the best rate of a reference loop
+// doing comparable work on the same input. Runs alternate and are timed in
+// thread CPU time, so machine load affects both alike, and the ratio carries
+// over between machines where an absolute rate would not
+template <typename Measured, typename Reference>
+double relativeRate(size_t items, Measured measured, Reference reference) {
+    double bestMeasured = 0.0;
+    double bestReference = 0.0;
+    for (int run = 0; run < 5; ++run) {
+        double start = threadSeconds();
+        reference();
+        bestReference = std::max(bestReference, items / (threadSeconds() - start));
+
+        start = threadSeconds();
+        measured();
+        bestMeasured = std::max(bestMeasured, items / (threadSeconds() - start));
+    }
+    return bestMeasured / bestReference;
+}
+
+// Throughput floors only mean something for optimized builds
+#ifdef NDEBUG
+#define SKIP_UNLESS_OPTIMIZED()
+#else
+#define SKIP_UNLESS_OPTIMIZED() GTEST_SKIP() << "throughput gates need an optimized build"
+#endif
+
+class PerfTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        GeneratorOptions options;
+        options.pathCount = kFixturePaths;
+        options.minStages = 4;
+        options.maxStages = 12;
+        options.nodeCount = 20000;
+        options.seed = 7;
+        ReportGenerator(options).writeFile(kFixtureFile);
+    }
+
+    static void TearDownTestSuite() {
+        std::remove(kFixtureFile);
+    }
+
+    static constexpr size_t kFixturePaths = 20000;
+    static constexpr const char* kFixtureFile = "temp_perf_fixture.rpt";
+};
+
+// Paths with random delays and no stages, for ranking without parsing
+std::vector<TimingPath> makeRankFixture(size_t count) {
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> delay(0.1, 10.0);
+    std::vector<TimingPath> paths(count);
+    for (size_t i = 0; i < count; ++i) {
+        paths[i].id = "P" + std::to_string(i + 1);
+        paths[i].totalDelay = delay(rng);
+    }
+    return paths;
+}
+
+// Test that parsing keeps its speed relative to reading the fixture's lines
+// and converting one number per line
+TEST_F(PerfTest, ParseThroughput) {
+    SKIP_UNLESS_OPTIMIZED();
+
+    size_t parsed = 0;
+    double checksum = 0.0;
+    double ratio = relativeRate(
+        kFixturePaths,
+        [&] {
+            TimingParser parser;
+            parsed = parser.parseFile(kFixtureFile).size();
+        },
+        [&] {
+            std::ifstream file(kFixtureFile);
+            std::string line;
+            while (std::getline(file, line)) {
+                size_t last = line.find_last_of(' ');
+                checksum += std::strtod(line.c_str() + (last == std::string::npos ? 0 : last),
+                                        nullptr);
+            }
+        });
+    ASSERT_EQ(parsed, kFixturePaths);
+    EXPECT_GT(checksum, 0.0);
+
+    std::cout << "parse: " << ratio << "x reference" << std::endl;
+    EXPECT_GE(ratio, Baseline::get().floor("parse_vs_reference"));
+}
+
+// Test that top-K ranking keeps its speed relative to a partial sort of the
+// bare delays
+TEST_F(PerfTest, RankThroughput) {
+    SKIP_UNLESS_OPTIMIZED();
+
+    auto paths = makeRankFixture(500000);
+    TimingAnalyzer analyzer;
+
+    size_t selected = 0;
+    double ratio = relativeRate(
+        paths.size(),
+        [&] { selected = analyzer.findCriticalPaths(paths, 100).size(); },
+        [&] {
+            std::vector<double> delays(paths.size());
+            for (size_t i = 0; i < paths.size(); ++i) {
+                delays[i] = paths[i].totalDelay;
+            }
+            std::partial_sort(delays.begin(), delays.begin() + 100, delays.end(),
+                              std::greater<double>());
+            ASSERT_GT(delays[0], delays[99]);
+        });
+    ASSERT_EQ(selected, 100u);
+
+    std::cout << "rank: " << ratio << "x reference" << std::endl;
+    EXPECT_GE(ratio, Baseline::get().floor("rank_vs_reference"));
+}
+
+// Test that parsing stays within its allocation budget per path
+TEST_F(PerfTest, ParseAllocationBudget) {
+    TimingParser parser;
+    uint64_t before = allocationCount.load();
+    auto paths = parser.parseFile(kFixtureFile);
+    double perPath = static_cast<double>(allocationCount.load() - before) / paths.size();
+
+    std::cout << "parse: " << perPath << " allocations/path" << std::endl;
+    EXPECT_LE(perPath, Baseline::get().value("parse_allocs_per_path"));
+}
+
+// Test that ranking allocates per selected path, not per ranked path
+TEST_F(PerfTest, RankAllocationBudget) {
+    auto paths = makeRankFixture(100000);
+    TimingAnalyzer analyzer;
+
+    uint64_t before = allocationCount.load();
+    auto critical = analyzer.findCriticalPaths(paths, 10);
+    double perPath = static_cast<double>(allocationCount.load() - before) / paths.size();
+
+    std::cout << "rank: " << perPath << " allocations/path" << std::endl;
+    EXPECT_LE(perPath, Baseline::get().value("rank_allocs_per_path"));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
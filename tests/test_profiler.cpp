@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "parser.h"
+#include "profiler.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+// Helper function to create a temporary test file
+std::string createTempTimingReport() {
+    const std::string tempFilePath = "temp_profiler_timing.rpt";
+    std::ofstream tempFile(tempFilePath);
+
+    tempFile << "Path P1     FF_Q        PI          2.345\n";
+    tempFile << "P1.1   NET1        PI          0.123\n";
+    tempFile << "P1.2   INV1        NET1        0.456\n";
+
+    tempFile.close();
+    return tempFilePath;
+}
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempFilePath = createTempTimingReport();
+    }
+
+    void TearDown() override {
+        Profiler::setEnabled(false);
+        std::remove(tempFilePath.c_str());
+    }
+
+    std::string tempFilePath;
+};
+
+// Test that timers record nothing while profiling is off
+TEST_F(ProfilerTest, DisabledTimersRecordNothing) {
+    Profiler::setEnabled(true);
+    Profiler::setEnabled(false);
+
+    TimingParser parser;
+    parser.parseFile(tempFilePath);
+
+    std::string report = Profiler::report();
+    EXPECT_EQ(report.find("\nparse "), std::string::npos);
+    EXPECT_EQ(report.find("\nfile read "), std::string::npos);
+}
+
+// Test that enabled timers charge parse phases with their item counts
+TEST_F(ProfilerTest, RecordsParsePhases) {
+    Profiler::setEnabled(true);
+
+    TimingParser parser;
+    parser.parseFile(tempFilePath);
+
+    {
+        Profiler::ScopedTimer timer(Profiler::Phase::Rank);
+        timer.addItems(42);
+    }
+
+    std::string report = Profiler::report();
+    EXPECT_NE(report.find("\nfile read "), std::string::npos);
+    EXPECT_NE(report.find("\nparse "), std::string::npos);
+    EXPECT_NE(report.find("\n  intern "), std::string::npos);
+
+    auto rankLine = report.substr(report.find("\nrank ") + 1);
+    rankLine = rankLine.substr(0, rankLine.find('\n'));
+    EXPECT_NE(rankLine.find(" 42 "), std::string::npos);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "query.h"
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+// Helper function to create a temporary test file
+std::string createTempTimingReport() {
+    const std::string tempFilePath = "temp_query_timing.rpt";
+    std::ofstream tempFile(tempFilePath);
+
+    tempFile << "Path P1     FF1_D       PI          2.345\n";
+    tempFile << "P1.1   NET1        PI          0.123\n";
+    tempFile << "P1.2   INV1        NET1        0.456\n";
+    tempFile << "\n";
+    tempFile << "Path P2     FF2_D       PI2         5.210\n";
+    tempFile << "P2.1   NET3        PI2         0.210\n";
+    tempFile << "P2.2   BUF1        NET3        1.450\n";
+    tempFile << "P2.3   NET4        BUF1        0.300\n";
+    tempFile << "\n";
+    tempFile << "Path P3     PO1         PI          4.900\n";
+    tempFile << "P3.1   NET5        PI          0.700\n";
+    tempFile << "P3.2   BUF2        NET5        0.900\n";
+
+    tempFile.close();
+    return tempFilePath;
+}
+
+class QueryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempFilePath = createTempTimingReport();
+        paths = parser.parseFile(tempFilePath);
+        index = PathIndex::build(paths, parser.nodeCount());
+        columns = PathColumns::build(paths);
+    }
+
+    void TearDown() override {
+        std::remove(tempFilePath.c_str());
+    }
+
+    std::vector<uint32_t> select(const std::string& text) {
+        return PathQuery::compile(text).evaluate(columns, parser, index).toIds();
+    }
+
+    std::string tempFilePath;
+    TimingParser parser;
+    std::vector<TimingPath> paths;
+    PathIndex index;
+    PathColumns columns;
+};
+
+// Test numeric column filters
+TEST_F(QueryTest, FiltersNumericColumns) {
+    EXPECT_EQ(select("delay > 4.5"), (std::vector<uint32_t>{1, 2}));
+    EXPECT_EQ(select("stages >= 3"), (std::vector<uint32_t>{1}));
+    EXPECT_EQ(select("worst < 1"), (std::vector<uint32_t>{0, 2}));
+    EXPECT_EQ(select("delay > 4.5 and stages >= 3"), (std::vector<uint32_t>{1}));
+}
+
+// Test name patterns resolved through the interned node table
+TEST_F(QueryTest, MatchesNamePatterns) {
+    EXPECT_EQ(select("endpoint ~ \"FF*_D\""), (std::vector<uint32_t>{0, 1}));
+    EXPECT_EQ(select("endpoint == PO1"), (std::vector<uint32_t>{2}));
+    EXPECT_EQ(select("startpoint != PI"), (std::vector<uint32_t>{1}));
+    EXPECT_TRUE(select("endpoint == NOT_A_NODE").empty());
+}
+
+// Test node membership through the path index
+TEST_F(QueryTest, FiltersByNodesOnPath) {
+    EXPECT_EQ(select("through \"BUF*\""), (std::vector<uint32_t>{1, 2}));
+    EXPECT_EQ(select("through INV1"), (std::vector<uint32_t>{0}));
+    EXPECT_EQ(select("through BUF1 or through INV1"), (std::vector<uint32_t>{0, 1}));
+    EXPECT_EQ(select("not through \"BUF*\""), (std::vector<uint32_t>{0}));
+}
+
+// Test operator precedence and grouping
+TEST_F(QueryTest, HonoursPrecedence) {
+    EXPECT_EQ(select("delay < 3 or delay > 5 and stages == 3"), (std::vector<uint32_t>{0, 1}));
+    EXPECT_EQ(select("(delay < 3 or delay > 5) and stages == 2"), (std::vector<uint32_t>{0}));
+    EXPECT_EQ(select("DELAY > 4.5 AND NOT endpoint ~ \"FF*\""), (std::vector<uint32_t>{2}));
+}
+
+// Test that malformed expressions are rejected at compile time
+TEST_F(QueryTest, RejectsBadSyntax) {
+    EXPECT_THROW(PathQuery::compile(""), std::invalid_argument);
+    EXPECT_THROW(PathQuery::compile("delay >"), std::invalid_argument);
+    EXPECT_THROW(PathQuery::compile("slack > 1"), std::invalid_argument);
+    EXPECT_THROW(PathQuery::compile("(delay > 1"), std::invalid_argument);
+    EXPECT_THROW(PathQuery::compile("endpoint > FF"), std::invalid_argument);
+    EXPECT_THROW(PathQuery::compile("stages > 2.5"), std::invalid_argument);
+    EXPECT_THROW(PathQuery::compile("through \"BUF"), std::invalid_argument);
+}
+
+// Test that the vectorized kernels agree with a scalar scan, including tails
+TEST(QueryKernelTest, MatchesScalarScan) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> delays(0.0, 10.0);
+    std::uniform_int_distribution<uint32_t> stages(1, 12);
+
+    PathColumns columns;
+    for (size_t i = 0; i < 1000; ++i) {
+        columns.delay.push_back(i % 97 == 0 ? 5.0 : delays(rng));
+        columns.worstStageDelay.push_back(delays(rng) / 4);
+        columns.stageCount.push_back(stages(rng));
+        columns.startId.push_back(kInvalidNodeId);
+        columns.endId.push_back(kInvalidNodeId);
+    }
+
+    TimingParser parser;
+    PathIndex index;
+    const char* ops[] = {"<", "<=", ">", ">=", "==", "!="};
+    for (const char* op : ops) {
+        auto delayIds = PathQuery::compile(std::string("delay ") + op + " 5")
+                            .evaluate(columns, parser, index);
+        auto stageIds = PathQuery::compile(std::string("stages ") + op + " 6")
+                            .evaluate(columns, parser, index);
+        std::string opText = op;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            double d = columns.delay[i];
+            uint32_t s = columns.stageCount[i];
+            bool expectDelay = opText == "<" ? d < 5 : opText == "<=" ? d <= 5 : opText == ">" ? d > 5
+                             : opText == ">=" ? d >= 5 : opText == "==" ? d == 5 : d != 5;
+            bool expectStage = opText == "<" ? s < 6 : opText == "<=" ? s <= 6 : opText == ">" ? s > 6
+                             : opText == ">=" ? s >= 6 : opText == "==" ? s == 6 : s != 6;
+            ASSERT_EQ(delayIds.test(i), expectDelay) << "delay " << op << " row " << i;
+            ASSERT_EQ(stageIds.test(i), expectStage) << "stages " << op << " row " << i;
+        }
+    }
+}
+
+// Test that the plan lists one scan per predicate in postfix order
+TEST(QueryPlanTest, ExplainsPlan) {
+    auto query = PathQuery::compile("delay > 4.5 and not through \"BUF*\"");
+    EXPECT_EQ(query.explain(),
+              "1. scan delay > 4.5\n"
+              "2. index through \"BUF*\"\n"
+              "3. not\n"
+              "4. and\n");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
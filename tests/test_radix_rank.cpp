@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "analyzer.h"
+#include "radix_rank.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Test that keys order like the scores they come from, most critical first
+TEST(RadixRankTest, KeysPreserveScoreOrder) {
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> scores = {inf, 1e300, 5.678, 1.0, 1e-300, 0.0, -1e-300, -1.0, -1e300, -inf};
+    for (size_t i = 0; i + 1 < scores.size(); ++i) {
+        EXPECT_LT(RadixRank::descendingKey(scores[i]), RadixRank::descendingKey(scores[i + 1]))
+            << scores[i] << " vs " << scores[i + 1];
+    }
+    EXPECT_EQ(RadixRank::descendingKey(0.0), RadixRank::descendingKey(-0.0));
+}
+
+// Test that the sort is stable and matches a comparison sort, serially and
+// across workers
+TEST(RadixRankTest, MatchesStableSort) {
+    std::mt19937 random(5);
+    std::uniform_int_distribution<int> hundredths(-50000, 50000);
+    std::vector<RadixRank::KeyedRow> rows(300000);
+    for (uint32_t i = 0; i < rows.size(); ++i) {
+        rows[i] = {RadixRank::descendingKey(hundredths(random) / 100.0), i};  // Many ties
+    }
+    auto expected = rows;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto& a, const auto& b) { return a.key < b.key; });
+
+    for (size_t threads : {1, 4}) {
+        ThreadPool pool(threads);
+        auto sorted = rows;
+        RadixRank::sort(sorted, pool);
+        ASSERT_EQ(sorted.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(sorted[i].row, expected[i].row) << "at " << i << " with " << threads;
+        }
+    }
+}
+
+// Test that ranking every path gives the same order as selecting them all
+TEST(RadixRankTest, FullRankingMatchesSelection) {
+    std::mt19937 random(9);
+    std::uniform_int_distribution<int> tenths(0, 300);
+    PathColumns columns;
+    std::vector<TimingPath> paths(50000);
+    for (auto& path : paths) {
+        path.totalDelay = tenths(random) / 10.0;
+        columns.delay.push_back(path.totalDelay);
+        columns.worstStageDelay.push_back(path.totalDelay / 2);
+        columns.stageCount.push_back(static_cast<uint32_t>(tenths(random) % 12));
+        columns.netDelayShare.push_back(0.0);
+        columns.slack.push_back(10.0 - path.totalDelay);
+    }
+    std::vector<uint32_t> all(paths.size());
+    std::iota(all.begin(), all.end(), 0u);
+
+    // One fewer than all still goes through the comparison sort
+    TimingAnalyzer analyzer;
+    const int everything = std::numeric_limits<int>::max();
+    auto ranked = analyzer.rankPaths(paths, all, everything);
+    auto selected = analyzer.rankPaths(paths, all, static_cast<int>(paths.size() - 1));
+    ASSERT_EQ(ranked.size(), paths.size());
+    EXPECT_TRUE(std::equal(selected.begin(), selected.end(), ranked.begin()));
+
+    ThreadPool pool(2);
+    EXPECT_EQ(RadixRank::rankRows(columns, all, RankKey::Slack, pool),
+              rankRows<RankKeys::Slack>(columns, all, everything));
+    EXPECT_EQ(RadixRank::rankRows(columns, all, RankKey::Stages, pool),
+              rankRows<RankKeys::Stages>(columns, all, everything));
+    EXPECT_EQ(analyzer.rankPaths(columns, all, everything, RankKey::Delay), ranked);
+}
+
+// Test that -k all with several keys ranks everything when the radix sort
+// does not apply: too few rows, or candidates out of row order
+TEST(RadixRankTest, RanksAllBySeveralKeysWithoutRadix) {
+    PathColumns columns;
+    const size_t rows = RadixRank::kMinRows - 1;
+    for (size_t i = 0; i < rows; ++i) {
+        columns.delay.push_back(static_cast<double>(i % 97));
+        columns.worstStageDelay.push_back(0.0);
+        columns.stageCount.push_back(static_cast<uint32_t>(i % 13));
+        columns.netDelayShare.push_back(0.0);
+        columns.slack.push_back(0.0);
+    }
+    std::vector<uint32_t> all(rows);
+    std::iota(all.begin(), all.end(), 0u);
+    std::vector<uint32_t> reversed(all.rbegin(), all.rend());
+    std::vector<RankKey> keys = {RankKey::Delay, RankKey::Stages};
+
+    TimingAnalyzer analyzer;
+    const int everything = std::numeric_limits<int>::max();
+    for (const auto& candidates : {all, reversed}) {
+        auto ranked = analyzer.rankPaths(columns, candidates, everything, keys);
+        ASSERT_EQ(ranked.size(), keys.size());
+        for (size_t k = 0; k < keys.size(); ++k) {
+            EXPECT_EQ(ranked[k], analyzer.rankPaths(columns, candidates, everything, keys[k]));
+        }
+    }
+}
+
+// Test that selecting a range gives the same slice as sorting everything
+TEST(RadixRankTest, SelectsRankRanges) {
+    std::mt19937 random(13);
+    std::uniform_int_distribution<int> thousandths(-2000, 20000);
+    std::vector<RadixRank::KeyedRow> rows(200000);
+    for (uint32_t i = 0; i < rows.size(); ++i) {
+        rows[i] = {RadixRank::descendingKey(thousandths(random) / 1000.0), i};
+    }
+    auto sorted = rows;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const auto& a, const auto& b) { return a.key < b.key; });
+
+    const std::pair<size_t, size_t> ranges[] = {
+        {0, 1}, {0, 100}, {99999, 100100}, {150000, 150001}, {199990, 200000}, {0, 200000}};
+    for (size_t threads : {1, 4}) {
+        ThreadPool pool(threads);
+        for (auto [first, last] : ranges) {
+            auto selected = RadixRank::selectRange(rows, first, last, pool);
+            ASSERT_EQ(selected.size(), last - first);
+            for (size_t i = 0; i < selected.size(); ++i) {
+                ASSERT_EQ(selected[i], sorted[first + i].row)
+                    << "rank " << first + i << " with " << threads;
+            }
+        }
+        EXPECT_EQ(RadixRank::selectRange(rows, 199998, 300000, pool).size(), 2u);
+        EXPECT_TRUE(RadixRank::selectRange(rows, 300000, 300010, pool).empty());
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
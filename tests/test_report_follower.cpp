@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "report_follower.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+const std::string kPreamble = "Timing Report for Design: test\n"
+                              "Clock Period: 10.000 ns\n";
+const std::string kP1 = "Path P1     FF_Q        PI          2.345\n"
+                        "P1.1   NET1        PI          0.123\n"
+                        "P1.2   INV1        NET1        0.456\n";
+const std::string kP2 = "Path P2     NAND1_Y     PI2         3.210\n"
+                        "P2.1   NET3        PI2         0.210\n";
+const std::string kP3 = "Path P3     BUF1_Y      PI3         2.345\n"
+                        "P3.1   NET4        PI3         0.500\n";
+const std::string kTrailer = "End of Timing Report\n";
+
+} // namespace
+
+class ReportFollowerTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::remove(tempFilePath.c_str());
+    }
+
+    // Append text the way a running STA job would
+    void append(const std::string& text) {
+        std::ofstream(tempFilePath, std::ios::app | std::ios::binary) << text;
+    }
+
+    const std::string tempFilePath = "temp_follow.rpt";
+};
+
+// Test that only sections whose end has been written are parsed
+TEST_F(ReportFollowerTest, ParsesCompletedSectionsOnly) {
+    ReportFollower follower(tempFilePath, 10);
+    EXPECT_EQ(follower.poll(), 0);  // Not written yet
+
+    append(kPreamble + kP1 + "\n" + kP2);
+    EXPECT_EQ(follower.poll(), 1);
+    ASSERT_EQ(follower.topPaths().size(), 1);
+    EXPECT_EQ(follower.topPaths()[0].id, "P1");
+    EXPECT_EQ(follower.topPaths()[0].edges.size(), 2);
+    // P2 may still get more stages, so the checkpoint stops at its header
+    EXPECT_EQ(follower.checkpoint(), kPreamble.size() + kP1.size() + 1);
+
+    append("P2.2   NAND1_Y     NET3        0.300\n");
+    EXPECT_EQ(follower.poll(), 0);
+
+    append(kTrailer);
+    EXPECT_EQ(follower.poll(), 1);
+    EXPECT_TRUE(follower.finished());
+    EXPECT_EQ(follower.pathCount(), 2);
+    ASSERT_EQ(follower.topPaths().size(), 2);
+    EXPECT_EQ(follower.topPaths()[0].id, "P2");
+    EXPECT_EQ(follower.topPaths()[0].edges.size(), 2);
+}
+
+// Test that the kept top K is ordered by delay with ties in report order
+TEST_F(ReportFollowerTest, KeepsIncrementalTopK) {
+    ReportFollower follower(tempFilePath, 2);
+    append(kPreamble + kP1);
+    follower.poll();
+    append(kP2 + kP3);
+    follower.poll();
+    append(kTrailer);
+    follower.poll();
+
+    EXPECT_EQ(follower.pathCount(), 3);
+    ASSERT_EQ(follower.topPaths().size(), 2);
+    EXPECT_EQ(follower.topPaths()[0].id, "P2");
+    EXPECT_EQ(follower.topPaths()[1].id, "P1");  // Ties with P3 but came first
+}
+
+// Test that sections that cannot make the top K are skipped at the header
+TEST_F(ReportFollowerTest, SkipsSlowSectionsBeforeParsing) {
+    ReportFollower follower(tempFilePath, 1);
+    append(kPreamble + kP2 + "\n");
+    follower.poll();
+    size_t names = follower.internedNames();
+    EXPECT_GT(names, 0u);
+
+    // P1 and P3 are slower than P2, so none of their names are interned
+    append(kP1 + "\n" + kP3 + kTrailer);
+    follower.poll();
+    EXPECT_EQ(follower.pathCount(), 3);
+    EXPECT_EQ(follower.internedNames(), names);
+    ASSERT_EQ(follower.topPaths().size(), 1);
+    EXPECT_EQ(follower.topPaths()[0].id, "P2");
+}
+
+// Test that the node table is replaced instead of growing with every name
+TEST_F(ReportFollowerTest, BoundsNodeTable) {
+    // Rising delays, so every section makes the top K and is parsed
+    std::string report = kPreamble;
+    const int paths = 25000;
+    for (int i = 0; i < paths; ++i) {
+        std::string n = std::to_string(i);
+        report += "Path Q" + n + "  E" + n + "  S" + n + "  " + std::to_string(1.0 + i * 1e-4) +
+                  "\nQ" + n + ".1  N" + n + "  S" + n + "  0.100\n\n";
+    }
+    append(report + kTrailer);
+
+    ReportFollower follower(tempFilePath, 2);
+    follower.poll();
+    EXPECT_EQ(follower.pathCount(), static_cast<size_t>(paths));
+    EXPECT_LE(follower.internedNames(), (size_t(1) << 16) + 3);
+    ASSERT_EQ(follower.topPaths().size(), 2);
+    EXPECT_EQ(follower.topPaths()[0].id, "Q24999");
+    ASSERT_EQ(follower.topPaths()[0].edges.size(), 1);
+    EXPECT_EQ(follower.topPaths()[0].edges[0]->to->name, "N24999");
+}
+
+// Test that a truncated report is followed again from its start
+TEST_F(ReportFollowerTest, RestartsWhenReportShrinks) {
+    ReportFollower follower(tempFilePath, 10);
+    append(kPreamble + kP1 + kP2 + "\n");
+    EXPECT_EQ(follower.poll(), 2);
+
+    std::ofstream(tempFilePath, std::ios::trunc) << kP3 << kTrailer;
+    EXPECT_EQ(follower.poll(), 1);
+    ASSERT_EQ(follower.topPaths().size(), 1);
+    EXPECT_EQ(follower.topPaths()[0].id, "P3");
+    EXPECT_TRUE(follower.finished());
+}
+
+// Test the follow loop with the polling fallback
+TEST_F(ReportFollowerTest, FollowsUntilTrailerWithoutInotify) {
+    append(kPreamble);
+    ReportFollower follower(tempFilePath, 10, false);
+    EXPECT_FALSE(follower.usingInotify());
+
+    std::thread writer([this] {
+        append(kP1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        append(kP2 + kTrailer);
+    });
+
+    int refreshes = 0;
+    follower.follow(std::chrono::milliseconds(10), [&refreshes] { ++refreshes; });
+    writer.join();
+
+    EXPECT_TRUE(follower.finished());
+    EXPECT_EQ(follower.pathCount(), 2);
+    EXPECT_GE(refreshes, 1);
+    EXPECT_EQ(follower.topPaths()[0].id, "P2");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "parser.h"
+#include "report_generator.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Helper to parse a generated report through a temporary file
+std::vector<TimingPath> parseReport(const std::string& report, TimingParser& parser) {
+    const std::string tempFilePath = "temp_generated_timing.rpt";
+    std::ofstream(tempFilePath) << report;
+
+    // Malformed lines produce parser warnings; keep them out of the test log
+    std::stringstream warnings;
+    auto* saved = std::cerr.rdbuf(warnings.rdbuf());
+    auto paths = parser.parseFile(tempFilePath);
+    std::cerr.rdbuf(saved);
+
+    std::remove(tempFilePath.c_str());
+    return paths;
+}
+
+// Test that equal seeds give identical reports and different seeds differ
+TEST(ReportGeneratorTest, IsDeterministic) {
+    GeneratorOptions options;
+    options.pathCount = 200;
+    options.fanoutSkew = 1.1;
+    options.delayDistribution = GeneratorOptions::DelayDistribution::LogNormal;
+
+    std::string first = ReportGenerator(options).toString();
+    EXPECT_EQ(first, ReportGenerator(options).toString());
+
+    options.seed = 2;
+    EXPECT_NE(first, ReportGenerator(options).toString());
+}
+
+// Test that every generated path parses with the requested shape
+TEST(ReportGeneratorTest, ProducesParsableReports) {
+    GeneratorOptions options;
+    options.pathCount = 200;
+    options.minStages = 3;
+    options.maxStages = 7;
+    options.minDelay = 0.1;
+    options.maxDelay = 0.2;
+
+    GeneratorStats stats;
+    std::string report = ReportGenerator(options).toString(&stats);
+    EXPECT_EQ(stats.bytes, report.size());
+    EXPECT_EQ(stats.validPaths, 200u);
+
+    TimingParser parser;
+    auto paths = parseReport(report, parser);
+    ASSERT_EQ(paths.size(), 200u);
+
+    uint64_t stages = 0;
+    for (const auto& path : paths) {
+        ASSERT_GE(path.edges.size(), 3u);
+        ASSERT_LE(path.edges.size(), 7u);
+        stages += path.edges.size();
+
+        double sum = 0.0;
+        for (const auto& edge : path.edges) {
+            EXPECT_GE(edge->delay, 0.1 - 1e-9);
+            EXPECT_LE(edge->delay, 0.2 + 1e-9);
+            sum += edge->delay;
+        }
+        EXPECT_NEAR(path.totalDelay, sum, 1e-6);
+        EXPECT_EQ(path.endpoint, path.edges.back()->to->name);
+        EXPECT_EQ(path.startpoint, path.edges.front()->from->name);
+    }
+    EXPECT_EQ(stages, stats.stages);
+}
+
+// Test that a skewed pool concentrates paths on a few high fan-out nodes
+TEST(ReportGeneratorTest, SkewRaisesNodeReuse) {
+    GeneratorOptions options;
+    options.pathCount = 600;
+    options.nodeCount = 20000;
+
+    TimingParser uniformParser;
+    parseReport(ReportGenerator(options).toString(), uniformParser);
+
+    options.fanoutSkew = 1.2;
+    TimingParser skewedParser;
+    parseReport(ReportGenerator(options).toString(), skewedParser);
+
+    EXPECT_LT(skewedParser.nodeCount() * 2, uniformParser.nodeCount());
+}
+
+// Test that corrupted lines are reported and skipped by the parser
+TEST(ReportGeneratorTest, InjectsMalformedLines) {
+    GeneratorOptions options;
+    options.pathCount = 400;
+    options.malformedRate = 0.05;
+
+    GeneratorStats stats;
+    std::string report = ReportGenerator(options).toString(&stats);
+    EXPECT_GT(stats.malformedLines, 0u);
+    EXPECT_LT(stats.validPaths, stats.paths);
+
+    TimingParser parser;
+    auto paths = parseReport(report, parser);
+    EXPECT_EQ(paths.size(), stats.validPaths);
+
+    uint64_t stages = 0;
+    for (const auto& path : paths) {
+        stages += path.edges.size();
+    }
+    EXPECT_EQ(stages, stats.stages);
+}
+
+// Test that inconsistent options are rejected
+TEST(ReportGeneratorTest, RejectsBadOptions) {
+    GeneratorOptions options;
+    options.minStages = 5;
+    options.maxStages = 4;
+    EXPECT_THROW(ReportGenerator{options}, std::invalid_argument);
+
+    options = GeneratorOptions();
+    options.malformedRate = 1.5;
+    EXPECT_THROW(ReportGenerator{options}, std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
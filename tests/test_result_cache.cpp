@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "analyzer.h"
+#include "content_hash.h"
+#include "parser.h"
+#include "result_cache.h"
+#include "thread_pool.h"
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// Helper function to create a temporary test file
+std::string createTempTimingReport(const std::string& tempFilePath, double p2Delay) {
+    std::ofstream tempFile(tempFilePath);
+
+    tempFile << "Timing Report for Design: test\n";
+    tempFile << "Clock Period: 10.000 ns\n";
+    tempFile << "Path P1     FF_Q        PI          2.345\n";
+    tempFile << "P1.1   NET1        PI          0.123\n";
+    tempFile << "P1.2   INV1        NET1        0.456\n";
+    tempFile << "\n";
+    tempFile << "Path P2     NAND1_Y     PI2         " << p2Delay << "\n";
+    tempFile << "P2.1   NET3        PI2         0.210\n";
+    tempFile << "Path P3     BUF1_Y      PI3         1.000\n";
+    tempFile << "P3.1   NET4        PI3         0.500\n";
+    tempFile << "End of Timing Report\n";
+
+    tempFile.close();
+    return tempFilePath;
+}
+
+class ResultCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        createTempTimingReport(reportPath, 3.210);
+    }
+
+    void TearDown() override {
+        std::remove(reportPath.c_str());
+        for (const auto& entry : entries) {
+            std::remove(entry.c_str());
+        }
+        std::remove(cacheDir.c_str());
+    }
+
+    // Scan a report through the cache the way a top-2 run does
+    std::vector<TimingPath> scanCached(ResultCache& cache, TimingParser& parser,
+                                       std::vector<PathExtent>& extents) {
+        parser.setTopKCutoff(2);
+        auto entry = cache.lookup(reportPath, pool);
+        entries.push_back(entry.path);
+        if (entry.hit) {
+            return parser.scanFile(entry.path, extents);
+        }
+        auto paths = parser.scanFile(reportPath, extents);
+        std::vector<uint32_t> positions(paths.size());
+        std::iota(positions.begin(), positions.end(), 0u);
+        cache.store(entry, reportPath, extents, analyzer.rankPaths(paths, positions, 2));
+        return paths;
+    }
+
+    const std::string reportPath = "temp_result_cache.rpt";
+    const std::string cacheDir = "temp_result_cache_dir";
+    std::vector<std::string> entries;
+    ThreadPool pool{2};
+    TimingAnalyzer analyzer;
+};
+
+// Test the hash against XXH64 reference values
+TEST(ContentHashTest, MatchesReferenceValues) {
+    EXPECT_EQ(ContentHash::xxh64("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(ContentHash::xxh64("abc", 3), 0x44BC2CF5AD770999ULL);
+    EXPECT_EQ(ContentHash::toHex(0xEF46DB3751D8E999ULL), "ef46db3751d8e999");
+}
+
+// Test that the file hash depends on content, not on the number of workers
+TEST_F(ResultCacheTest, FileHashIgnoresWorkerCount) {
+    ThreadPool single(1);
+    uint64_t small = ContentHash::hashFile(reportPath, single, 64);
+    EXPECT_EQ(ContentHash::hashFile(reportPath, pool, 64), small);
+    EXPECT_NE(ContentHash::hashFile(reportPath, pool), small);
+
+    createTempTimingReport(reportPath, 3.211);
+    EXPECT_NE(ContentHash::hashFile(reportPath, pool, 64), small);
+}
+
+// Test that a second run reads the cached top K instead of the report
+TEST_F(ResultCacheTest, ReusesTopKOfUnchangedReport) {
+    ResultCache cache(cacheDir, "topk=2");
+    TimingParser first;
+    std::vector<PathExtent> firstExtents;
+    EXPECT_EQ(scanCached(cache, first, firstExtents).size(), 2);
+    EXPECT_EQ(cache.misses(), 1);
+
+    TimingParser second;
+    std::vector<PathExtent> extents;
+    auto paths = scanCached(cache, second, extents);
+    EXPECT_EQ(cache.hits(), 1);
+    ASSERT_EQ(paths.size(), 2);
+    EXPECT_EQ(paths[0].id, "P1");
+    EXPECT_EQ(paths[1].id, "P2");
+
+    // Stages load from the entry
+    second.loadStages(paths, extents, {0, 1});
+    ASSERT_EQ(paths[0].edges.size(), 2);
+    EXPECT_EQ(paths[0].edges[1]->to->name, "INV1");
+    EXPECT_EQ(paths[1].edges.size(), 1);
+    EXPECT_EQ(cache.summary().rfind("Cache: 1 hit, 1 miss", 0), 0);
+}
+
+// Test that changed content or settings miss
+TEST_F(ResultCacheTest, MissesOnChangedReportOrSettings) {
+    {
+        ResultCache cache(cacheDir, "topk=2");
+        TimingParser parser;
+        std::vector<PathExtent> extents;
+        scanCached(cache, parser, extents);
+    }
+
+    ResultCache otherSettings(cacheDir, "topk=3");
+    EXPECT_FALSE(otherSettings.lookup(reportPath, pool).hit);
+
+    createTempTimingReport(reportPath, 0.5);
+    ResultCache cache(cacheDir, "topk=2");
+    TimingParser parser;
+    std::vector<PathExtent> extents;
+    auto paths = scanCached(cache, parser, extents);
+    EXPECT_EQ(cache.misses(), 1);
+    ASSERT_EQ(paths.size(), 3);
+    EXPECT_EQ(cache.summary(), "Cache: 0 hits, 1 miss");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
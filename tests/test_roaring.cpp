@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "bitmap_index.h"
+#include "roaring.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+// Helper to draw sorted unique IDs; density controls sparse vs. bitset containers
+std::vector<uint32_t> randomIds(std::mt19937& rng, uint32_t limit, double density) {
+    std::bernoulli_distribution keep(density);
+    std::vector<uint32_t> ids;
+    for (uint32_t id = 0; id < limit; ++id) {
+        if (keep(rng)) ids.push_back(id);
+    }
+    return ids;
+}
+
+// Test membership and round-tripping through sparse and dense containers
+TEST(RoaringBitmapTest, RoundTripsIds) {
+    std::mt19937 rng(7);
+    for (double density : {0.001, 0.05, 0.5}) {
+        auto ids = randomIds(rng, 300000, density);
+        auto bitmap = RoaringBitmap::fromSorted(ids);
+
+        EXPECT_EQ(bitmap.cardinality(), ids.size());
+        EXPECT_EQ(bitmap.toIds(), ids);
+        for (uint32_t probe : {0u, 1u, 65535u, 65536u, 131071u, 299999u}) {
+            EXPECT_EQ(bitmap.contains(probe), std::binary_search(ids.begin(), ids.end(), probe));
+        }
+    }
+}
+
+// Test set operations across every container pairing against std algorithms
+TEST(RoaringBitmapTest, MatchesReferenceSetOperations) {
+    std::mt19937 rng(11);
+    const double densities[] = {0.002, 0.3};
+    for (double da : densities) {
+        for (double db : densities) {
+            auto a = randomIds(rng, 200000, da);
+            auto b = randomIds(rng, 200000, db);
+            auto ra = RoaringBitmap::fromSorted(a);
+            auto rb = RoaringBitmap::fromSorted(b);
+
+            std::vector<uint32_t> expectAnd, expectOr, expectNot;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectAnd));
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectOr));
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectNot));
+
+            EXPECT_EQ((ra & rb).toIds(), expectAnd);
+            EXPECT_EQ((ra | rb).toIds(), expectOr);
+            EXPECT_EQ(andNot(ra, rb).toIds(), expectNot);
+        }
+    }
+}
+
+// Test that a full range covers exactly [0, count)
+TEST(RoaringBitmapTest, BuildsRange) {
+    auto full = RoaringBitmap::range(70000);
+    EXPECT_EQ(full.cardinality(), 70000u);
+    EXPECT_TRUE(full.contains(69999));
+    EXPECT_FALSE(full.contains(70000));
+    EXPECT_TRUE(RoaringBitmap::range(0).empty());
+}
+
+class BitmapIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (uint32_t id = 0; id < 4; ++id) {
+            nodes.push_back(std::make_shared<TimingNode>("N" + std::to_string(id), "cell"));
+            nodes.back()->id = id;
+        }
+
+        // Node 0 is on every path, node 1 on even paths, node 2 on every third
+        // path, node 3 only on path 5
+        for (uint32_t i = 0; i < 3000; ++i) {
+            TimingPath path;
+            path.edges.push_back(std::make_shared<TimingEdge>(nodes[0], nodes[0]));
+            if (i % 2 == 0) path.edges.push_back(std::make_shared<TimingEdge>(nodes[1], nodes[0]));
+            if (i % 3 == 0) path.edges.push_back(std::make_shared<TimingEdge>(nodes[2], nodes[0]));
+            if (i == 5) path.edges.push_back(std::make_shared<TimingEdge>(nodes[3], nodes[0]));
+            paths.push_back(path);
+        }
+        index = PathIndex::build(paths, nodes.size());
+    }
+
+    std::vector<std::shared_ptr<TimingNode>> nodes;
+    std::vector<TimingPath> paths;
+    PathIndex index;
+};
+
+// Test that only nodes above the threshold get bitmaps
+TEST_F(BitmapIndexTest, HonoursThreshold) {
+    ThreadPool pool(2);
+    auto bitmaps = BitmapIndex::build(index, 1200, pool);
+
+    EXPECT_NE(bitmaps.find(0), nullptr);
+    EXPECT_NE(bitmaps.find(1), nullptr);
+    EXPECT_EQ(bitmaps.find(2), nullptr);
+    EXPECT_EQ(bitmaps.find(3), nullptr);
+    EXPECT_EQ(bitmaps.bitmapCount(), 2u);
+    EXPECT_EQ(bitmaps.find(1)->cardinality(), 1500u);
+}
+
+// Test AND / ANDNOT selection mixing bitmap and posting-list nodes
+TEST_F(BitmapIndexTest, SelectsIntersections) {
+    ThreadPool pool(2);
+    auto bitmaps = BitmapIndex::build(index, 1200, pool);
+
+    auto both = bitmaps.select(index, {1, 2}, {}, 3000);
+    EXPECT_EQ(both.cardinality(), 500u);
+    EXPECT_TRUE(both.contains(6));
+    EXPECT_FALSE(both.contains(3));
+
+    auto evenNotThird = bitmaps.select(index, {0, 1}, {2}, 3000);
+    EXPECT_EQ(evenNotThird.cardinality(), 1000u);
+    EXPECT_FALSE(evenNotThird.contains(6));
+
+    auto avoidOnly = bitmaps.select(index, {}, {3}, 3000);
+    EXPECT_EQ(avoidOnly.cardinality(), 2999u);
+    EXPECT_FALSE(avoidOnly.contains(5));
+
+    EXPECT_TRUE(bitmaps.select(index, {1, kInvalidNodeId}, {}, 3000).empty());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
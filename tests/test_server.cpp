@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include "server.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Helper function to create a temporary test file
+std::string createTempTimingReport() {
+    const std::string tempFilePath = "temp_server_timing.rpt";
+    std::ofstream tempFile(tempFilePath);
+
+    tempFile << "Path P1     FF_Q        PI          2.345\n";
+    tempFile << "P1.1   NET1        PI          0.123\n";
+    tempFile << "P1.2   INV1        NET1        0.456\n";
+    tempFile << "\n";
+    tempFile << "Path P2     NAND1_Y     PI2         3.210\n";
+    tempFile << "P2.1   NET3        PI2         0.210\n";
+    tempFile << "P2.2   BUF1        NET3        0.450\n";
+    tempFile << "\n";
+    tempFile << "Path P3     FF_Q        PI3         4.100\n";
+    tempFile << "P3.1   NET5        PI3         0.700\n";
+    tempFile << "P3.2   INV1        NET5        0.900\n";
+
+    tempFile.close();
+    return tempFilePath;
+}
+
+// Count the result lines following the "OK <n>" status line
+size_t countResultLines(const std::string& response) {
+    return static_cast<size_t>(std::count(response.begin(), response.end(), '\n')) - 1;
+}
+
+class ServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempFilePath = createTempTimingReport();
+    }
+
+    void TearDown() override {
+        std::remove(tempFilePath.c_str());
+    }
+
+    std::string tempFilePath;
+};
+
+// Test that top-K requests come back ranked by delay
+TEST_F(ServerTest, AnswersTopK) {
+    TimingServer server(tempFilePath);
+    auto response = server.handleRequest("TOPK 2");
+
+    ASSERT_EQ(response.rfind("OK 2\n", 0), 0u);
+    EXPECT_EQ(countResultLines(response), 2u);
+    EXPECT_LT(response.find("P3:"), response.find("P2:"));
+    EXPECT_EQ(response.find("P1:"), std::string::npos);
+}
+
+// Test that node queries only return paths with a stage through the node
+TEST_F(ServerTest, AnswersPathsThrough) {
+    TimingServer server(tempFilePath);
+    auto response = server.handleRequest("THROUGH INV1");
+
+    ASSERT_EQ(response.rfind("OK 2\n", 0), 0u);
+    EXPECT_LT(response.find("P3:"), response.find("P1:"));
+    EXPECT_EQ(response.find("P2:"), std::string::npos);
+}
+
+// Test that multi-node queries intersect and exclude nodes
+TEST_F(ServerTest, AnswersMultiNodeThrough) {
+    TimingServer server(tempFilePath);
+
+    auto both = server.handleRequest("THROUGH INV1 NET5");
+    ASSERT_EQ(both.rfind("OK 1\n", 0), 0u);
+    EXPECT_NE(both.find("P3:"), std::string::npos);
+
+    auto excluded = server.handleRequest("THROUGH INV1 !NET5 5");
+    ASSERT_EQ(excluded.rfind("OK 1\n", 0), 0u);
+    EXPECT_NE(excluded.find("P1:"), std::string::npos);
+
+    // A last node that merely starts with a digit is a node, not K
+    EXPECT_EQ(server.handleRequest("THROUGH INV1 12_NET").rfind("OK 0\n", 0), 0u);
+    EXPECT_EQ(server.handleRequest("THROUGH 1234_X").rfind("OK 0\n", 0), 0u);
+}
+
+// Test that endpoint filters honour K
+TEST_F(ServerTest, AnswersEndpointFilter) {
+    TimingServer server(tempFilePath);
+    auto response = server.handleRequest("endpoint FF_Q 1");
+
+    ASSERT_EQ(response.rfind("OK 1\n", 0), 0u);
+    EXPECT_NE(response.find("P3:"), std::string::npos);
+}
+
+// Test that malformed requests produce errors instead of exceptions
+TEST_F(ServerTest, RejectsBadRequests) {
+    TimingServer server(tempFilePath);
+
+    EXPECT_EQ(server.handleRequest("FROB").rfind("ERR ", 0), 0u);
+    EXPECT_EQ(server.handleRequest("TOPK many").rfind("ERR ", 0), 0u);
+    EXPECT_EQ(server.handleRequest("THROUGH").rfind("ERR ", 0), 0u);
+
+    // K errors name the problem rather than the conversion that failed
+    EXPECT_EQ(server.handleRequest("TOPK -1").rfind("ERR K must be a non-negative integer", 0), 0u);
+    EXPECT_EQ(server.handleRequest("TOPK 99999999999").rfind("ERR K is too large", 0), 0u);
+    EXPECT_EQ(server.handleRequest("ENDPOINT FF_Q 2x").rfind("ERR K must be", 0), 0u);
+}
+
+// Test that reload picks up changes to the report
+TEST_F(ServerTest, ReloadsReport) {
+    TimingServer server(tempFilePath);
+
+    std::ofstream(tempFilePath, std::ios::app) << "\nPath P4     PO1         PI4         9.000\n";
+    auto response = server.handleRequest("RELOAD");
+    ASSERT_EQ(response.rfind("OK 1\n", 0), 0u);
+
+    EXPECT_NE(server.handleRequest("TOPK 1").find("P4:"), std::string::npos);
+}
+
+// Connect to a server that may still be starting; the socket is open even on failure
+bool connectWithRetry(int fd, const std::string& socketPath) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+// Test a request/response round trip over the Unix domain socket
+TEST_F(ServerTest, ServesOverSocket) {
+    const std::string socketPath = "temp_server_test.sock";
+    TimingServer server(tempFilePath);
+    std::thread serverThread([&] { server.serve(socketPath); });
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    bool connected = connectWithRetry(fd, socketPath);
+
+    std::string response;
+    if (connected) {
+        const std::string request = "PING\n";
+        ASSERT_EQ(::send(fd, request.data(), request.size(), 0),
+                  static_cast<ssize_t>(request.size()));
+        char buffer[256];
+        while (response.find("PONG\n") == std::string::npos) {
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) break;
+            response.append(buffer, static_cast<size_t>(n));
+        }
+    }
+    ::close(fd);
+
+    server.stop();
+    serverThread.join();
+
+    ASSERT_TRUE(connected);
+    EXPECT_EQ(response, "OK 1\nPONG\n");
+}
+
+// Test that a client sending an endless line is answered with an error and cut off
+TEST_F(ServerTest, ClosesOverlongRequestLines) {
+    const std::string socketPath = "temp_server_long.sock";
+    TimingServer server(tempFilePath);
+    std::thread serverThread([&] { server.serve(socketPath); });
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    bool connected = connectWithRetry(fd, socketPath);
+
+    std::string response;
+    if (connected) {
+        const std::string chunk(16 * 1024, 'x');
+        for (int i = 0; i < 8; ++i) {
+            if (::send(fd, chunk.data(), chunk.size(), MSG_NOSIGNAL) < 0) {
+                break;  // The server may already have closed the connection
+            }
+        }
+        char buffer[256];
+        ssize_t n;
+        while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            response.append(buffer, static_cast<size_t>(n));
+        }
+    }
+    ::close(fd);
+
+    server.stop();
+    serverThread.join();
+
+    ASSERT_TRUE(connected);
+    EXPECT_EQ(response.rfind("ERR request line longer than", 0), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,78 @@
+#!/usr/bin/env tclsh
+# Tests for the timing Tcl extension
+# Usage: tclsh test_tcl_extension.tcl <package dir> <sample_timing.rpt>
+
+lassign $argv packageDir sampleReport
+set argv {}
+lappend auto_path $packageDir
+
+package require tcltest
+namespace import ::tcltest::*
+package require timing
+
+set rpt [timing::load $sampleReport]
+
+# Test that the top K comes back worst first as dicts
+test topk-1 {top K is ranked by delay} -body {
+    lmap path [timing::topk $rpt 3] { dict get $path id }
+} -result {P7 P3 P5}
+
+test topk-2 {paths carry the analysis fields} -body {
+    set path [lindex [timing::topk $rpt 1] 0]
+    list [dict get $path startpoint] [dict get $path endpoint] [dict get $path delay] \
+        [expr {[dict get $path suggestion] ne ""}]
+} -result {FF6_Q FF7_Q 5.678 1}
+
+test topk-3 {K defaults to 10 and stops at the path count} -body {
+    llength [timing::topk $rpt]
+} -result 7
+
+# Test queries through a node
+test paths_through-1 {paths through a shared startpoint} -body {
+    lmap path [timing::paths_through $rpt FF3_Q] { dict get $path id }
+} -result {P5 P4}
+
+test paths_through-2 {an unknown node has no paths} -body {
+    timing::paths_through $rpt NO_SUCH_NODE
+} -result {}
+
+# Test single-path lookups and the summary
+test path-1 {a path lists its stages} -body {
+    set path [timing::path $rpt P3]
+    set first [lindex [dict get $path stages] 0]
+    list [llength [dict get $path stages]] [dict get $first from] [dict get $first to] \
+        [dict get $path worst_stage]
+} -result {7 FF1_Q NET5 NAND2}
+
+test summary-1 {summary counts the report} -body {
+    set summary [timing::summary $rpt]
+    list [dict get $summary paths] [dict get $summary worst_delay]
+} -result {7 5.678}
+
+# Test that options and errors behave like Tcl commands
+test load-1 {thresholds filter while loading} -body {
+    set filtered [timing::load -min-delay 5.0 $sampleReport]
+    set count [dict get [timing::summary $filtered] paths]
+    timing::free $filtered
+    set count
+} -result 3
+
+test errors-1 {unknown handles are errors} -body {
+    timing::topk timing999
+} -returnCodes error -result {unknown timing report "timing999"}
+
+test errors-2 {unreadable reports are errors} -body {
+    timing::load no_such_report.rpt
+} -returnCodes error -match glob -result {*no_such_report.rpt*}
+
+test errors-3 {freed handles are gone} -body {
+    set other [timing::load $sampleReport]
+    timing::free $other
+    timing::summary $other
+} -returnCodes error -match glob -result {unknown timing report*}
+
+timing::free $rpt
+
+set failed $::tcltest::numTests(Failed)
+cleanupTests
+exit [expr {$failed > 0}]
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "timing_c.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+class TimingCApiTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::ofstream file(tempFilePath);
+        file << "Timing Report for Design: test\n"
+             << "Clock Period: 10.000 ns\n"
+             << "\n"
+             << "Path P1     FF_Q        PI          2.345\n"
+             << "P1.1   NET1        PI          0.123\n"
+             << "P1.2   INV1        NET1        0.456\n"
+             << "\n"
+             << "Path P2     NAND1_Y     PI2         3.210\n"
+             << "P2.1   NET3        PI2         0.210\n"
+             << "P2.2   NAND1_Y     NET3        1.500\n"
+             << "\n"
+             << "Path P3     BUF1_Y      PI3         1.000\n"
+             << "P3.1   NET4        PI3         0.500\n"
+             << "End of Timing Report\n";
+        file.close();
+
+        char error[256];
+        ASSERT_EQ(timing_report_open(tempFilePath.c_str(), &report, error, sizeof(error)),
+                  TIMING_OK) << error;
+    }
+
+    void TearDown() override {
+        timing_report_free(report);
+        std::remove(tempFilePath.c_str());
+    }
+
+    const std::string tempFilePath = "temp_timing_c.rpt";
+    timing_report* report = nullptr;
+};
+
+// Test that the top K comes back worst first and stops at K
+TEST_F(TimingCApiTest, IteratesTopK) {
+    EXPECT_EQ(timing_api_version(), TIMING_C_API_VERSION);
+    EXPECT_EQ(timing_report_path_count(report), 3u);
+
+    timing_topk* topk = nullptr;
+    ASSERT_EQ(timing_topk_begin(report, 2, &topk), TIMING_OK);
+    timing_path_info info;
+    ASSERT_EQ(timing_topk_next(topk, &info), 1);
+    EXPECT_EQ(info.index, 1u);
+    EXPECT_DOUBLE_EQ(info.total_delay, 3.210);
+    EXPECT_DOUBLE_EQ(info.worst_stage_delay, 1.5);
+    EXPECT_EQ(info.stage_count, 2u);
+    ASSERT_EQ(timing_topk_next(topk, &info), 1);
+    EXPECT_EQ(info.index, 0u);
+    EXPECT_EQ(timing_topk_next(topk, &info), 0);
+    timing_topk_free(topk);
+}
+
+// Test lookups by ID and the string and stage accessors
+TEST_F(TimingCApiTest, QueriesOnePath) {
+    size_t index = 0;
+    ASSERT_EQ(timing_path_find(report, "P2", &index), TIMING_OK);
+    EXPECT_EQ(timing_path_find(report, "P9", &index), TIMING_ERROR_NOT_FOUND);
+
+    char text[64];
+    size_t length = 0;
+    EXPECT_EQ(timing_path_get_string(report, index, TIMING_FIELD_ENDPOINT, text, sizeof(text),
+                                     &length), TIMING_OK);
+    EXPECT_STREQ(text, "NAND1_Y");
+    EXPECT_EQ(length, 7u);
+    EXPECT_EQ(timing_path_get_string(report, index, TIMING_FIELD_WORST_STAGE, text,
+                                     sizeof(text), nullptr), TIMING_OK);
+    EXPECT_STREQ(text, "NET3");
+    char suggestion[256];
+    EXPECT_EQ(timing_path_get_string(report, index, TIMING_FIELD_SUGGESTION, suggestion,
+                                     sizeof(suggestion), &length), TIMING_OK);
+    EXPECT_EQ(std::strlen(suggestion), length);
+    EXPECT_GT(length, 0u);
+
+    double delay = 0.0;
+    char from[16], to[16];
+    ASSERT_EQ(timing_path_get_stage(report, index, 1, &delay, from, sizeof(from), to,
+                                    sizeof(to)), TIMING_OK);
+    EXPECT_DOUBLE_EQ(delay, 1.5);
+    EXPECT_STREQ(from, "NET3");
+    EXPECT_STREQ(to, "NAND1_Y");
+    EXPECT_EQ(timing_path_get_stage(report, index, 2, &delay, nullptr, 0, nullptr, 0),
+              TIMING_ERROR_INVALID_ARGUMENT);
+}
+
+// Test that a short buffer is truncated and reports the needed length
+TEST_F(TimingCApiTest, TruncatesIntoShortBuffers) {
+    char text[4];
+    size_t length = 0;
+    EXPECT_EQ(timing_path_get_string(report, 1, TIMING_FIELD_ENDPOINT, text, sizeof(text),
+                                     &length), TIMING_ERROR_BUFFER_TOO_SMALL);
+    EXPECT_STREQ(text, "NAN");
+    EXPECT_EQ(length, 7u);
+
+    // A NULL buffer only measures
+    EXPECT_EQ(timing_path_get_string(report, 1, TIMING_FIELD_ID, nullptr, 0, &length),
+              TIMING_ERROR_BUFFER_TOO_SMALL);
+    EXPECT_EQ(length, 2u);
+}
+
+// Test that bad arguments and unreadable reports return errors instead of throwing
+TEST(TimingCApiErrorTest, ReportsErrors) {
+    timing_report* report = reinterpret_cast<timing_report*>(1);
+    char error[128] = "";
+    EXPECT_EQ(timing_report_open("does_not_exist.rpt", &report, error, sizeof(error)),
+              TIMING_ERROR_IO);
+    EXPECT_EQ(report, nullptr);
+    EXPECT_NE(std::string(error).find("does_not_exist.rpt"), std::string::npos);
+
+    EXPECT_EQ(timing_report_open(nullptr, &report, nullptr, 0), TIMING_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(timing_report_path_count(nullptr), 0u);
+    timing_path_info info;
+    EXPECT_EQ(timing_path_get_info(nullptr, 0, &info), TIMING_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(timing_topk_next(nullptr, &info), 0);
+    EXPECT_STREQ(timing_status_string(TIMING_ERROR_NOT_FOUND), "path not found");
+    timing_report_free(nullptr);
+    timing_topk_free(nullptr);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
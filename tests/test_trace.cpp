@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "parser.h"
+#include "thread_pool.h"
+#include "trace.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+// Helper function to create a temporary test file
+std::string createTempTimingReport() {
+    const std::string tempFilePath = "temp_trace_timing.rpt";
+    std::ofstream tempFile(tempFilePath);
+
+    tempFile << "Path P1     FF_Q        PI          2.345\n";
+    tempFile << "P1.1   NET1        PI          0.123\n";
+    tempFile << "P1.2   INV1        NET1        0.456\n";
+
+    tempFile.close();
+    return tempFilePath;
+}
+
+size_t countOf(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos;
+         pos = text.find(needle, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempFilePath = createTempTimingReport();
+    }
+
+    void TearDown() override {
+        Trace::stop();
+        std::remove(tempFilePath.c_str());
+    }
+
+    std::string tempFilePath;
+};
+
+// Test that spans record nothing while tracing is off
+TEST_F(TraceTest, DisabledSpansRecordNothing) {
+    Trace::start();
+    Trace::stop();
+
+    TimingParser parser;
+    parser.parseFile(tempFilePath);
+
+    EXPECT_EQ(Trace::toJson().find("\"ph\":\"X\""), std::string::npos);
+}
+
+// Test that file and phase spans are written as complete events
+TEST_F(TraceTest, RecordsFileAndPhaseSpans) {
+    Trace::start();
+
+    TimingParser parser;
+    parser.parseFile(tempFilePath);
+
+    std::string json = Trace::toJson();
+    EXPECT_EQ(json.compare(0, 16, "{\"traceEvents\":["), 0);
+    EXPECT_NE(json.find("{\"name\":\"parse file\",\"cat\":\"file\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"detail\":\"temp_trace_timing.rpt\""), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"file read\",\"cat\":\"phase\""), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"parse\",\"cat\":\"phase\""), std::string::npos);
+    EXPECT_NE(json.find("\"droppedSpans\":0"), std::string::npos);
+}
+
+// Test that pool tasks and chunks are recorded on their worker threads
+TEST_F(TraceTest, RecordsPoolChunksPerThread) {
+    Trace::start();
+
+    std::atomic<size_t> items{0};
+    {
+        ThreadPool pool(2);
+        pool.parallelFor(10, [&items](size_t begin, size_t end) { items += end - begin; });
+    }
+    EXPECT_EQ(items, 10);
+
+    std::string json = Trace::toJson();
+    EXPECT_EQ(countOf(json, "\"name\":\"task\""), 2);
+    EXPECT_EQ(countOf(json, "\"name\":\"chunk\""), 2);
+    EXPECT_NE(json.find("\"first\":0,\"last\":5"), std::string::npos);
+    EXPECT_NE(json.find("\"first\":5,\"last\":10"), std::string::npos);
+    EXPECT_GE(countOf(json, "\"name\":\"thread_name\""), 1);
+}
+
+// Test that the thread which started tracing is the one named main, even
+// when another thread finishes a span first
+TEST_F(TraceTest, NamesStartingThreadMain) {
+    std::thread tracing([] {
+        Trace::start();
+        std::thread([] { Trace::Span span("early", "test"); }).join();
+        Trace::Span span("starter", "test");
+    });
+    tracing.join();
+
+    // The tid of an event follows its name; thread_name events carry a label
+    std::string json = Trace::toJson();
+    auto tidAfter = [&json](size_t pos) {
+        size_t start = json.find("\"tid\":", pos) + 6;
+        return json.substr(start, json.find_first_of(",}", start) - start);
+    };
+    size_t label = json.find("\"args\":{\"name\":\"main\"}");
+    ASSERT_NE(label, std::string::npos);
+    size_t labelStart = json.rfind("{\"name\":\"thread_name\"", label);
+    EXPECT_EQ(tidAfter(labelStart), tidAfter(json.find("\"name\":\"starter\"")));
+    EXPECT_NE(tidAfter(labelStart), tidAfter(json.find("\"name\":\"early\"")));
+}
+
+// Test that a full ring keeps the newest spans and reports the rest as dropped
+TEST_F(TraceTest, OverwritesOldestSpansWhenFull) {
+    Trace::start();
+
+    const size_t spans = (1 << 16) + 10;
+    for (size_t i = 0; i < spans; ++i) {
+        Trace::Span span("tick", "test");
+        if (i % 2 == 0) {
+            span.setDetail("tick " + std::to_string(i));
+        }
+    }
+
+    // Details are overwritten with their spans
+    std::string json = Trace::toJson();
+    EXPECT_EQ(countOf(json, "\"name\":\"tick\""), 1u << 16);
+    EXPECT_EQ(countOf(json, "\"detail\":"), 1u << 15);
+    EXPECT_EQ(json.find("\"detail\":\"tick 8\""), std::string::npos);
+    EXPECT_NE(json.find("\"detail\":\"tick 10\""), std::string::npos);
+    EXPECT_NE(json.find("\"droppedSpans\":10"), std::string::npos);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,127 @@
+/**
+ * @file gen_timing_report.cpp
+ * @brief Writes synthetic timing reports for scale and stress testing
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "report_generator.h"
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -o, --output PATH        Report file to write (default: stdout)\n"
+              << "  -n, --paths N            Number of paths (default: 1000)\n"
+              << "  --min-stages N           Fewest stages per path (default: 2)\n"
+              << "  --max-stages N           Most stages per path (default: 12)\n"
+              << "  --stage-dist DIST        uniform or geometric (default: uniform)\n"
+              << "  --mean-stages X          Mean stage count for geometric (default: 6)\n"
+              << "  --nodes N                Distinct net and cell names (default: 100000)\n"
+              << "  --fanout-skew S          Zipf exponent of node reuse; 0 is uniform,\n"
+              << "                           ~1 gives a few very high fan-out nodes (default: 0)\n"
+              << "  --delay-dist DIST        uniform, exponential or lognormal (default: uniform)\n"
+              << "  --min-delay X            Smallest stage delay in ns (default: 0.010)\n"
+              << "  --max-delay X            Largest stage delay in ns (default: 1.500)\n"
+              << "  --mean-delay X           Mean stage delay for exponential and lognormal\n"
+              << "                           (default: 0.400)\n"
+              << "  --delay-sigma X          Shape of lognormal delays (default: 0.5)\n"
+              << "  --malformed-rate X       Fraction of lines to corrupt (default: 0)\n"
+              << "  --clock-period X         Clock period in ns for the preamble (default: 10)\n"
+              << "  --seed N                 Random seed; equal seeds give equal reports\n"
+              << "                           (default: 1)\n"
+              << "  -h, --help               Show this help message\n";
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    std::string outputFile;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "-h" || arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else if ((arg == "-o" || arg == "--output") && hasValue) {
+                outputFile = argv[++i];
+            } else if ((arg == "-n" || arg == "--paths") && hasValue) {
+                options.pathCount = std::stoull(argv[++i]);
+            } else if (arg == "--min-stages" && hasValue) {
+                options.minStages = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--max-stages" && hasValue) {
+                options.maxStages = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--stage-dist" && hasValue) {
+                std::string dist = argv[++i];
+                if (dist == "uniform") {
+                    options.stageDistribution = GeneratorOptions::StageDistribution::Uniform;
+                } else if (dist == "geometric") {
+                    options.stageDistribution = GeneratorOptions::StageDistribution::Geometric;
+                } else {
+                    throw std::invalid_argument("unknown stage distribution: " + dist);
+                }
+            } else if (arg == "--mean-stages" && hasValue) {
+                options.meanStages = std::stod(argv[++i]);
+            } else if (arg == "--nodes" && hasValue) {
+                options.nodeCount = std::stoull(argv[++i]);
+            } else if (arg == "--fanout-skew" && hasValue) {
+                options.fanoutSkew = std::stod(argv[++i]);
+            } else if (arg == "--delay-dist" && hasValue) {
+                std::string dist = argv[++i];
+                if (dist == "uniform") {
+                    options.delayDistribution = GeneratorOptions::DelayDistribution::Uniform;
+                } else if (dist == "exponential") {
+                    options.delayDistribution = GeneratorOptions::DelayDistribution::Exponential;
+                } else if (dist == "lognormal") {
+                    options.delayDistribution = GeneratorOptions::DelayDistribution::LogNormal;
+                } else {
+                    throw std::invalid_argument("unknown delay distribution: " + dist);
+                }
+            } else if (arg == "--min-delay" && hasValue) {
+                options.minDelay = std::stod(argv[++i]);
+            } else if (arg == "--max-delay" && hasValue) {
+                options.maxDelay = std::stod(argv[++i]);
+            } else if (arg == "--mean-delay" && hasValue) {
+                options.meanDelay = std::stod(argv[++i]);
+            } else if (arg == "--delay-sigma" && hasValue) {
+                options.delaySigma = std::stod(argv[++i]);
+            } else if (arg == "--malformed-rate" && hasValue) {
+                options.malformedRate = std::stod(argv[++i]);
+            } else if (arg == "--clock-period" && hasValue) {
+                options.clockPeriod = std::stod(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                options.seed = std::stoull(argv[++i]);
+            } else {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+
+        ReportGenerator generator(options);
+        auto start = std::chrono::steady_clock::now();
+        GeneratorStats stats = outputFile.empty() ? generator.write(stdout)
+                                                  : generator.writeFile(outputFile);
+        double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+        // Summary goes to stderr so stdout can carry the report itself
+        std::fprintf(stderr,
+                     "Wrote %llu paths (%llu valid), %llu stages, %llu malformed lines, "
+                     "%.1f MB in %.2f s (%.0f MB/s)\n",
+                     static_cast<unsigned long long>(stats.paths),
+                     static_cast<unsigned long long>(stats.validPaths),
+                     static_cast<unsigned long long>(stats.stages),
+                     static_cast<unsigned long long>(stats.malformedLines),
+                     static_cast<double>(stats.bytes) / 1e6, seconds,
+                     seconds > 0 ? static_cast<double>(stats.bytes) / 1e6 / seconds : 0.0);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}